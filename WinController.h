@@ -12,6 +12,8 @@
 	#include "winmouse.h"
 	#include "winmenu.h"
 	#include "winmessagepump.h"
+	#include "wincommandrouter.h"
+	#include "winctrlarena.h"
 	#include <map>
 	//#include "winctrleventhandlers.h"
 
@@ -45,6 +47,21 @@
 			virtual ~BaseController () 
 			{}
 
+			//-------------------------------------------------------------
+			// The controllers are allocated from the Win::ControllerArena
+			// of the thread when it has one, else from the heap.
+			//-------------------------------------------------------------
+
+			static void * operator new (size_t size)
+			{
+				return Win::ControllerArena::Allocate (size) ;
+			}
+
+			static void operator delete (void * p)
+			{
+				Win::ControllerArena::Free (p) ;
+			}
+
 			void RegisterControl (Win::dow::Handle ctrl, ControlEventHandler * handler)
 			{
 				_ctrlMap[ctrl] = handler;
@@ -70,6 +87,19 @@
 				_pump = &pump ;
 			}
 
+			//-------------------------------------------------------------
+			// Obtains the command router of the controller.  The default
+			// OnCommand, OnControl and OnNotify methods route the messages
+			// to the handlers registered in it.
+			//
+			// Return value:  The command router.
+			//-------------------------------------------------------------
+
+			Win::CommandRouter & GetRouter ()
+			{
+				return _router ;
+			}
+
 			//-------------------------------------------------------------------
 			// The following methods represents various window messages.  The
 			// return value for each of them has the same meaning unless
@@ -859,7 +889,7 @@
 			//-------------------------------------------------------------------------
 
 			virtual bool OnCommand (const int id, const bool isAccelerator) throw ()
-			{return false;}
+			{return _router.RouteCommand (id, isAccelerator) ;}
 
 			//-------------------------------------------------------------------------
 			// Represents the WM_SYSCOMMAND message.
@@ -889,7 +919,7 @@
 			virtual bool OnControl (Win::dow::Handle & control, const int id, const int notificationCode) throw ();
 
 			virtual bool OnNotify (const int idCtrl, LPARAM lParam)
-			{return false ;}
+			{return _router.RouteNotify (reinterpret_cast <NMHDR *> (lParam)) ;}
 
 			virtual bool OnScrollBarColor(Win::dow::Handle _scrollHandle, Win::ControlColor & ctrColor) throw ()
 			{return false ;}
@@ -934,6 +964,7 @@
 
 		protected:
 			Win::MessagePump * _pump ;      //Pointer on the "message loop".
+			Win::CommandRouter _router ;    // Handlers of WM_COMMAND and WM_NOTIFY.
 			std::map <HWND, ControlEventHandler *> _ctrlMap; // A map containing all the child controls so user feedback (example button click) can be handled
 		} ;
 
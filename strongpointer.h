@@ -3,6 +3,104 @@
 #define STRONGPOINTER_H
 #include "useunicode.h"
 #include <cassert>
+#include <cstring>
+
+//------------------------------------------------------------------------
+// IsBitwiseCopyable tells if the objects of a type can be copied with
+// memcpy instead of their assignment operator.  True for the built-in
+// types and the pointers.  Specialize it for the structures that can be
+// copied this way (no pointer on themselves, no user defined
+// assignment).
+//------------------------------------------------------------------------
+
+template <class T>
+struct IsBitwiseCopyable
+{
+	enum { Value = false } ;
+} ;
+
+template <class T>
+struct IsBitwiseCopyable <T *>
+{
+	enum { Value = true } ;
+} ;
+
+#define STRONGPOINTER_BITWISE(type) \
+	template <> struct IsBitwiseCopyable <type> { enum { Value = true } ; } ;
+
+STRONGPOINTER_BITWISE (bool)
+STRONGPOINTER_BITWISE (char)
+STRONGPOINTER_BITWISE (signed char)
+STRONGPOINTER_BITWISE (unsigned char)
+STRONGPOINTER_BITWISE (wchar_t)
+STRONGPOINTER_BITWISE (short)
+STRONGPOINTER_BITWISE (unsigned short)
+STRONGPOINTER_BITWISE (int)
+STRONGPOINTER_BITWISE (unsigned int)
+STRONGPOINTER_BITWISE (long)
+STRONGPOINTER_BITWISE (unsigned long)
+STRONGPOINTER_BITWISE (float)
+STRONGPOINTER_BITWISE (double)
+
+#undef STRONGPOINTER_BITWISE
+
+//------------------------------------------------------------------------
+// Copies the elements of an array.  The specialization for the types
+// that can be copied bitwise uses memcpy.
+//------------------------------------------------------------------------
+
+template <bool Bitwise>
+struct ArrayCopier
+{
+	template <class T>
+	static void Copy (T * dest, const T * src, const unsigned int count)
+	{
+		for (unsigned int i = 0 ; i < count ; ++i)
+			dest [i] = src [i] ;
+	}
+} ;
+
+template <>
+struct ArrayCopier <true>
+{
+	template <class T>
+	static void Copy (T * dest, const T * src, const unsigned int count)
+	{
+		if (count != 0)
+			std::memcpy (dest, src, count * sizeof (T)) ;
+	}
+} ;
+
+//------------------------------------------------------------------------
+// The inline elements of a StrongArrayPointer.  The specialization for
+// no inline element is empty so it takes no room as a base class.
+//------------------------------------------------------------------------
+
+template <class T, unsigned int Size>
+class StrongArrayStorage
+{
+protected:
+
+	T * GetInline ()
+	{
+		return _inline ;
+	}
+
+private:
+
+	T _inline [Size] ;
+} ;
+
+template <class T>
+class StrongArrayStorage <T, 0>
+{
+protected:
+
+	T * GetInline ()
+	{
+		return NULL ;
+	}
+} ;
 
 //------------------------------------------------------------------------
 // StrongArrayPointer acts like an array.  It is use for the concept of
@@ -11,10 +109,15 @@
 // scope, the dynamic data is deleted.  The dynamic data can only be owned
 // by one strong pointer, so StrongPointer use transfer semantics instead
 // of copy semantics.
+//
+// The array keeps a capacity larger than its size when it grows, so
+// growing it one cell at a time does not reallocate it each time.  If
+// InlineSize is not 0, arrays of up to InlineSize elements are stored
+// inside the object and are not allocated at all.
 //------------------------------------------------------------------------
 
-template <class T>
-class StrongArrayPointer
+template <class T, unsigned int InlineSize = 0>
+class StrongArrayPointer : private StrongArrayStorage <T, InlineSize>
 {
 public:
 
@@ -23,8 +126,9 @@ public:
 	//------------------------------------------------------------------------
 
 	StrongArrayPointer ()
-		: _ptr  (NULL),
-		  _size (0)
+		: _ptr      (this->GetInline ()),
+		  _size     (0),
+		  _capacity (InlineSize)
 	{}
 
 	//------------------------------------------------------------------------
@@ -36,11 +140,35 @@ public:
 	//------------------------------------------------------------------------
 
 	StrongArrayPointer (const unsigned int size)
-		: _size (size)
+		: _ptr      (this->GetInline ()),
+		  _size     (size),
+		  _capacity (InlineSize)
 	{
 		assert (size != 0) ;
-		_ptr = new T [size] ;
-		_size = size ;
+
+		if (size > InlineSize)
+		{
+			_ptr      = new T [size] ;
+			_capacity = size ;
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// Transfer constructor.  The StrongArrayPointer passed as a parameter
+	// gives up its array and becomes empty.  Elements stored inside the
+	// object are copied, a dynamic array only changes owner.
+	//
+	// Parameters:
+	//
+	// StrongArrayPointer & rhs -> The StrongArrayPointer giving up ownership
+	//------------------------------------------------------------------------
+
+	StrongArrayPointer (StrongArrayPointer & rhs)
+		: _ptr      (this->GetInline ()),
+		  _size     (0),
+		  _capacity (InlineSize)
+	{
+		Take (rhs) ;
 	}
 
 	//------------------------------------------------------------------------
@@ -53,7 +181,8 @@ public:
 	}
 
 	//------------------------------------------------------------------------
-	// Destroys the current array and create a new one of the specified size
+	// Destroys the current array and create a new one of the specified size.
+	// The memory of the current array is reused if it is large enough.
 	//
 	// parameter:
 	//
@@ -62,14 +191,26 @@ public:
 
 	void ReAllocate (const unsigned int size)
 	{
-		Free () ;
-		_ptr = new T [size] ;
+		if (size <= _capacity)
+		{
+			for (unsigned int i = 0 ; i < size ; ++i)
+				_ptr [i] = T () ;
+		}
+		else
+		{
+			T * ptr = new T [size] ;
+			Free () ;
+			_ptr      = ptr ;
+			_capacity = size ;
+		}
+
 		_size = size ;
 	}
 
 	//------------------------------------------------------------------------
 	// Changes the size of the array while keeping the old data (unless shrunken, then
-	// can lose data).
+	// can lose data).  The array is reallocated only if the new size is
+	// larger than its capacity, and the data is copied only once.
 	//
 	// parameter:
 	//
@@ -79,42 +220,42 @@ public:
 	void Resize (const unsigned int size)
 	{
 		assert (size != 0) ;
+		SetSize (size, size) ;
+	}
 
-		T * tmp = new T [_size] ;
-
-		unsigned int i = 0 ;
-		
-		// preserve the data
-		for (; i < _size ; i++)
-			tmp [i] = _ptr [i] ;
-
-		Free () ;
-
-		_ptr = new T [size] ;
-
-		// restore the data 
-		for (i = 0 ; i < _size ; i++)
-			_ptr [i] = tmp [i] ;
-
-		_size = size ;
+	//------------------------------------------------------------------------
+	// Adds a certain number of cell to the array, the data is not lost.  When
+	// the array must be reallocated, its capacity is at least doubled so a
+	// series of calls takes an amortized constant time per cell.
+	//
+	// parameter:
+	//
+	// const unsigned int nb -> The number of cells to be added.
+	//------------------------------------------------------------------------
 
-		delete [] tmp ;
+	void Grow (const unsigned int nb)
+	{
+		assert (nb != 0) ;
 
+		unsigned int size     = _size + nb ;
+		unsigned int capacity = _capacity * 2 ;
 
+		SetSize (size, capacity > size ? capacity : size) ;
 	}
 
 	//------------------------------------------------------------------------
-	// Adds a certain number of cell to the array, the data is not lost.
+	// Makes sure the array can hold a certain number of cells without
+	// being reallocated.  The size of the array does not change.
 	//
 	// parameter:
 	//
-	// const unsigned int nb -> The number of cells to be added.
+	// const unsigned int capacity -> The number of cells.
 	//------------------------------------------------------------------------
 
-	void Grow (const unsigned int nb)
+	void Reserve (const unsigned int capacity)
 	{
-		assert (nb != 0) ;
-		Resize (_size + nb) ;
+		if (capacity > _capacity)
+			MoveToNewArray (capacity) ;
 	}
 
 	//------------------------------------------------------------------------
@@ -128,6 +269,18 @@ public:
 		return _size ;
 	}
 
+	//------------------------------------------------------------------------
+	// Obtains the number of cells the array can hold without being
+	// reallocated.
+	//
+	// return value:  The capacity of the array.
+	//------------------------------------------------------------------------
+
+	unsigned int GetCapacity () const
+	{
+		return _capacity ;
+	}
+
 	//------------------------------------------------------------------------
 	// Obtains a Weak (normal pointer on the array.
 	//
@@ -142,18 +295,63 @@ public:
 	//------------------------------------------------------------------------
 	// The StrongArrayPointer give up ownership of the dynamic data without deleting
 	// it.  The data is not deleted, instead a weak (normal) pointer pointing
-	// to it is returned
+	// to it is returned.  If the data is stored inside the object, it is
+	// first copied in a dynamic array the caller must delete.
 	//
 	// Return value:  A weak pointer on the dynamic data.
 	//------------------------------------------------------------------------
 
-	T* Release () throw ()
+	T* Release ()
 	{
+		if (IsInline ())
+		{
+			if (_size == 0)
+				return NULL ;
+
+			MoveToNewArray (_size) ;
+		}
+
 		T * tmp = _ptr;
-		_ptr = NULL ;
+		_ptr      = this->GetInline () ;
+		_size     = 0 ;
+		_capacity = InlineSize ;
 		return tmp ;
 	}
 
+	//------------------------------------------------------------------------
+	// Exchanges the arrays of two StrongArrayPointer.  Unless the data is
+	// stored inside the objects, only the pointers are exchanged.
+	//
+	// parameters:
+	//
+	// StrongArrayPointer & rhs -> The other StrongArrayPointer.
+	//------------------------------------------------------------------------
+
+	void Swap (StrongArrayPointer & rhs)
+	{
+		if (!IsInline () && !rhs.IsInline ())
+		{
+			T *          ptr      = _ptr ;
+			unsigned int size     = _size ;
+			unsigned int capacity = _capacity ;
+
+			_ptr      = rhs._ptr ;
+			_size     = rhs._size ;
+			_capacity = rhs._capacity ;
+
+			rhs._ptr      = ptr ;
+			rhs._size     = size ;
+			rhs._capacity = capacity ;
+		}
+		else
+		{
+			StrongArrayPointer tmp ;
+			tmp.Take (*this) ;
+			Take (rhs) ;
+			rhs.Take (tmp) ;
+		}
+	}
+
 	//------------------------------------------------------------------------
 	// Tranfers ownership of dynamic data from one StrongArrayPointer to another.
 	//
@@ -162,18 +360,16 @@ public:
 	//
 	// parameters:
 	//
-	// StrongArrayPointer<T> & rhs -> The StrongPointer giving up ownership of its
-	//							       array.
+	// StrongArrayPointer & rhs -> The StrongPointer giving up ownership of its
+	//							   array.
 	//------------------------------------------------------------------------
 
-	StrongArrayPointer<T>& operator= (StrongArrayPointer<T> & rhs) throw()
+	StrongArrayPointer & operator= (StrongArrayPointer & rhs)
 	{
-		if (rhs._ptr != _ptr)
+		if (&rhs != this)
 		{
 			Free () ;
-			_ptr  = rhs.Release () ;
-			_size = rhs._size ; 
-			rhs._size = 0 ;
+			Take (rhs) ;
 		}
 
 		return *this ;
@@ -213,21 +409,101 @@ public:
 
 private:
 
-	void Free ()
+	bool IsInline () const
 	{
-		if (_ptr)
+		return InlineSize != 0 && _ptr == const_cast <StrongArrayPointer *> (this)->GetInline () ;
+	}
+
+	//------------------------------------------------------------------------
+	// Changes the size of the array, reallocating it with the specified
+	// capacity if it is too small.  The cells added are reset.
+	//------------------------------------------------------------------------
+
+	void SetSize (const unsigned int size, const unsigned int capacity)
+	{
+		if (size > _capacity)
+			MoveToNewArray (capacity) ;
+		else
 		{
-			delete [] _ptr ;
-			_ptr = NULL ;
+			for (unsigned int i = _size ; i < size ; ++i)
+				_ptr [i] = T () ;
+		}
+
+		_size = size ;
+	}
+
+	//------------------------------------------------------------------------
+	// Moves the data in a new dynamic array of the given capacity.  The
+	// contents are kept, unlike ReAllocate.
+	//------------------------------------------------------------------------
+
+	void MoveToNewArray (const unsigned int capacity)
+	{
+		unsigned int size = _size ;
+		T *          ptr  = new T [capacity] ;
+
+		ArrayCopier <IsBitwiseCopyable <T>::Value != 0>::Copy (ptr, _ptr, size) ;
+		Free () ;
+
+		_ptr      = ptr ;
+		_size     = size ;
+		_capacity = capacity ;
+	}
+
+	//------------------------------------------------------------------------
+	// Takes the data of another StrongArrayPointer, which becomes empty.
+	// The current data must have been freed.
+	//------------------------------------------------------------------------
+
+	void Take (StrongArrayPointer & rhs)
+	{
+		if (rhs.IsInline ())
+		{
+			_ptr      = this->GetInline () ;
+			_capacity = InlineSize ;
+			ArrayCopier <IsBitwiseCopyable <T>::Value != 0>::Copy (_ptr, rhs._ptr, rhs._size) ;
+		}
+		else
+		{
+			_ptr      = rhs._ptr ;
+			_capacity = rhs._capacity ;
 		}
+
+		_size = rhs._size ;
+
+		rhs._ptr      = rhs.GetInline () ;
+		rhs._size     = 0 ;
+		rhs._capacity = InlineSize ;
+	}
+
+	void Free ()
+	{
+		if (_ptr && !IsInline ())
+			delete [] _ptr ;
+
+		_ptr      = this->GetInline () ;
+		_size     = 0 ;
+		_capacity = InlineSize ;
 	}
 
 private:
 
-	T *          _ptr ; // Points on a dynamic array
-	unsigned int _size ; // Size of the array.
+	T *          _ptr ;      // Points on a dynamic array or on the inline elements.
+	unsigned int _size ;     // Size of the array.
+	unsigned int _capacity ; // Number of cells allocated.
 } ;
 
+//------------------------------------------------------------------------
+// Exchanges the arrays of two StrongArrayPointer.  Found by argument
+// dependent lookup.
+//------------------------------------------------------------------------
+
+template <class T, unsigned int InlineSize>
+inline void swap (StrongArrayPointer <T, InlineSize> & lhs, StrongArrayPointer <T, InlineSize> & rhs)
+{
+	lhs.Swap (rhs) ;
+}
+
 //------------------------------------------------------------------------
 // StrongPointer acts like a pointer.  It is use for the concept of
 // resource management.  Basicly, a StrongPointer own the dynamic data
@@ -335,6 +611,21 @@ public:
 		return *this ;
 	}
 
+	//------------------------------------------------------------------------
+	// Exchanges the dynamic data of two StrongPointer.
+	//
+	// parameters:
+	//
+	// StrongPointer<T> & rhs -> The other StrongPointer.
+	//------------------------------------------------------------------------
+
+	void Swap (StrongPointer<T> & rhs) throw ()
+	{
+		T * tmp  = _ptr ;
+		_ptr     = rhs._ptr ;
+		rhs._ptr = tmp ;
+	}
+
 	//------------------------------------------------------------------------
 	// Same use as the * operator for normal pointers.
 	//------------------------------------------------------------------------
@@ -369,4 +660,15 @@ private:
 	T * _ptr ;
 } ;
 
+//------------------------------------------------------------------------
+// Exchanges the dynamic data of two StrongPointer.  Found by argument
+// dependent lookup.
+//------------------------------------------------------------------------
+
+template <class T>
+inline void swap (StrongPointer <T> & lhs, StrongPointer <T> & rhs) throw ()
+{
+	lhs.Swap (rhs) ;
+}
+
 #endif
\ No newline at end of file
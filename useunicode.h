@@ -9,6 +9,12 @@
 	#define _UNICODE
 #endif
 
+//------------------------------------
+// Set to 1 to count the handles owned by the strong handles and find
+// leaks (see winhandletracker.h).
+//------------------------------------
+#define ___TRACKHANDLES___ 0
+
 //----------------------------------------------------------
 // When the compiler see something like this
 // #pragma chMSG (fix this later) it outputs a line like this:
@@ -533,6 +533,21 @@
 					throw Win::Exception (TEXT("Error, could not get the update rectangle")) ;
 			}
 
+			//-------------------------------------------------------------------------
+			// Allows or prevents the window represented by the Win::dow::Handle::Handle
+			// object from being redrawn.  Useful when many changes are made to a
+			// control, like filling a list box.
+			//
+			// Parameters:
+			//
+			// const bool redraw -> True to allow redrawing, false to prevent it.
+			//-------------------------------------------------------------------------
+
+			void SetRedraw (const bool redraw) const
+			{
+				SendMessage (WM_SETREDRAW, redraw ? TRUE : FALSE, 0) ;
+			}
+
 			//----------------------------------------------------------------
 			// Determine whether the window represented by the Win::dow::Handle::Handle object
 			// is native Unicode.
@@ -621,11 +636,54 @@
 					return ::GetParent (_h) ; 
 				}
 
-				Win::dow::Handle GetChild (const int id) 
+				Win::dow::Handle GetChild (const int id)
 				{
 					return ::GetDlgItem (_h, id) ;
 				}
 			} ;
+
+			//-------------------------------------------------------------------------
+			// Win::dow::NoRedraw prevents a window from being redrawn for as long as
+			// the object exists.  When the object goes out of scope, redrawing is
+			// allowed again and the whole window is invalidated so it is repainted
+			// only once.
+			//-------------------------------------------------------------------------
+
+			class NoRedraw
+			{
+			public:
+
+				//-------------------------------------------------------------------------
+				// Constructor.  Prevents the window from being redrawn.
+				//
+				// Parameters:
+				//
+				// const Win::Base win -> The window that must not be redrawn.
+				//-------------------------------------------------------------------------
+
+				NoRedraw (const Win::Base win)
+					: _win (win)
+				{
+					_win.SetRedraw (false) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Destructor.  Allows the window to be redrawn and invalidates it.
+				//-------------------------------------------------------------------------
+
+				~NoRedraw ()
+				{
+					_win.SetRedraw (true) ;
+					::InvalidateRect (_win, NULL, TRUE) ;
+				}
+
+			private:
+
+				NoRedraw (const NoRedraw &) ;
+				NoRedraw & operator = (const NoRedraw &) ;
+
+				Win::Base _win ; // The window whose redrawing is suspended.
+			} ;
 		}
 
 		namespace Frame
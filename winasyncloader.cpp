@@ -0,0 +1,543 @@
+#include "winasyncloader.h"
+#include "wincanvas.h"
+#include "winicon.h"
+#include <algorithm>
+#include <process.h>
+
+//-----------------------------------------------------------------
+// Creates a DIB section containing a copy of the image.
+//
+// Return value:  A strong handle on the DIB section.
+//-----------------------------------------------------------------
+
+Win::Bitmap::DIBSection::StrongHandle Win::DecodedImage::CreateDIBSection () const
+{
+	if (_pixels.empty ())
+		throw Win::Exception (TEXT("Error, cannot create a DIB section from an empty image")) ;
+
+	BITMAPINFO info ;
+	::ZeroMemory (&info, sizeof (info)) ;
+
+	info.bmiHeader.biSize        = sizeof (BITMAPINFOHEADER) ;
+	info.bmiHeader.biWidth       = _width ;
+	info.bmiHeader.biHeight      = -_height ; // Top-down.
+	info.bmiHeader.biPlanes      = 1 ;
+	info.bmiHeader.biBitCount    = 32 ;
+	info.bmiHeader.biCompression = BI_RGB ;
+
+	void *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, &info, DIB_RGB_COLORS, &bits, NULL, 0) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not create a DIB section")) ;
+
+	::CopyMemory (bits, &_pixels [0], GetSize ()) ;
+	return Win::Bitmap::DIBSection::StrongHandle (h, static_cast <BYTE *> (bits)) ;
+}
+
+//-----------------------------------------------------------------
+// Finds an image and marks it as the most recently used.
+//
+// Return value:  A pointer on the image, valid until the cache is 
+//				  changed, or NULL if the image is not in the cache.
+//
+// Parameters:
+//
+// const std::tstring & key -> The key of the image.
+//-----------------------------------------------------------------
+
+const Win::DecodedImage * Win::ImageCache::Find (const std::tstring & key)
+{
+	std::map <std::tstring, ImageList::iterator>::iterator it = _index.find (key) ;
+
+	if (it == _index.end ())
+		return NULL ;
+
+	_images.splice (_images.begin (), _images, it->second) ;
+	return &it->second->second ;
+}
+
+//-----------------------------------------------------------------
+// Adds an image as the most recently used one, replacing an image
+// with the same key.  Least recently used images are removed if the
+// budget is exceeded.
+//
+// Parameters:
+//
+// const std::tstring & key  -> The key of the image.
+// Win::DecodedImage & image -> The image.  Its pixels are moved in
+//								the cache, it is empty on return.
+//-----------------------------------------------------------------
+
+void Win::ImageCache::Insert (const std::tstring & key, Win::DecodedImage & image)
+{
+	std::map <std::tstring, ImageList::iterator>::iterator it = _index.find (key) ;
+
+	if (it != _index.end ())
+	{
+		_bytes -= it->second->second.GetSize () ;
+		_images.erase (it->second) ;
+		_index.erase (it) ;
+	}
+
+	// An image bigger than the whole budget is not kept.
+	if (image.GetSize () > _maxBytes)
+		return ;
+
+	_images.push_front (std::make_pair (key, Win::DecodedImage ())) ;
+	_images.front ().second.Swap (image) ;
+	_index [key] = _images.begin () ;
+	_bytes += _images.front ().second.GetSize () ;
+
+	Trim () ;
+}
+
+//-----------------------------------------------------------------
+// Changes the budget, removing images if needed.
+//
+// Parameters:
+//
+// const DWORD maxBytes -> The maximum memory used by the images.
+//-----------------------------------------------------------------
+
+void Win::ImageCache::SetMaxBytes (const DWORD maxBytes)
+{
+	_maxBytes = maxBytes ;
+	Trim () ;
+}
+
+//-----------------------------------------------------------------
+// Removes all the images.
+//-----------------------------------------------------------------
+
+void Win::ImageCache::Clear ()
+{
+	_images.clear () ;
+	_index.clear () ;
+	_bytes = 0 ;
+}
+
+//-----------------------------------------------------------------
+// Removes the least recently used images until the budget is
+// respected.
+//-----------------------------------------------------------------
+
+void Win::ImageCache::Trim ()
+{
+	while (_bytes > _maxBytes && !_images.empty ())
+	{
+		_bytes -= _images.back ().second.GetSize () ;
+		_index.erase (_images.back ().first) ;
+		_images.pop_back () ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Starts the threads.
+//
+// Parameters:
+//
+// const HWND notify      -> Window receiving a message when an image
+//							 is loaded.
+// const UINT message     -> The message, usually WM_APP + something.
+// const int threadCount  -> Number of loading threads.
+// const DWORD cacheBytes -> Memory used by the cache of decoded images.
+//-----------------------------------------------------------------
+
+Win::AsyncImageLoader::AsyncImageLoader (const HWND notify, const UINT message, const int threadCount, const DWORD cacheBytes)
+	: _cache   (cacheBytes),
+	  _next    (1),
+	  _stop    (false),
+	  _wake    (NULL),
+	  _notify  (notify),
+	  _message (message)
+{
+	_wake = ::CreateSemaphore (NULL, 0, 0x7FFFFFFF, NULL) ;
+
+	if (_wake == NULL)
+		throw Win::Exception (TEXT("Error, could not create the semaphore of the image loader")) ;
+
+	for (int i = 0 ; i < threadCount ; ++i)
+	{
+		HANDLE h = reinterpret_cast <HANDLE> (::_beginthreadex (NULL, 0, ThreadProc, this, 0, NULL)) ;
+
+		if (h == NULL)
+		{
+			Stop () ;
+			throw Win::Exception (TEXT("Error, could not start the threads of the image loader")) ;
+		}
+
+		_threads.push_back (h) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Destructor.  Waits for the threads to finish the image they are 
+// loading and stops them.  The images not loaded yet are dropped.
+//-----------------------------------------------------------------
+
+Win::AsyncImageLoader::~AsyncImageLoader ()
+{
+	Stop () ;
+}
+
+//-----------------------------------------------------------------
+// Stops the threads and releases the semaphore.
+//-----------------------------------------------------------------
+
+void Win::AsyncImageLoader::Stop ()
+{
+	{
+		Win::Lock lock (_lock) ;
+		_stop = true ;
+		_queue.clear () ;
+	}
+
+	::ReleaseSemaphore (_wake, static_cast <LONG> (_threads.size ()), NULL) ;
+
+	for (size_t i = 0 ; i < _threads.size () ; ++i)
+	{
+		::WaitForSingleObject (_threads [i], INFINITE) ;
+		::CloseHandle (_threads [i]) ;
+	}
+
+	_threads.clear () ;
+	::CloseHandle (_wake) ;
+}
+
+//-----------------------------------------------------------------
+// Asks to load an image.
+//
+// Return value:  The ticket identifying the request.
+//
+// Parameters:
+//
+// const std::tstring & fileName -> The file containing the image.
+// const Type type               -> BITMAP or ICON.
+// const int width               -> Width of the loaded image, 0 for the
+//									size of the file.
+// const int height              -> Height of the loaded image, 0 for the
+//									size of the file.
+// const int priority            -> Requests with a higher priority are
+//									loaded first.
+//-----------------------------------------------------------------
+
+Win::AsyncImageLoader::Ticket Win::AsyncImageLoader::Load (const std::tstring & fileName, const Type type, const int width, const int height, const int priority)
+{
+	Request request ;
+	request.fileName = fileName ;
+	request.type     = type ;
+	request.width    = width ;
+	request.height   = height ;
+	request.priority = priority ;
+
+	{
+		Win::Lock lock (_lock) ;
+
+		request.ticket = _next++ ;
+		_queue.push_back (request) ;
+		std::push_heap (_queue.begin (), _queue.end ()) ;
+	}
+
+	::ReleaseSemaphore (_wake, 1, NULL) ;
+	return request.ticket ;
+}
+
+//-----------------------------------------------------------------
+// Changes the priority of a request that is not loaded yet.
+//
+// Parameters:
+//
+// const Ticket ticket -> The ticket of the request.
+// const int priority  -> The new priority.
+//-----------------------------------------------------------------
+
+void Win::AsyncImageLoader::SetPriority (const Ticket ticket, const int priority)
+{
+	Win::Lock lock (_lock) ;
+
+	std::vector <Request>::iterator it = FindRequest (ticket) ;
+
+	if (it != _queue.end () && it->priority != priority)
+	{
+		it->priority = priority ;
+		std::make_heap (_queue.begin (), _queue.end ()) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Cancels a request.  No message will be posted for it and its image
+// is dropped if it was already loaded.
+//
+// Parameters:
+//
+// const Ticket ticket -> The ticket of the request.
+//-----------------------------------------------------------------
+
+void Win::AsyncImageLoader::Cancel (const Ticket ticket)
+{
+	Win::Lock lock (_lock) ;
+
+	std::vector <Request>::iterator it = FindRequest (ticket) ;
+
+	if (it != _queue.end ())
+	{
+		_queue.erase (it) ;
+		std::make_heap (_queue.begin (), _queue.end ()) ;
+	}
+	else if (_running.find (ticket) != _running.end ())
+		_cancelled.insert (ticket) ;
+	else
+		_done.erase (ticket) ;
+}
+
+//-----------------------------------------------------------------
+// Cancels all the requests.
+//-----------------------------------------------------------------
+
+void Win::AsyncImageLoader::CancelAll ()
+{
+	Win::Lock lock (_lock) ;
+
+	_queue.clear () ;
+	_cancelled = _running ;
+	_done.clear () ;
+}
+
+//-----------------------------------------------------------------
+// Obtains a loaded image.  Call it when the message is received.
+//
+// Return value:  True if the image was loaded, false if it could not
+//				  be loaded or is not loaded yet.
+//
+// Parameters:
+//
+// const Ticket ticket       -> The ticket of the request.
+// Win::DecodedImage & image -> Will contain the image.  Use 
+//								CreateDIBSection to obtain a bitmap.
+//-----------------------------------------------------------------
+
+bool Win::AsyncImageLoader::GetResult (const Ticket ticket, Win::DecodedImage & image)
+{
+	Win::Lock lock (_lock) ;
+
+	std::map <Ticket, Win::DecodedImage>::iterator it = _done.find (ticket) ;
+
+	if (it == _done.end ())
+		return false ;
+
+	image.Swap (it->second) ;
+	_done.erase (it) ;
+
+	return image.GetPixels () != NULL ;
+}
+
+//-----------------------------------------------------------------
+// Loads an image in the calling thread.  Used by the loading threads.
+//
+// Return value:  True if the image was loaded.
+//
+// Parameters:
+//
+// const std::tstring & fileName -> The file containing the image.
+// const Type type               -> BITMAP or ICON.
+// const int width               -> Width of the loaded image, 0 for the
+//									size of the file.
+// const int height              -> Height of the loaded image, 0 for the
+//									size of the file.
+// Win::DecodedImage & image     -> Will contain the image.
+//-----------------------------------------------------------------
+
+bool Win::AsyncImageLoader::Decode (const std::tstring & fileName, const Type type, const int width, const int height, Win::DecodedImage & image)
+{
+	try
+	{
+		Win::Bitmap::DDB::StrongHandle bitmap ;
+		Win::Icon::StrongHandle        icon ;
+		int                            cx = width ;
+		int                            cy = height ;
+
+		if (type == BITMAP)
+		{
+			Win::Bitmap::DDB::StrongHandle loaded (static_cast <HBITMAP> (::LoadImage (NULL, fileName.c_str (), IMAGE_BITMAP, 0, 0, LR_LOADFROMFILE | LR_CREATEDIBSECTION))) ;
+			bitmap = loaded ;
+
+			if (bitmap.IsNull ())
+				return false ;
+
+			BITMAP info ;
+
+			if (::GetObject (bitmap, sizeof (info), &info) == 0)
+				return false ;
+
+			if (cx == 0) cx = info.bmWidth ;
+			if (cy == 0) cy = abs (info.bmHeight) ;
+		}
+		else
+		{
+			if (cx == 0) cx = ::GetSystemMetrics (SM_CXICON) ;
+			if (cy == 0) cy = ::GetSystemMetrics (SM_CYICON) ;
+
+			Win::Icon::StrongHandle loaded (static_cast <HICON> (::LoadImage (NULL, fileName.c_str (), IMAGE_ICON, cx, cy, LR_LOADFROMFILE))) ;
+			icon = loaded ;
+
+			if (icon.IsNull ())
+				return false ;
+		}
+
+		// Draw the image in a 32 bits DIB section of the final size.
+		Win::DecodedImage decoded ;
+		decoded.Resize (cx, cy) ;
+
+		Win::Bitmap::DIBSection::StrongHandle target (decoded.CreateDIBSection ()) ;
+
+		{
+			Win::MemoryCanvas               canvas ;
+			Win::Bitmap::DIBSection::Holder holder (canvas, target) ;
+
+			if (type == BITMAP)
+			{
+				Win::MemoryCanvas        source ;
+				Win::Bitmap::DDB::Holder sourceHolder (source, bitmap) ;
+				BITMAP                   info ;
+
+				::GetObject (bitmap, sizeof (info), &info) ;
+				::SetStretchBltMode (canvas, HALFTONE) ;
+
+				if (!::StretchBlt (canvas, 0, 0, cx, cy, source, 0, 0, info.bmWidth, abs (info.bmHeight), SRCCOPY))
+					return false ;
+			}
+			else if (!::DrawIconEx (canvas, 0, 0, icon, cx, cy, 0, NULL, DI_NORMAL))
+				return false ;
+		}
+
+		::GdiFlush () ;
+
+		BITMAP bits ;
+
+		if (::GetObject (target, sizeof (bits), &bits) == 0)
+			return false ;
+
+		::CopyMemory (decoded.GetPixels (), bits.bmBits, decoded.GetSize ()) ;
+		image.Swap (decoded) ;
+		return true ;
+	}
+	catch (...)
+	{
+		return false ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Entry point of the loading threads.
+//
+// Return value:  Always 0.
+//
+// Parameters:
+//
+// void * param -> The Win::AsyncImageLoader object.
+//-----------------------------------------------------------------
+
+unsigned __stdcall Win::AsyncImageLoader::ThreadProc (void * param)
+{
+	static_cast <Win::AsyncImageLoader *> (param)->Work () ;
+	return 0 ;
+}
+
+//-----------------------------------------------------------------
+// Loads the requests until the loader is destroyed.
+//-----------------------------------------------------------------
+
+void Win::AsyncImageLoader::Work ()
+{
+	for (;;)
+	{
+		::WaitForSingleObject (_wake, INFINITE) ;
+
+		Request request ;
+
+		{
+			Win::Lock lock (_lock) ;
+
+			if (_stop)
+				return ;
+
+			// The request may have been cancelled.
+			if (_queue.empty ())
+				continue ;
+
+			std::pop_heap (_queue.begin (), _queue.end ()) ;
+			request = _queue.back () ;
+			_queue.pop_back () ;
+
+			const Win::DecodedImage * cached = _cache.Find (MakeKey (request)) ;
+
+			if (cached == NULL)
+				_running.insert (request.ticket) ;
+			else
+			{
+				_done [request.ticket] = *cached ;
+				::PostMessage (_notify, _message, request.ticket, TRUE) ;
+				continue ;
+			}
+		}
+
+		// Decode without holding the lock.
+		Win::DecodedImage image ;
+		bool              loaded = Decode (request.fileName, request.type, request.width, request.height, image) ;
+
+		Win::Lock lock (_lock) ;
+
+		_running.erase (request.ticket) ;
+
+		if (loaded)
+		{
+			Win::DecodedImage copy (image) ;
+			_cache.Insert (MakeKey (request), copy) ;
+		}
+
+		if (_cancelled.erase (request.ticket) != 0 || _stop)
+			continue ;
+
+		_done [request.ticket].Swap (image) ;
+		::PostMessage (_notify, _message, request.ticket, loaded) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Finds a request waiting to be loaded.  The lock must be held.
+//
+// Return value:  An iterator on the request, or _queue.end ().
+//
+// Parameters:
+//
+// const Ticket ticket -> The ticket of the request.
+//-----------------------------------------------------------------
+
+std::vector <Win::AsyncImageLoader::Request>::iterator Win::AsyncImageLoader::FindRequest (const Ticket ticket)
+{
+	for (std::vector <Request>::iterator it = _queue.begin () ; it != _queue.end () ; ++it)
+	{
+		if (it->ticket == ticket)
+			return it ;
+	}
+
+	return _queue.end () ;
+}
+
+//-----------------------------------------------------------------
+// Builds the key of a request in the cache.
+//
+// Return value:  The key.
+//
+// Parameters:
+//
+// const Request & request -> The request.
+//-----------------------------------------------------------------
+
+std::tstring Win::AsyncImageLoader::MakeKey (const Request & request)
+{
+	std::tostringstream key ;
+	key << request.type << TEXT('|') << request.width << TEXT('|') << request.height << TEXT('|') << request.fileName ;
+	return key.str () ;
+}
\ No newline at end of file
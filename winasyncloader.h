@@ -0,0 +1,246 @@
+//-----------------------------------------------------------------
+//  This file contains classes used to load images in background
+//  threads:  Win::DecodedImage, Win::ImageCache and 
+//  Win::AsyncImageLoader.
+//-----------------------------------------------------------------
+
+#if !defined (WINASYNCLOADER_H)
+
+	#define WINASYNCLOADER_H
+	#include "useunicode.h"
+	#include "winunicodehelper.h"
+	#include "windrawingtool.h"
+	#include "winsync.h"
+	#include <vector>
+	#include <list>
+	#include <map>
+	#include <set>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// Win::DecodedImage holds the pixels of an image in memory, in 32
+		// bits top-down rows, ready to be copied in a DIB section.
+		//-----------------------------------------------------------------
+
+		class DecodedImage
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Constructor.  Creates an empty image.
+			//-----------------------------------------------------------------
+
+			DecodedImage ()
+				: _width  (0),
+				  _height (0)
+			{}
+
+			//-----------------------------------------------------------------
+			// Changes the size of the image.  The pixels are lost.
+			//
+			// Parameters:
+			//
+			// const int width  -> The new width.
+			// const int height -> The new height.
+			//-----------------------------------------------------------------
+
+			void Resize (const int width, const int height)
+			{
+				_width  = width ;
+				_height = height ;
+				_pixels.resize (width * height) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Exchanges the content of two images without copying the pixels.
+			//
+			// Parameters:
+			//
+			// Win::DecodedImage & image -> The other image.
+			//-----------------------------------------------------------------
+
+			void Swap (Win::DecodedImage & image)
+			{
+				std::swap (_width, image._width) ;
+				std::swap (_height, image._height) ;
+				_pixels.swap (image._pixels) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the width of the image.
+			//-----------------------------------------------------------------
+
+			int GetWidth () const
+			{
+				return _width ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the height of the image.
+			//-----------------------------------------------------------------
+
+			int GetHeight () const
+			{
+				return _height ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the memory used by the pixels in bytes.
+			//-----------------------------------------------------------------
+
+			DWORD GetSize () const
+			{
+				return static_cast <DWORD> (_pixels.size () * sizeof (DWORD)) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the pixels, NULL if the image is empty.
+			//-----------------------------------------------------------------
+
+			DWORD * GetPixels ()
+			{
+				return _pixels.empty () ? NULL : &_pixels [0] ;
+			}
+
+			const DWORD * GetPixels () const
+			{
+				return _pixels.empty () ? NULL : &_pixels [0] ;
+			}
+
+			Win::Bitmap::DIBSection::StrongHandle CreateDIBSection () const ;
+
+		private:
+
+			int                 _width ;
+			int                 _height ;
+			std::vector <DWORD> _pixels ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// Win::ImageCache keeps the most recently used decoded images
+		// until their total size exceeds a budget.  The least recently used
+		// images are then removed.  Not thread safe.
+		//-----------------------------------------------------------------
+
+		class ImageCache
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Constructor.
+			//
+			// Parameters:
+			//
+			// const DWORD maxBytes -> The maximum memory used by the images.
+			//-----------------------------------------------------------------
+
+			ImageCache (const DWORD maxBytes)
+				: _maxBytes (maxBytes),
+				  _bytes    (0)
+			{}
+
+			const Win::DecodedImage * Find (const std::tstring & key) ;
+			void Insert (const std::tstring & key, Win::DecodedImage & image) ;
+			void SetMaxBytes (const DWORD maxBytes) ;
+			void Clear () ;
+
+			//-----------------------------------------------------------------
+			// Obtains the memory used by the images in bytes.
+			//-----------------------------------------------------------------
+
+			DWORD GetBytes () const
+			{
+				return _bytes ;
+			}
+
+		private:
+
+			typedef std::list <std::pair <std::tstring, Win::DecodedImage> > ImageList ;
+
+			void Trim () ;
+
+			ImageList                                          _images ;   // Most recently used first.
+			std::map <std::tstring, ImageList::iterator>       _index ;    // Images by key.
+			DWORD                                              _maxBytes ; // Budget.
+			DWORD                                              _bytes ;    // Memory used.
+		} ;
+
+		//-----------------------------------------------------------------
+		// Win::AsyncImageLoader loads bitmap and icon files with a pool of
+		// background threads, so that the user interface never waits for
+		// the disk.  Each request gets a ticket.  The requests with the 
+		// highest priority are loaded first; raise the priority of the
+		// images that become visible.  When an image is loaded, the loader
+		// posts a message to a window:  wParam is the ticket and lParam is
+		// TRUE if the image could be loaded.  The window then calls 
+		// GetResult to obtain the image.  Decoded images are kept in a
+		// cache so that loading the same file again is immediate.
+		//-----------------------------------------------------------------
+
+		class AsyncImageLoader
+		{
+		public:
+
+			enum Type { BITMAP, ICON } ;
+
+			typedef unsigned int Ticket ;
+
+			AsyncImageLoader (const HWND notify, const UINT message, const int threadCount = 2, const DWORD cacheBytes = 16 * 1024 * 1024) ;
+			~AsyncImageLoader () ;
+
+			Ticket Load (const std::tstring & fileName, const Type type, const int width = 0, const int height = 0, const int priority = 0) ;
+			void SetPriority (const Ticket ticket, const int priority) ;
+			void Cancel (const Ticket ticket) ;
+			void CancelAll () ;
+			bool GetResult (const Ticket ticket, Win::DecodedImage & image) ;
+
+			static bool Decode (const std::tstring & fileName, const Type type, const int width, const int height, Win::DecodedImage & image) ;
+
+		private:
+
+			AsyncImageLoader (const Win::AsyncImageLoader & loader) ;
+			AsyncImageLoader & operator = (const Win::AsyncImageLoader & loader) ;
+
+			//-----------------------------------------------------------------
+			// A request waiting to be loaded.
+			//-----------------------------------------------------------------
+
+			struct Request
+			{
+				Ticket       ticket ;
+				std::tstring fileName ;
+				Type         type ;
+				int          width ;
+				int          height ;
+				int          priority ;
+
+				// Highest priority first, then oldest ticket first.
+				bool operator < (const Request & request) const
+				{
+					return priority < request.priority || (priority == request.priority && ticket > request.ticket) ;
+				}
+			} ;
+
+			void Stop () ;
+			static unsigned __stdcall ThreadProc (void * param) ;
+			void Work () ;
+			std::vector <Request>::iterator FindRequest (const Ticket ticket) ;
+			static std::tstring MakeKey (const Request & request) ;
+
+			Win::CriticalSection                    _lock ;      // Protects the members below.
+			std::vector <Request>                   _queue ;     // Heap of waiting requests.
+			std::set <Ticket>                       _running ;   // Requests being loaded.
+			std::set <Ticket>                       _cancelled ; // Running requests that were cancelled.
+			std::map <Ticket, Win::DecodedImage>    _done ;      // Loaded images not yet obtained.
+			Win::ImageCache                         _cache ;     // Recently loaded images.
+			Ticket                                  _next ;      // Next ticket.
+			bool                                    _stop ;      // True when the threads must end.
+			HANDLE                                  _wake ;      // Semaphore counting the requests.
+			std::vector <HANDLE>                    _threads ;
+			HWND                                    _notify ;
+			UINT                                    _message ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,543 @@
+#include "winbandedregion.h"
+#include "winexception.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// Constructor.  Creates a rectangular region.
+//
+// Parameters:
+//
+// const RECT & rect -> The rectangle.
+//-----------------------------------------------------------------
+
+Win::Region::BandedRegion::BandedRegion (const RECT & rect)
+{
+	SetRect (rect) ;
+}
+
+//-----------------------------------------------------------------
+// Makes the region a rectangle.
+//
+// Parameters:
+//
+// const RECT & rect -> The rectangle.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::SetRect (const RECT & rect)
+{
+	Clear () ;
+
+	if (rect.left < rect.right && rect.top < rect.bottom)
+	{
+		LONG xs [2] = { rect.left, rect.right } ;
+		AddBand (rect.top, rect.bottom, xs, 2) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Combines the region with another one.
+//
+// Parameters:
+//
+// const Win::Region::BandedRegion & region -> The other region.
+// const Win::Region::CombineFlag flag      -> And, Or, Diff, Xor or Copy.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::Combine (const Win::Region::BandedRegion & region, const Win::Region::CombineFlag flag)
+{
+	Combine (*this, region, flag) ;
+}
+
+//-----------------------------------------------------------------
+// Replaces the region by the combination of two regions, like
+// CombineRgn.  Any of the two regions may be this region.
+//
+// Parameters:
+//
+// const Win::Region::BandedRegion & a -> The first region.
+// const Win::Region::BandedRegion & b -> The second region.
+// const Win::Region::CombineFlag flag -> And, Or, Diff (a minus b), Xor
+//										  or Copy (a).
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::Combine (const Win::Region::BandedRegion & a, const Win::Region::BandedRegion & b, const Win::Region::CombineFlag flag)
+{
+	// The result only changes where one of the regions has an edge.
+	std::vector <LONG> ys ;
+	ys.reserve ((a._bands.size () + b._bands.size ()) * 2) ;
+
+	for (size_t i = 0 ; i < a._bands.size () ; ++i)
+	{
+		ys.push_back (a._bands [i].top) ;
+		ys.push_back (a._bands [i].bottom) ;
+	}
+
+	for (size_t i = 0 ; i < b._bands.size () ; ++i)
+	{
+		ys.push_back (b._bands [i].top) ;
+		ys.push_back (b._bands [i].bottom) ;
+	}
+
+	std::sort (ys.begin (), ys.end ()) ;
+	ys.erase (std::unique (ys.begin (), ys.end ()), ys.end ()) ;
+
+	Win::Region::BandedRegion result ;
+	std::vector <LONG>        spans ;
+	size_t                    ia = 0 ;
+	size_t                    ib = 0 ;
+
+	for (size_t k = 0 ; k + 1 < ys.size () ; ++k)
+	{
+		LONG y = ys [k] ;
+
+		while (ia < a._bands.size () && a._bands [ia].bottom <= y)
+			++ia ;
+
+		while (ib < b._bands.size () && b._bands [ib].bottom <= y)
+			++ib ;
+
+		const LONG * xsA    = NULL ;
+		const LONG * xsB    = NULL ;
+		size_t       countA = 0 ;
+		size_t       countB = 0 ;
+
+		if (ia < a._bands.size () && a._bands [ia].top <= y)
+		{
+			xsA    = &a._xs [a._bands [ia].first] ;
+			countA = a._bands [ia].count ;
+		}
+
+		if (ib < b._bands.size () && b._bands [ib].top <= y)
+		{
+			xsB    = &b._xs [b._bands [ib].first] ;
+			countB = b._bands [ib].count ;
+		}
+
+		if (countA == 0 && countB == 0)
+			continue ;
+
+		CombineSpans (xsA, countA, xsB, countB, flag, spans) ;
+
+		if (!spans.empty ())
+			result.AddBand (y, ys [k + 1], &spans [0], spans.size ()) ;
+	}
+
+	_bands.swap (result._bands) ;
+	_xs.swap (result._xs) ;
+}
+
+//-----------------------------------------------------------------
+// Moves the region.
+//
+// Parameters:
+//
+// const int dx -> Horizontal move.
+// const int dy -> Vertical move.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::Offset (const int dx, const int dy)
+{
+	for (size_t i = 0 ; i < _bands.size () ; ++i)
+	{
+		_bands [i].top    += dy ;
+		_bands [i].bottom += dy ;
+	}
+
+	for (size_t i = 0 ; i < _xs.size () ; ++i)
+		_xs [i] += dx ;
+}
+
+//-----------------------------------------------------------------
+// Tests if a point is in the region.
+//
+// Return value:  True if the point is in the region.
+//
+// Parameters:
+//
+// const int x -> X coordinate of the point.
+// const int y -> Y coordinate of the point.
+//-----------------------------------------------------------------
+
+bool Win::Region::BandedRegion::Contains (const int x, const int y) const
+{
+	int index = FindBand (y) ;
+
+	if (index < 0 || _bands [index].top > y)
+		return false ;
+
+	// The point is inside if an odd number of edges are at its left.
+	const LONG * first = &_xs [_bands [index].first] ;
+	const LONG * last  = first + _bands [index].count ;
+
+	return (std::upper_bound (first, last, static_cast <LONG> (x)) - first) % 2 == 1 ;
+}
+
+//-----------------------------------------------------------------
+// Tests if a rectangle is entirely in the region.
+//
+// Return value:  True if the rectangle is not empty and every point of
+//				  the rectangle is in the region.
+//
+// Parameters:
+//
+// const RECT & rect -> The rectangle.
+//-----------------------------------------------------------------
+
+bool Win::Region::BandedRegion::Contains (const RECT & rect) const
+{
+	if (rect.left >= rect.right || rect.top >= rect.bottom)
+		return false ;
+
+	int  index = FindBand (rect.top) ;
+	LONG y     = rect.top ;
+
+	if (index < 0)
+		return false ;
+
+	for (size_t i = index ; i < _bands.size () && y < rect.bottom ; ++i)
+	{
+		// A gap between the bands.
+		if (_bands [i].top > y)
+			return false ;
+
+		const LONG * first = &_xs [_bands [i].first] ;
+		const LONG * last  = first + _bands [i].count ;
+		ptrdiff_t    edges = std::upper_bound (first, last, rect.left) - first ;
+
+		if (edges % 2 == 0 || first [edges] < rect.right)
+			return false ;
+
+		y = _bands [i].bottom ;
+	}
+
+	return y >= rect.bottom ;
+}
+
+//-----------------------------------------------------------------
+// Tests if a rectangle has some points in the region.
+//
+// Return value:  True if the rectangle intersects the region.
+//
+// Parameters:
+//
+// const RECT & rect -> The rectangle.
+//-----------------------------------------------------------------
+
+bool Win::Region::BandedRegion::Intersects (const RECT & rect) const
+{
+	if (rect.left >= rect.right || rect.top >= rect.bottom)
+		return false ;
+
+	int index = FindBand (rect.top) ;
+
+	if (index < 0)
+		return false ;
+
+	for (size_t i = index ; i < _bands.size () && _bands [i].top < rect.bottom ; ++i)
+	{
+		const LONG * first = &_xs [_bands [i].first] ;
+		const LONG * last  = first + _bands [i].count ;
+		ptrdiff_t    edges = std::upper_bound (first, last, rect.left) - first ;
+
+		// Either the left side is inside a span or a span starts before the right side.
+		if (edges % 2 == 1 || (first + edges != last && first [edges] < rect.right))
+			return true ;
+	}
+
+	return false ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the smallest rectangle containing the region.
+//
+// Return value:  False if the region is empty.
+//
+// Parameters:
+//
+// RECT & rect -> Will contain the rectangle.
+//-----------------------------------------------------------------
+
+bool Win::Region::BandedRegion::GetBounds (RECT & rect) const
+{
+	if (_bands.empty ())
+	{
+		::SetRectEmpty (&rect) ;
+		return false ;
+	}
+
+	rect.top    = _bands.front ().top ;
+	rect.bottom = _bands.back ().bottom ;
+	rect.left   = _xs [_bands [0].first] ;
+	rect.right  = _xs [_bands [0].first + _bands [0].count - 1] ;
+
+	for (size_t i = 1 ; i < _bands.size () ; ++i)
+	{
+		LONG left  = _xs [_bands [i].first] ;
+		LONG right = _xs [_bands [i].first + _bands [i].count - 1] ;
+
+		if (left < rect.left)
+			rect.left = left ;
+
+		if (right > rect.right)
+			rect.right = right ;
+	}
+
+	return true ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the rectangles making the region, sorted from top to bottom
+// and from left to right, like GetRegionData.
+//
+// Parameters:
+//
+// std::vector <RECT> & rects -> Will contain the rectangles.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::GetRects (std::vector <RECT> & rects) const
+{
+	rects.clear () ;
+	rects.reserve (_xs.size () / 2) ;
+
+	for (size_t i = 0 ; i < _bands.size () ; ++i)
+	{
+		for (size_t k = 0 ; k < _bands [i].count ; k += 2)
+		{
+			RECT rect ;
+			rect.left   = _xs [_bands [i].first + k] ;
+			rect.right  = _xs [_bands [i].first + k + 1] ;
+			rect.top    = _bands [i].top ;
+			rect.bottom = _bands [i].bottom ;
+
+			rects.push_back (rect) ;
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// Replaces the region by the content of a GDI region.
+//
+// Parameters:
+//
+// Win::Region::Handle h -> The GDI region.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::FromHandle (Win::Region::Handle h)
+{
+	DWORD size = ::GetRegionData (h, 0, NULL) ;
+
+	if (size == 0)
+		throw Win::Exception (TEXT("Error, could not get the data of a region")) ;
+
+	std::vector <BYTE> buffer (size) ;
+	RGNDATA *          data = reinterpret_cast <RGNDATA *> (&buffer [0]) ;
+
+	if (::GetRegionData (h, size, data) == 0)
+		throw Win::Exception (TEXT("Error, could not get the data of a region")) ;
+
+	Clear () ;
+
+	// GDI gives the rectangles band by band, all the rectangles of a band
+	// have the same top and bottom.
+	const RECT *       rects = reinterpret_cast <const RECT *> (data->Buffer) ;
+	std::vector <LONG> spans ;
+
+	for (DWORD i = 0 ; i < data->rdh.nCount ; ++i)
+	{
+		if (i > 0 && rects [i].top != rects [i - 1].top)
+		{
+			AddBand (rects [i - 1].top, rects [i - 1].bottom, &spans [0], spans.size ()) ;
+			spans.clear () ;
+		}
+
+		spans.push_back (rects [i].left) ;
+		spans.push_back (rects [i].right) ;
+	}
+
+	if (!spans.empty ())
+		AddBand (rects [data->rdh.nCount - 1].top, rects [data->rdh.nCount - 1].bottom, &spans [0], spans.size ()) ;
+}
+
+//-----------------------------------------------------------------
+// Creates a GDI region with the same content, with a single call to
+// ExtCreateRegion.
+//
+// Return value:  A strong handle on the GDI region.
+//-----------------------------------------------------------------
+
+Win::Region::StrongHandle Win::Region::BandedRegion::CreateHandle () const
+{
+	DWORD              count = static_cast <DWORD> (_xs.size () / 2) ;
+	DWORD              size  = sizeof (RGNDATAHEADER) + count * sizeof (RECT) ;
+	std::vector <BYTE> buffer (size) ;
+	RGNDATA *          data  = reinterpret_cast <RGNDATA *> (&buffer [0]) ;
+
+	data->rdh.dwSize   = sizeof (RGNDATAHEADER) ;
+	data->rdh.iType    = RDH_RECTANGLES ;
+	data->rdh.nCount   = count ;
+	data->rdh.nRgnSize = count * sizeof (RECT) ;
+	GetBounds (data->rdh.rcBound) ;
+
+	std::vector <RECT> rects ;
+	GetRects (rects) ;
+
+	if (count != 0)
+		::CopyMemory (data->Buffer, &rects [0], count * sizeof (RECT)) ;
+
+	HRGN h = ::ExtCreateRegion (NULL, size, data) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not create a region")) ;
+
+	return Win::Region::StrongHandle (h) ;
+}
+
+//-----------------------------------------------------------------
+// Compares the area covered by two regions.
+//
+// Return value:  True if the regions cover the same area.
+//
+// Parameters:
+//
+// const Win::Region::BandedRegion & region -> The other region.
+//-----------------------------------------------------------------
+
+bool Win::Region::BandedRegion::operator == (const Win::Region::BandedRegion & region) const
+{
+	if (_bands.size () != region._bands.size () || _xs.size () != region._xs.size ())
+		return false ;
+
+	for (size_t i = 0 ; i < _bands.size () ; ++i)
+	{
+		if (_bands [i].top   != region._bands [i].top   || _bands [i].bottom != region._bands [i].bottom ||
+			_bands [i].count != region._bands [i].count)
+		{
+			return false ;
+		}
+	}
+
+	return std::equal (_xs.begin (), _xs.end (), region._xs.begin ()) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a band at the bottom of the region, or extends the last band
+// if it touches the new one and has the same spans.
+//
+// Parameters:
+//
+// const LONG top      -> Top of the band.
+// const LONG bottom   -> Bottom of the band.
+// const LONG * xs     -> The spans:  left, right, left, right...
+// const size_t count  -> Number of values in xs.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::AddBand (const LONG top, const LONG bottom, const LONG * xs, const size_t count)
+{
+	if (!_bands.empty ())
+	{
+		Band & last = _bands.back () ;
+
+		if (last.bottom == top && last.count == count && std::equal (xs, xs + count, _xs.begin () + last.first))
+		{
+			last.bottom = bottom ;
+			return ;
+		}
+	}
+
+	Band band ;
+	band.top    = top ;
+	band.bottom = bottom ;
+	band.first  = _xs.size () ;
+	band.count  = count ;
+
+	_bands.push_back (band) ;
+	_xs.insert (_xs.end (), xs, xs + count) ;
+}
+
+//-----------------------------------------------------------------
+// Finds the first band that ends below a y coordinate.
+//
+// Return value:  Index of the band, or -1 if all the bands are above.
+//
+// Parameters:
+//
+// const LONG y -> The y coordinate.
+//-----------------------------------------------------------------
+
+int Win::Region::BandedRegion::FindBand (const LONG y) const
+{
+	size_t low  = 0 ;
+	size_t high = _bands.size () ;
+
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2 ;
+
+		if (_bands [mid].bottom <= y)
+			low = mid + 1 ;
+		else
+			high = mid ;
+	}
+
+	return low < _bands.size () ? static_cast <int> (low) : -1 ;
+}
+
+//-----------------------------------------------------------------
+// Combines the spans of two bands.
+//
+// Parameters:
+//
+// const LONG * a                      -> The spans of the first band.
+// const size_t countA                 -> Number of values in a.
+// const LONG * b                      -> The spans of the second band.
+// const size_t countB                 -> Number of values in b.
+// const Win::Region::CombineFlag flag -> How to combine the spans.
+// std::vector <LONG> & result         -> Will contain the spans.
+//-----------------------------------------------------------------
+
+void Win::Region::BandedRegion::CombineSpans (const LONG * a, const size_t countA, const LONG * b, const size_t countB,
+											  const Win::Region::CombineFlag flag, std::vector <LONG> & result)
+{
+	result.clear () ;
+
+	size_t i      = 0 ;
+	size_t j      = 0 ;
+	bool   inA    = false ;
+	bool   inB    = false ;
+	bool   inside = false ;
+
+	// Walk the edges of both bands from left to right.
+	while (i < countA || j < countB)
+	{
+		LONG x = (j == countB || (i < countA && a [i] <= b [j])) ? a [i] : b [j] ;
+
+		while (i < countA && a [i] == x)
+		{
+			inA = !inA ;
+			++i ;
+		}
+
+		while (j < countB && b [j] == x)
+		{
+			inB = !inB ;
+			++j ;
+		}
+
+		bool now ;
+
+		switch (flag)
+		{
+		case And:  now = inA && inB ;  break ;
+		case Or:   now = inA || inB ;  break ;
+		case Diff: now = inA && !inB ; break ;
+		case Xor:  now = inA != inB ;  break ;
+		default:   now = inA ;         break ;
+		}
+
+		if (now != inside)
+		{
+			result.push_back (x) ;
+			inside = now ;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Region::BandedRegion.
+//-----------------------------------------------------------------
+
+#if !defined (WINBANDEDREGION_H)
+
+	#define WINBANDEDREGION_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include "windrawingtool.h"
+	#include <vector>
+
+	namespace Win
+	{
+		namespace Region
+		{
+			//-----------------------------------------------------------------
+			// Win::Region::BandedRegion is a region kept in memory instead of
+			// in GDI, so that it can be combined and hit tested without any
+			// call to the system.  Like GDI regions, it is made of horizontal
+			// bands; each band has a list of sorted, separated spans [left,
+			// right).  Bands that touch and have the same spans are merged, so
+			// two regions covering the same area are identical.
+			//-----------------------------------------------------------------
+
+			class BandedRegion
+			{
+			public:
+
+				//-----------------------------------------------------------------
+				// Constructor.  Creates an empty region.
+				//-----------------------------------------------------------------
+
+				BandedRegion ()
+				{}
+
+				BandedRegion (const RECT & rect) ;
+
+				void SetRect (const RECT & rect) ;
+				void Combine (const Win::Region::BandedRegion & region, const Win::Region::CombineFlag flag) ;
+				void Combine (const Win::Region::BandedRegion & a, const Win::Region::BandedRegion & b, const Win::Region::CombineFlag flag) ;
+				void Offset (const int dx, const int dy) ;
+
+				bool Contains (const int x, const int y) const ;
+				bool Contains (const RECT & rect) const ;
+				bool Intersects (const RECT & rect) const ;
+				bool GetBounds (RECT & rect) const ;
+				void GetRects (std::vector <RECT> & rects) const ;
+
+				void FromHandle (Win::Region::Handle h) ;
+				Win::Region::StrongHandle CreateHandle () const ;
+
+				//-----------------------------------------------------------------
+				// Returns true if the region is empty.
+				//-----------------------------------------------------------------
+
+				bool IsEmpty () const
+				{
+					return _bands.empty () ;
+				}
+
+				//-----------------------------------------------------------------
+				// Removes everything from the region.
+				//-----------------------------------------------------------------
+
+				void Clear ()
+				{
+					_bands.clear () ;
+					_xs.clear () ;
+				}
+
+				//-----------------------------------------------------------------
+				// Compares the area covered by two regions.
+				//-----------------------------------------------------------------
+
+				bool operator == (const Win::Region::BandedRegion & region) const ;
+
+				bool operator != (const Win::Region::BandedRegion & region) const
+				{
+					return !(*this == region) ;
+				}
+
+			private:
+
+				//-----------------------------------------------------------------
+				// A horizontal band.  Its spans are the count values of _xs 
+				// starting at first:  left, right, left, right...
+				//-----------------------------------------------------------------
+
+				struct Band
+				{
+					LONG   top ;
+					LONG   bottom ;
+					size_t first ;
+					size_t count ;
+				} ;
+
+				void AddBand (const LONG top, const LONG bottom, const LONG * xs, const size_t count) ;
+				int FindBand (const LONG y) const ;
+
+				static void CombineSpans (const LONG * a, const size_t countA, const LONG * b, const size_t countB,
+										  const Win::Region::CombineFlag flag, std::vector <LONG> & result) ;
+
+				std::vector <Band> _bands ; // Sorted from top to bottom, separated or with different spans.
+				std::vector <LONG> _xs ;    // The spans of all the bands.
+			} ;
+		}
+	}
+
+#endif
\ No newline at end of file
@@ -11,6 +11,7 @@
 	#include "wincursor.h"
 	#include "windrawingtool.h"
 	#include "winunicodehelper.h"
+	#include "winstyle.h"
 
 	LRESULT CALLBACK Proc ( HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam ) ;
 
@@ -46,6 +47,21 @@
 					throw Win::Exception (TEXT("Error, could not register class.")) ;
 			}
 
+			//--------------------------------------------------------------------
+			// Registers the class unless a class of the same name is already
+			// registered for the instance.  Allows to describe a class once
+			// and register it the first time a window of that type is needed.
+			//--------------------------------------------------------------------
+
+			void RegisterOnce () const
+			{
+				WNDCLASSEX info ;
+				info.cbSize = sizeof (WNDCLASSEX) ;
+
+				if (!::GetClassInfoEx (_wndClass.hInstance, _wndClass.lpszClassName, &info))
+					Register () ;
+			}
+
 			//--------------------------------------------------------------------------
 			// It is possible to reserve some memory space to the class for various
 			// purposes.  This method allow to set how many byte of memory must be 
@@ -188,6 +204,17 @@
 				_wndClass.style = style ;
 			}
 
+			//-----------------------------------------------------------
+			// Sets the style from a Win::Style::Descriptor built at
+			// compile time.  Only the class style is used.
+			//-----------------------------------------------------------
+
+			template <class Descriptor>
+			void SetStyles ()
+			{
+				_wndClass.style = Descriptor::ClassStyle ;
+			}
+
 			//----------------------------------------------------------------------
 			// Reset the style of the class.
 			//----------------------------------------------------------------------
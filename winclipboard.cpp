@@ -131,8 +131,230 @@ Win::Bitmap::DIBSection::StrongHandle Win::Clipboard::DIBSectionClip::Paste (Win
 
 	Win::Global::Lock lock (handle, (void **) &pGlobal) ;
 
-	dib.PasteFromClipboard ((BITMAPINFO *) pGlobal) ;
+	dib.PasteFromClipboard ((BITMAPINFO *) pGlobal, handle.GetSize ()) ;
 
 
 	return dib ;
 }
+
+//------------------------------------------------------------
+// Draws the DIB on the clipboard directly from the clipboard 
+// memory, without creating a DIB section.  Avoids copying the
+// pixels when the image only needs to be displayed.
+//
+// parameters:
+// 
+// Win::Base & win      -> The window opening the clipboard.
+// Win::Canvas & canvas -> The canvas on which the DIB is drawn.
+// const int x          -> X coordinate of the upper left corner.
+// const int y          -> Y coordinate of the upper left corner.
+//------------------------------------------------------------
+
+void Win::Clipboard::DIBSectionClip::Draw (Win::Base & win, Win::Canvas & canvas, const int x, const int y)
+{
+	Win::Global::Handle    handle ;
+	Win::Clipboard::Reader read (win);
+	BITMAPINFO *           packedDib ;
+	DWORD                  imageSize ;
+
+	handle = read.GetHandle (Win::Clipboard::DIB) ;
+
+	if (handle == NULL)
+		throw Win::Exception (TEXT("Error, could no obtain a DIB from the clipboard")) ;
+
+	Win::Global::Lock lock (handle, (void **) &packedDib) ;
+
+	const BYTE * bits = Win::Bitmap::DIBSection::GetPackedDIBBits (packedDib, handle.GetSize (), imageSize) ;
+
+	int width ;
+	int height ;
+
+	if (packedDib->bmiHeader.biSize == sizeof (BITMAPCOREHEADER))
+	{
+		width  = ((BITMAPCOREHEADER *) packedDib)->bcWidth ;
+		height = ((BITMAPCOREHEADER *) packedDib)->bcHeight ;
+	}
+	else
+	{
+		width  = packedDib->bmiHeader.biWidth ;
+		height = packedDib->bmiHeader.biHeight < 0 ? -packedDib->bmiHeader.biHeight : packedDib->bmiHeader.biHeight ;
+	}
+
+	if (::SetDIBitsToDevice (canvas, x, y, width, height, 0, 0, 0, height, bits, packedDib, DIB_RGB_COLORS) == 0)
+		throw Win::Exception (TEXT("Error, could not draw the DIB from the clipboard")) ;
+}
+
+
+//------------------------------------------------------------
+// Destructor.  Frees the rendered data.
+//------------------------------------------------------------
+
+Win::Clipboard::Publisher::~Publisher ()
+{
+	Invalidate () ;
+}
+
+//------------------------------------------------------------
+// Adds a format to publish.
+//
+// Parameters:
+//
+// const UINT format                   -> The format.
+// Win::Clipboard::Renderer * renderer -> Produces the data of the
+//										  format.  Not owned.
+//------------------------------------------------------------
+
+void Win::Clipboard::Publisher::AddFormat (const UINT format, Win::Clipboard::Renderer * renderer)
+{
+	Entry entry ;
+
+	entry.format   = format ;
+	entry.renderer = renderer ;
+	entry.rendered = NULL ;
+
+	_entries.push_back (entry) ;
+}
+
+//------------------------------------------------------------
+// Empties the clipboard and announces all the formats without
+// rendering them.
+//------------------------------------------------------------
+
+void Win::Clipboard::Publisher::Publish () const
+{
+	Win::Clipboard::Saver save (_owner) ;
+
+	for (std::vector <Entry>::const_iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+	{
+		// A NULL handle asks Windows to send WM_RENDERFORMAT when the data is needed.
+		::SetClipboardData (it->format, NULL) ;
+	}
+}
+
+//------------------------------------------------------------
+// Puts the data of a format on the clipboard.  Must be called 
+// when the owner receives WM_RENDERFORMAT.  The clipboard is
+// already opened by the application that asked for the data.
+//
+// Return value:  True if the format is published, else false.
+//
+// Parameters:
+//
+// const UINT format -> The requested format.
+//------------------------------------------------------------
+
+bool Win::Clipboard::Publisher::RenderFormat (const UINT format)
+{
+	for (std::vector <Entry>::iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+	{
+		if (it->format == format)
+		{
+			HGLOBAL h = Render (*it) ;
+
+			if (::SetClipboardData (format, h) == NULL)
+			{
+				::GlobalFree (h) ;
+				throw Win::Exception (TEXT("Error, could not set the clipboard data.")) ;
+			}
+
+			return true ;
+		}
+	}
+
+	return false ;
+}
+
+//------------------------------------------------------------
+// Puts the data of all the formats on the clipboard.  Must be
+// called when the owner receives WM_RENDERALLFORMATS, before it
+// is destroyed.
+//------------------------------------------------------------
+
+void Win::Clipboard::Publisher::RenderAllFormats ()
+{
+	// Opens the clipboard without emptying it, and closes it even if
+	// a renderer throws.
+	Win::Clipboard::Reader clipboard (_owner) ;
+
+	// Another application may have emptied the clipboard meanwhile.
+	if (::GetClipboardOwner () == _owner)
+	{
+		for (std::vector <Entry>::iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+		{
+			HGLOBAL h = Render (*it) ;
+
+			if (::SetClipboardData (it->format, h) == NULL)
+				::GlobalFree (h) ;
+		}
+	}
+}
+
+//------------------------------------------------------------
+// Frees the rendered data.  Must be called when the data 
+// changes.
+//------------------------------------------------------------
+
+void Win::Clipboard::Publisher::Invalidate ()
+{
+	for (std::vector <Entry>::iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+	{
+		if (it->rendered != NULL)
+		{
+			::GlobalFree (it->rendered) ;
+			it->rendered = NULL ;
+		}
+	}
+}
+
+//------------------------------------------------------------
+// Obtains the data of a format, rendering it only if it is not
+// already cached.
+//
+// Return value:  A global block for the clipboard.  The 
+//				  clipboard takes ownership of it.
+//
+// Parameters:
+//
+// Entry & entry -> The format.
+//------------------------------------------------------------
+
+HGLOBAL Win::Clipboard::Publisher::Render (Entry & entry)
+{
+	if (!_cache)
+		return entry.renderer->Render (entry.format) ;
+
+	if (entry.rendered == NULL)
+		entry.rendered = entry.renderer->Render (entry.format) ;
+
+	// The clipboard frees what it receives, so it gets a copy of the cache.
+	return Duplicate (entry.rendered) ;
+}
+
+//------------------------------------------------------------
+// Copies a global block.
+//
+// Return value:  The new global block.
+//
+// Parameters:
+//
+// const HGLOBAL h -> The global block to copy.
+//------------------------------------------------------------
+
+HGLOBAL Win::Clipboard::Publisher::Duplicate (const HGLOBAL h)
+{
+	SIZE_T  size = ::GlobalSize (h) ;
+	HGLOBAL copy = ::GlobalAlloc (GMEM_MOVEABLE, size) ;
+
+	if (copy == NULL)
+		throw Win::Exception (TEXT("Error, could not create a global handle for the clipboard.")) ;
+
+	void * src ;
+	void * dest ;
+
+	Win::Global::Lock lockSrc  (h, &src) ;
+	Win::Global::Lock lockDest (copy, &dest) ;
+
+	::CopyMemory (dest, src, size) ;
+
+	return copy ;
+}
\ No newline at end of file
@@ -9,9 +9,12 @@
 	#include "useunicode.h"
 	#include "win.h"
 	#include "winglobalhandle.h"
+	#include <vector>
 
 	namespace Win
 	{
+		class Canvas ;
+
 		namespace Clipboard
 		{
 			enum Format {Text = CF_TEXT, DDB = CF_BITMAP, DIB = CF_DIB} ;
@@ -163,9 +166,144 @@
 
 			inline bool IsFormatAvailable  (const Win::Clipboard::Format format)
 			{
-				::IsClipboardFormatAvailable (format) ;
+				return ::IsClipboardFormatAvailable (format) != 0 ;
 			}
 
+			//------------------------------------------------------------
+			// Registers a new clipboard format.  If the format was already
+			// registered, its value is returned.
+			//
+			// Return value:  The value identifying the format.
+			//
+			// Parameters:
+			//
+			// const std::tstring & name -> The name of the format.
+			//------------------------------------------------------------
+
+			inline UINT RegisterFormat (const std::tstring & name)
+			{
+				UINT format = ::RegisterClipboardFormat (name.c_str ()) ;
+
+				if (format == 0)
+					throw Win::Exception (TEXT("Error, could not register a clipboard format.")) ;
+
+				return format ;
+			}
+
+			//------------------------------------------------------------
+			// Chooses the first format of a list that is available on the
+			// clipboard.
+			//
+			// Return value:  The chosen format, 0 if the clipboard is empty
+			//				  or -1 if none of the formats is available.
+			//
+			// Parameters:
+			//
+			// const std::vector <UINT> & formats -> The formats in order of
+			//										 preference.
+			//------------------------------------------------------------
+
+			inline int GetPriorityFormat (const std::vector <UINT> & formats)
+			{
+				if (formats.empty ())
+					return -1 ;
+
+				return ::GetPriorityClipboardFormat (const_cast <UINT *> (&formats [0]), static_cast <int> (formats.size ())) ;
+			}
+
+			//------------------------------------------------------------
+			// Win::Clipboard::Renderer produces the data of a clipboard
+			// format only when an application asks for it.  Inherit from
+			// it and implement Render.
+			//------------------------------------------------------------
+
+			class Renderer
+			{
+			public:
+
+				virtual ~Renderer ()
+				{}
+
+				//------------------------------------------------------------
+				// Produces the data of a format.
+				//
+				// Return value:  A new moveable global block containing the
+				//				  data.  The caller owns it.
+				//
+				// Parameters:
+				//
+				// const UINT format -> The format that must be produced.
+				//------------------------------------------------------------
+
+				virtual Win::Global::Handle Render (const UINT format) = 0 ;
+			} ;
+
+			//------------------------------------------------------------
+			// Win::Clipboard::Publisher puts data on the clipboard with
+			// delayed rendering.  Publish only announces the formats, the
+			// data is produced by a Win::Clipboard::Renderer when an
+			// application pastes it.  The rendered data is kept, so
+			// publishing the same data again does not render it again.
+			//
+			// The publisher must live as long as its window owns the 
+			// clipboard.  The controller of the window must call
+			// RenderFormat, RenderAllFormats and Invalidate from 
+			// OnRenderFormat, OnRenderAllFormats and when the data changes.
+			// Only formats stored in global memory can be published.
+			//------------------------------------------------------------
+
+			class Publisher
+			{
+			public:
+
+				//------------------------------------------------------------
+				// Constructor.
+				//
+				// Parameters:
+				//
+				// const Win::Base owner -> The window that will own the 
+				//							clipboard.
+				// const bool cache      -> If true, the rendered data is kept
+				//							until Invalidate is called.
+				//------------------------------------------------------------
+
+				Publisher (const Win::Base owner, const bool cache = true)
+					: _owner (owner),
+					  _cache (cache)
+				{}
+
+				~Publisher () ;
+
+				void AddFormat (const UINT format, Win::Clipboard::Renderer * renderer) ;
+				void Publish () const ;
+				bool RenderFormat (const UINT format) ;
+				void RenderAllFormats () ;
+				void Invalidate () ;
+
+			private:
+
+				Publisher (const Publisher &) ;
+				Publisher & operator = (const Publisher &) ;
+
+				//------------------------------------------------------------
+				// A published format.
+				//------------------------------------------------------------
+
+				struct Entry
+				{
+					UINT                       format ;   // The format.
+					Win::Clipboard::Renderer * renderer ; // Produces the data.
+					HGLOBAL                    rendered ; // Cached data, NULL if not rendered.
+				} ;
+
+				HGLOBAL Render (Entry & entry) ;
+				static HGLOBAL Duplicate (const HGLOBAL h) ;
+
+				std::vector <Entry> _entries ; // The published formats.
+				Win::Base           _owner ;   // Owner of the clipboard.
+				bool                _cache ;   // Keep the rendered data.
+			} ;
+
 			//------------------------------------------------------------
 			// Win::Clipboard::TextClip is used to send/retrieve text
 			// to/from the clipboard. 
@@ -209,6 +347,7 @@
 				static void						Copy  (Win::Base & win, Win::Bitmap::DIBSection::Handle dib) ;
 				static void						Cut   (Win::Base & win, Win::Bitmap::DIBSection::StrongHandle dib) ;
 				static Win::Bitmap::DIBSection::StrongHandle Paste (Win::Base & win) ;
+				static void						Draw  (Win::Base & win, Win::Canvas & canvas, const int x, const int y) ;
 
 			} ;
 
@@ -67,6 +67,87 @@ std::tstring Win::ComboBoxHandle::GetListBoxText (const int index) const
 				return val;
 			}
 
+			//-------------------------------------------------------------------------
+			// Adds many strings at the end of the combo box (Unless CB_SORT is 
+			// specified.)  Redrawing is suspended and the storage of the combo box is
+			// allocated once for all the strings.
+			//
+			// Return value: The number of strings in the combo box.
+			//
+			// Parameters:
+			//
+			// const std::vector <std::tstring> & strs -> The strings to be added.
+			// const bool presort -> If true, the strings are sorted before being 
+			//						 added.  A combo box with CB_SORT then never 
+			//						 has to move its items to insert a string.
+			//-------------------------------------------------------------------------
+
+			int Win::ComboBoxHandle::AddStrings (const std::vector <std::tstring> & strs, const bool presort)
+			{
+				if (strs.empty ())
+					return GetCount () ;
+
+				std::vector <std::tstring> sorted ;
+				const std::vector <std::tstring> * src = &strs ;
+
+				if (presort)
+				{
+					sorted = strs ;
+					SortStrings (sorted) ;
+					src = &sorted ;
+				}
+
+				Win::dow::NoRedraw noRedraw (*this) ;
+				SetInitStorage (static_cast <int> (src->size ()), GetStringStorage (*src)) ;
+
+				for (std::vector <std::tstring>::const_iterator it = src->begin () ; it != src->end () ; ++it)
+				{
+					int val = SendMessage (CB_ADDSTRING, 0, reinterpret_cast <LPARAM> (it->c_str ())) ;
+
+					if (val == CB_ERR || val == CB_ERRSPACE)
+						throw Win::Exception (TEXT("Error, could not add a string to the combobox")) ;
+				}
+
+				return GetCount () ;
+			}
+
+			//-------------------------------------------------------------------------
+			// Inserts many strings at the specified index of a combo box.  Redrawing 
+			// is suspended and the storage of the combo box is allocated once for 
+			// all the strings.
+			//
+			// Return value: The index of the last string inserted.
+			//
+			// Parameters:
+			//
+			// const int index -> The position where the first string will be 
+			//					  inserted.  -1 to add the strings at the end.
+			// const std::vector <std::tstring> & strs -> The strings to be inserted.
+			//-------------------------------------------------------------------------
+
+			int Win::ComboBoxHandle::InsertStrings (const int index, const std::vector <std::tstring> & strs)
+			{
+				int val = index ;
+
+				if (strs.empty ())
+					return val ;
+
+				Win::dow::NoRedraw noRedraw (*this) ;
+				SetInitStorage (static_cast <int> (strs.size ()), GetStringStorage (strs)) ;
+
+				for (std::vector <std::tstring>::const_iterator it = strs.begin () ; it != strs.end () ; ++it)
+				{
+					val = SendMessage (CB_INSERTSTRING, index < 0 ? -1 : val, reinterpret_cast <LPARAM> (it->c_str ())) ;
+
+					if (val == CB_ERR || val == CB_ERRSPACE)
+						throw Win::Exception (TEXT("Error, could not insert a string to the combobox")) ;
+
+					++val ;
+				}
+
+				return val - 1 ;
+			}
+
 			//-------------------------------------------------------------------------
 			// Deletes the string at the specified index of a list box.
 			//
@@ -8,6 +8,7 @@
 	#include "useunicode.h"
 	#include "wincontrol.h"
 	#include "winunicodehelper.h"
+	#include <vector>
 
 	namespace Win
 	{
@@ -113,6 +114,8 @@
 
 			int AddString (const std::tstring str) ;
 			int InsertString (const int index, const std::tstring str) ;
+			int AddStrings (const std::vector <std::tstring> & strs, const bool presort = false) ;
+			int InsertStrings (const int index, const std::vector <std::tstring> & strs) ;
 
 			//-------------------------------------------------------------------------
 			// Replaces the string at the specified index of a list box.
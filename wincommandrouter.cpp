@@ -0,0 +1,120 @@
+#include "wincommandrouter.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// Removes all the handlers registered for an object.  Call it before
+// destroying an object that does not outlive the router.
+//
+// Parameters:
+//
+// const void * object -> The object whose handlers are removed.
+//-----------------------------------------------------------------
+
+void Win::CommandRouter::Remove (const void * object)
+{
+	std::vector <Entry>::iterator last = _entries.begin () ;
+
+	for (std::vector <Entry>::iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+	{
+		if (it->object != object)
+			*last++ = *it ;
+	}
+
+	_entries.erase (last, _entries.end ()) ;
+}
+
+//-----------------------------------------------------------------
+// Appends a registration.  The table is only sorted on the next
+// lookup, so registering many handlers at startup costs a single
+// sort instead of one insertion in the middle of the array each.
+//
+// Parameters:
+//
+// const Source source -> The message the handler is registered for.
+// const int id        -> Id of the command or control.
+// const int code      -> Notification code.
+// void * object       -> Object on which the handler is called.
+// Thunk thunk         -> Function calling the handler.
+//-----------------------------------------------------------------
+
+void Win::CommandRouter::Add (const Source source, const int id, const int code, void * object, Thunk thunk)
+{
+	Entry entry ;
+	entry.source = source ;
+	entry.id     = id ;
+	entry.code   = code ;
+	entry.object = object ;
+	entry.thunk  = thunk ;
+
+	_entries.push_back (entry) ;
+	_sorted = false ;
+}
+
+//-----------------------------------------------------------------
+// Finds the handler of a message with a binary search and calls it.
+//
+// Return value:  True if a handler processed the message, else false.
+//
+// Parameters:
+//
+// const Source source -> The message to route.
+// const int id        -> Id of the command or control.
+// const int code      -> Notification code.
+// NMHDR * hdr         -> Header of a WM_NOTIFY message, else NULL.
+//-----------------------------------------------------------------
+
+bool Win::CommandRouter::Route (const Source source, const int id, const int code, NMHDR * hdr) const
+{
+	Sort () ;
+
+	size_t low  = 0 ;
+	size_t high = _entries.size () ;
+
+	while (low < high)
+	{
+		size_t        mid   = low + (high - low) / 2 ;
+		const Entry & entry = _entries [mid] ;
+
+		if (entry.source != source ? entry.source < source : entry.id != id ? entry.id < id : entry.code < code)
+			low = mid + 1 ;
+		else
+			high = mid ;
+	}
+
+	if (low == _entries.size ())
+		return false ;
+
+	const Entry & found = _entries [low] ;
+
+	if (found.source != source || found.id != id || found.code != code)
+		return false ;
+
+	return found.thunk (found.object, hdr) ;
+}
+
+//-----------------------------------------------------------------
+// Sorts the table after registrations.  When a key was registered
+// more than once, only the last registration is kept.
+//-----------------------------------------------------------------
+
+void Win::CommandRouter::Sort () const
+{
+	if (_sorted)
+		return ;
+
+	std::stable_sort (_entries.begin (), _entries.end ()) ;
+
+	// Keeps the last entry of each run of equal keys.
+	std::vector <Entry>::iterator last = _entries.begin () ;
+
+	for (std::vector <Entry>::iterator it = _entries.begin () ; it != _entries.end () ; ++it)
+	{
+		std::vector <Entry>::iterator next = it + 1 ;
+
+		if (next == _entries.end () || *it < *next)
+			*last++ = *it ;
+	}
+
+	_entries.erase (last, _entries.end ()) ;
+	_sorted = true ;
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::CommandRouter.
+//-----------------------------------------------------------------
+
+#if !defined (WINCOMMANDROUTER_H)
+
+	#define WINCOMMANDROUTER_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include <commctrl.h>
+	#include <vector>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// A Win::CommandRouter object replaces the big switch statements
+		// usually found in OnCommand, OnControl and OnNotify.  Handlers are
+		// registered once for a command id, a control id and notification
+		// code, or a WM_NOTIFY id and code.  They are kept in a flat array
+		// sorted by key, so routing a message is a binary search followed
+		// by a call through a function pointer:  no map nodes, no virtual
+		// handler objects and no dynamic_cast.
+		//
+		// The method called is a template argument, so each registration
+		// instantiates a small thunk that calls it directly.  Example:
+		//
+		// _router.AddCommand <MainController, &MainController::OnOpen> (IDM_OPEN, *this) ;
+		// _router.AddControl <MainController, &MainController::OnOk> (IDOK, BN_CLICKED, *this) ;
+		//
+		// Both Win::BaseController and Win::Dialog::Controller own a router
+		// that their default OnCommand, OnControl and OnNotify consult.
+		//-----------------------------------------------------------------
+
+		class CommandRouter
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Constructor.  Creates an empty router.
+			//-----------------------------------------------------------------
+
+			CommandRouter ()
+				: _sorted (true)
+			{}
+
+			//-----------------------------------------------------------------
+			// Registers a handler for a menu item and for the accelerator
+			// sharing its id.  A handler already registered for the same id
+			// is replaced.
+			//
+			// Parameters:
+			//
+			// const int id -> Id of the menu item or accelerator.
+			// T & object   -> Object on which the method is called.  It must
+			//				   outlive the router or be removed with Remove.
+			//-----------------------------------------------------------------
+
+			template <class T, void (T::*Method) ()>
+			void AddCommand (const int id, T & object)
+			{
+				Add (FromMenu, id, 0, &object, &CallCommand <T, Method>) ;
+				Add (FromAccelerator, id, 0, &object, &CallCommand <T, Method>) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Registers a handler for an accelerator only.  Use it when the
+			// accelerator must not behave like the menu item with the same id.
+			//
+			// Parameters:
+			//
+			// const int id -> Id of the accelerator.
+			// T & object   -> Object on which the method is called.
+			//-----------------------------------------------------------------
+
+			template <class T, void (T::*Method) ()>
+			void AddAccelerator (const int id, T & object)
+			{
+				Add (FromAccelerator, id, 0, &object, &CallCommand <T, Method>) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Registers a handler for a notification sent by a control
+			// through WM_COMMAND, for example BN_CLICKED or EN_CHANGE.
+			//
+			// Parameters:
+			//
+			// const int id               -> Id of the control.
+			// const int notificationCode -> Notification code of the control.
+			// T & object                 -> Object on which the method is
+			//								 called.
+			//-----------------------------------------------------------------
+
+			template <class T, void (T::*Method) ()>
+			void AddControl (const int id, const int notificationCode, T & object)
+			{
+				Add (FromControl, id, notificationCode, &object, &CallCommand <T, Method>) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Registers a handler for a WM_NOTIFY notification.  The method
+			// receives the NMHDR of the message and returns true if it
+			// processed it.
+			//
+			// Parameters:
+			//
+			// const int id   -> Id of the control (NMHDR::idFrom).
+			// const int code -> Notification code (NMHDR::code).
+			// T & object     -> Object on which the method is called.
+			//-----------------------------------------------------------------
+
+			template <class T, bool (T::*Method) (NMHDR *)>
+			void AddNotify (const int id, const int code, T & object)
+			{
+				Add (FromNotify, id, code, &object, &CallNotify <T, Method>) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Routes a WM_COMMAND message sent by a menu or an accelerator.
+			//
+			// Return value:  True if a handler was called, else false.
+			//
+			// Parameters:
+			//
+			// const int id             -> Id of the menu item or accelerator.
+			// const bool isAccelerator -> True if the message comes from an
+			//							   accelerator.
+			//-----------------------------------------------------------------
+
+			bool RouteCommand (const int id, const bool isAccelerator) const
+			{
+				return Route (isAccelerator ? FromAccelerator : FromMenu, id, 0, NULL) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Routes a WM_COMMAND message sent by a control.
+			//
+			// Return value:  True if a handler was called, else false.
+			//
+			// Parameters:
+			//
+			// const int id               -> Id of the control.
+			// const int notificationCode -> Notification code of the control.
+			//-----------------------------------------------------------------
+
+			bool RouteControl (const int id, const int notificationCode) const
+			{
+				return Route (FromControl, id, notificationCode, NULL) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Routes a WM_NOTIFY message.
+			//
+			// Return value:  True if a handler processed the notification,
+			//				  else false.
+			//
+			// Parameters:
+			//
+			// NMHDR * hdr -> The header of the notification.
+			//-----------------------------------------------------------------
+
+			bool RouteNotify (NMHDR * hdr) const
+			{
+				return hdr != NULL && Route (FromNotify, static_cast <int> (hdr->idFrom), static_cast <int> (hdr->code), hdr) ;
+			}
+
+			void Remove (const void * object) ;
+
+			//-----------------------------------------------------------------
+			// Removes all the handlers.
+			//-----------------------------------------------------------------
+
+			void Clear ()
+			{
+				_entries.clear () ;
+				_sorted = true ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the number of registrations.  A handler added with
+			// AddCommand counts twice, once for the menu and once for the
+			// accelerator.
+			//
+			// Return value:  The number of registrations.
+			//-----------------------------------------------------------------
+
+			int GetCount () const
+			{
+				Sort () ;
+				return static_cast <int> (_entries.size ()) ;
+			}
+
+		private:
+
+			//-----------------------------------------------------------------
+			// The message a handler is registered for.  Menus and controls
+			// are kept apart because BN_CLICKED and the menu code are both 0.
+			//-----------------------------------------------------------------
+
+			enum Source
+			{
+				FromMenu,
+				FromAccelerator,
+				FromControl,
+				FromNotify
+			} ;
+
+			typedef bool (*Thunk) (void * object, NMHDR * hdr) ;
+
+			//-----------------------------------------------------------------
+			// An entry of the table:  the key and the handler to call.
+			//-----------------------------------------------------------------
+
+			struct Entry
+			{
+				int    source ;
+				int    id ;
+				int    code ;
+				void * object ;
+				Thunk  thunk ;
+
+				bool operator < (const Entry & entry) const
+				{
+					if (source != entry.source)
+						return source < entry.source ;
+
+					if (id != entry.id)
+						return id < entry.id ;
+
+					return code < entry.code ;
+				}
+			} ;
+
+			//-----------------------------------------------------------------
+			// Calls a command handler.
+			//
+			// Return value:  Always true.
+			//-----------------------------------------------------------------
+
+			template <class T, void (T::*Method) ()>
+			static bool CallCommand (void * object, NMHDR *)
+			{
+				(static_cast <T *> (object)->*Method) () ;
+				return true ;
+			}
+
+			//-----------------------------------------------------------------
+			// Calls a WM_NOTIFY handler.
+			//
+			// Return value:  The value returned by the handler.
+			//-----------------------------------------------------------------
+
+			template <class T, bool (T::*Method) (NMHDR *)>
+			static bool CallNotify (void * object, NMHDR * hdr)
+			{
+				return (static_cast <T *> (object)->*Method) (hdr) ;
+			}
+
+			void Add (const Source source, const int id, const int code, void * object, Thunk thunk) ;
+			bool Route (const Source source, const int id, const int code, NMHDR * hdr) const ;
+			void Sort () const ;
+
+			mutable std::vector <Entry> _entries ; // Sorted by key once _sorted is true.
+			mutable bool                _sorted ;  // False after a registration, until the next lookup.
+		} ;
+	}
+
+#endif
\ No newline at end of file
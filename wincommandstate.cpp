@@ -0,0 +1,422 @@
+#include "wincommandstate.h"
+#include "winexception.h"
+
+//-----------------------------------------------------------------
+// Removes a command and its bindings.  The user interface is left
+// as it is.  The command keeps its slot and the states it depends
+// on:  registering the id again reuses them.
+//
+// Parameters:
+//
+// const int id -> Id of the command.
+//-----------------------------------------------------------------
+
+void Win::CommandState::Remove (const int id)
+{
+	std::map <int, int>::iterator it = _index.find (id) ;
+
+	if (it == _index.end ())
+		return ;
+
+	Command & command = _commands [it->second] ;
+	command.object = NULL ;
+	command.query  = NULL ;
+	command.flags  = Unknown ;
+	command.bindings.clear () ;
+}
+
+//-----------------------------------------------------------------
+// Removes all the commands and states.
+//-----------------------------------------------------------------
+
+void Win::CommandState::Clear ()
+{
+	_commands.clear () ;
+	_index.clear () ;
+	_states.clear () ;
+	_dirty.clear () ;
+}
+
+//-----------------------------------------------------------------
+// Declares that a command depends on a state:  invalidating the
+// state marks the command dirty.
+//
+// Parameters:
+//
+// const int id    -> Id of a registered command.
+// const int state -> The state.
+//-----------------------------------------------------------------
+
+void Win::CommandState::DependsOn (const int id, const int state)
+{
+	int index = FindCommand (id) ;
+
+	if (index == Unknown)
+		throw Win::Exception (TEXT("Error, the command is not registered")) ;
+
+	_states [state].commands.push_back (index) ;
+}
+
+//-----------------------------------------------------------------
+// Declares that a state is derived from another one:  invalidating
+// the source also invalidates the state and everything depending
+// on it.  Cycles are allowed.
+//
+// Parameters:
+//
+// const int state  -> The derived state.
+// const int source -> The state it is derived from.
+//-----------------------------------------------------------------
+
+void Win::CommandState::StateDependsOn (const int state, const int source)
+{
+	_states [state] ;
+	_states [source].states.push_back (state) ;
+}
+
+//-----------------------------------------------------------------
+// Shows the state of a command in a menu item having the same id.
+//
+// Parameters:
+//
+// const int id                   -> Id of the command.
+// const Win::Menu::Handle menu   -> Menu containing the item, at any
+//									 depth.
+//-----------------------------------------------------------------
+
+void Win::CommandState::BindMenu (const int id, const Win::Menu::Handle menu)
+{
+	Binding binding ;
+	binding.type = MenuItem ;
+	binding.menu = menu ;
+	binding.win  = NULL ;
+
+	AddBinding (id, binding) ;
+}
+
+//-----------------------------------------------------------------
+// Shows the state of a command in a button.  Push buttons are
+// enabled and disabled, check boxes and radio buttons are also
+// checked and unchecked.
+//
+// Parameters:
+//
+// const int id                          -> Id of the command.
+// const Win::PushButtonHandle button    -> The button.
+//-----------------------------------------------------------------
+
+void Win::CommandState::BindButton (const int id, const Win::PushButtonHandle button)
+{
+	Binding binding ;
+	binding.type = Button ;
+	binding.menu = NULL ;
+	binding.win  = button ;
+
+	AddBinding (id, binding) ;
+}
+
+//-----------------------------------------------------------------
+// Shows the state of a command in the toolbar button having the same
+// id.
+//
+// Parameters:
+//
+// const int id                    -> Id of the command.
+// const Win::dow::Handle toolBar  -> The toolbar control.
+//-----------------------------------------------------------------
+
+void Win::CommandState::BindToolBar (const int id, const Win::dow::Handle toolBar)
+{
+	Binding binding ;
+	binding.type = ToolBarButton ;
+	binding.menu = NULL ;
+	binding.win  = toolBar ;
+
+	AddBinding (id, binding) ;
+}
+
+//-----------------------------------------------------------------
+// Marks dirty all the commands depending on a state, directly or
+// through derived states.  Each state is visited once per call.
+//
+// Parameters:
+//
+// const int state -> The state that changed.
+//-----------------------------------------------------------------
+
+void Win::CommandState::Invalidate (const int state)
+{
+	std::map <int, State>::iterator start = _states.find (state) ;
+
+	if (start == _states.end ())
+		return ;
+
+	++_mark ;
+	start->second.mark = _mark ;
+
+	std::vector <State *> pending ;
+	pending.push_back (&start->second) ;
+
+	while (!pending.empty ())
+	{
+		State * current = pending.back () ;
+		pending.pop_back () ;
+
+		for (size_t i = 0 ; i < current->commands.size () ; ++i)
+			MarkDirty (current->commands [i]) ;
+
+		for (size_t i = 0 ; i < current->states.size () ; ++i)
+		{
+			State & next = _states [current->states [i]] ;
+
+			if (next.mark != _mark)
+			{
+				next.mark = _mark ;
+				pending.push_back (&next) ;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// Marks a single command dirty.
+//
+// Parameters:
+//
+// const int id -> Id of the command.
+//-----------------------------------------------------------------
+
+void Win::CommandState::InvalidateCommand (const int id)
+{
+	int index = FindCommand (id) ;
+
+	if (index != Unknown)
+		MarkDirty (index) ;
+}
+
+//-----------------------------------------------------------------
+// Marks all the commands dirty.
+//-----------------------------------------------------------------
+
+void Win::CommandState::InvalidateAll ()
+{
+	for (size_t i = 0 ; i < _commands.size () ; ++i)
+		MarkDirty (static_cast <int> (i)) ;
+}
+
+//-----------------------------------------------------------------
+// Queries a batch of dirty commands, oldest first, and updates the
+// user interface of those whose flags changed.
+//
+// Return value:  True if dirty commands remain, else false.
+//
+// Parameters:
+//
+// const int maxCommands -> Maximum number of commands to query.
+//-----------------------------------------------------------------
+
+bool Win::CommandState::Update (const int maxCommands)
+{
+	for (int n = 0 ; n < maxCommands && !_dirty.empty () ; ++n)
+	{
+		Command & command = _commands [_dirty.front ()] ;
+		_dirty.pop_front () ;
+		command.dirty = false ;
+
+		// Removed command.
+		if (command.query == NULL)
+			continue ;
+
+		int flags = command.query (command.object, command.id) ;
+
+		if (flags != command.flags)
+		{
+			command.flags = flags ;
+			Apply (command, flags) ;
+		}
+	}
+
+	return !_dirty.empty () ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the flags last shown for a command.
+//
+// Return value:  A combination of Enabled and Checked, or -1 if the
+//				  command was never updated.
+//
+// Parameters:
+//
+// const int id -> Id of the command.
+//-----------------------------------------------------------------
+
+int Win::CommandState::GetFlags (const int id) const
+{
+	int index = FindCommand (id) ;
+
+	if (index == Unknown)
+		throw Win::Exception (TEXT("Error, the command is not registered")) ;
+
+	return _commands [index].flags ;
+}
+
+//-----------------------------------------------------------------
+// Registers a command or replaces the query of an existing one.  A
+// removed command gets its slot back, so the states it depended on
+// still reach it.
+//
+// Parameters:
+//
+// const int id   -> Id of the command.
+// void * object  -> Object on which the query is called.
+// Query query    -> Function calling the query method.
+//-----------------------------------------------------------------
+
+void Win::CommandState::Add (const int id, void * object, Query query)
+{
+	std::map <int, int>::const_iterator it = _index.find (id) ;
+	int index ;
+
+	if (it == _index.end ())
+	{
+		Command command ;
+		command.id     = id ;
+		command.object = object ;
+		command.query  = query ;
+		command.flags  = Unknown ;
+		command.dirty  = false ;
+
+		index = static_cast <int> (_commands.size ()) ;
+		_commands.push_back (command) ;
+		_index [id] = index ;
+	}
+	else
+	{
+		index = it->second ;
+		_commands [index].object = object ;
+		_commands [index].query  = query ;
+	}
+
+	MarkDirty (index) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a binding to a command.  The flags of the command are
+// forgotten so the new element is updated on the next Update.
+//
+// Parameters:
+//
+// const int id              -> Id of the command.
+// const Binding & binding   -> The user interface element.
+//-----------------------------------------------------------------
+
+void Win::CommandState::AddBinding (const int id, const Binding & binding)
+{
+	Command & command = GetCommand (id) ;
+	command.bindings.push_back (binding) ;
+	command.flags = Unknown ;
+
+	MarkDirty (_index [id]) ;
+}
+
+//-----------------------------------------------------------------
+// Finds a registered command.
+//
+// Return value:  The index of the command in _commands, or Unknown
+//				  if it was never registered or was removed.
+//
+// Parameters:
+//
+// const int id -> Id of the command.
+//-----------------------------------------------------------------
+
+int Win::CommandState::FindCommand (const int id) const
+{
+	std::map <int, int>::const_iterator it = _index.find (id) ;
+
+	if (it == _index.end () || _commands [it->second].query == NULL)
+		return Unknown ;
+
+	return it->second ;
+}
+
+//-----------------------------------------------------------------
+// Obtains a registered command.
+//
+// Return value:  The command.
+//
+// Parameters:
+//
+// const int id -> Id of the command.
+//-----------------------------------------------------------------
+
+Win::CommandState::Command & Win::CommandState::GetCommand (const int id)
+{
+	int index = FindCommand (id) ;
+
+	if (index == Unknown)
+		throw Win::Exception (TEXT("Error, the command is not registered")) ;
+
+	return _commands [index] ;
+}
+
+//-----------------------------------------------------------------
+// Queues a command for the next Update unless it is already queued.
+//
+// Parameters:
+//
+// const int index -> Index of the command in _commands.
+//-----------------------------------------------------------------
+
+void Win::CommandState::MarkDirty (const int index)
+{
+	Command & command = _commands [index] ;
+
+	if (!command.dirty)
+	{
+		command.dirty = true ;
+		_dirty.push_back (index) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Shows new flags in all the elements bound to a command.  Errors
+// are ignored:  a menu item or a window may have been destroyed
+// since it was bound, and Update runs from the message loop.
+//
+// Parameters:
+//
+// const Command & command -> The command.
+// const int flags         -> Its new flags.
+//-----------------------------------------------------------------
+
+void Win::CommandState::Apply (const Command & command, const int flags)
+{
+	bool enabled = (flags & Enabled) != 0 ;
+	bool checked = (flags & Checked) != 0 ;
+
+	for (size_t i = 0 ; i < command.bindings.size () ; ++i)
+	{
+		const Binding & binding = command.bindings [i] ;
+
+		switch (binding.type)
+		{
+		case MenuItem:
+			::EnableMenuItem (binding.menu, command.id, MF_BYCOMMAND | (enabled ? MF_ENABLED : MF_GRAYED)) ;
+			::CheckMenuItem (binding.menu, command.id, MF_BYCOMMAND | (checked ? MF_CHECKED : MF_UNCHECKED)) ;
+			break ;
+
+		case Button:
+			::EnableWindow (binding.win, enabled ? TRUE : FALSE) ;
+
+			// Push buttons ignore BM_SETCHECK.
+			::SendMessage (binding.win, BM_SETCHECK, checked ? BST_CHECKED : BST_UNCHECKED, 0) ;
+			break ;
+
+		case ToolBarButton:
+			::SendMessage (binding.win, TB_ENABLEBUTTON, command.id, MAKELONG (enabled ? TRUE : FALSE, 0)) ;
+			::SendMessage (binding.win, TB_CHECKBUTTON, command.id, MAKELONG (checked ? TRUE : FALSE, 0)) ;
+			break ;
+		}
+	}
+}
\ No newline at end of file
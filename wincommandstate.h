@@ -0,0 +1,203 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::CommandState.
+//-----------------------------------------------------------------
+
+#if !defined (WINCOMMANDSTATE_H)
+
+	#define WINCOMMANDSTATE_H
+	#include "useunicode.h"
+	#include "winmenu.h"
+	#include "winbutton.h"
+	#include <windows.h>
+	#include <commctrl.h>
+	#include <limits.h>
+	#include <vector>
+	#include <deque>
+	#include <map>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// A Win::CommandState object keeps the menu items, toolbar buttons
+		// and push buttons of the commands enabled and checked without
+		// polling the application on every WM_INITMENUPOPUP or idle tick.
+		//
+		// Each command has a query method that computes its flags and
+		// declares the application states it depends on.  States are
+		// plain integers chosen by the application, and a state may depend
+		// on other states.  When a state changes, the application calls
+		// Invalidate and the commands depending on it, directly or through
+		// other states, are marked dirty.  Update then queries a batch of
+		// dirty commands and touches the user interface only for those
+		// whose flags actually changed.  Win::MessagePump calls Update
+		// when the message queue is empty once SetCommandState was called.
+		//-----------------------------------------------------------------
+
+		class CommandState
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// The flags returned by the query methods.
+			//-----------------------------------------------------------------
+
+			enum Flags
+			{
+				Disabled = 0,
+				Enabled  = 1,
+				Checked  = 2
+			} ;
+
+			enum { DefaultBatch = 32 } ;
+
+			//-----------------------------------------------------------------
+			// Constructor.  Creates an engine without any command.
+			//-----------------------------------------------------------------
+
+			CommandState ()
+				: _mark (0)
+			{}
+
+			//-----------------------------------------------------------------
+			// Registers a command.  The query method receives the id of the
+			// command and returns a combination of Enabled and Checked, so a
+			// single method can serve many commands.  The command starts
+			// dirty.  Registering an id again replaces its query.  A removed
+			// id registered again keeps the states it depended on.
+			//
+			// Parameters:
+			//
+			// const int id -> Id of the command.
+			// T & object   -> Object on which the query method is called.
+			//-----------------------------------------------------------------
+
+			template <class T, int (T::*Method) (const int id)>
+			void AddCommand (const int id, T & object)
+			{
+				Add (id, &object, &CallQuery <T, Method>) ;
+			}
+
+			void Remove (const int id) ;
+			void Clear () ;
+
+			void DependsOn (const int id, const int state) ;
+			void StateDependsOn (const int state, const int source) ;
+
+			void BindMenu (const int id, const Win::Menu::Handle menu) ;
+			void BindButton (const int id, const Win::PushButtonHandle button) ;
+			void BindToolBar (const int id, const Win::dow::Handle toolBar) ;
+
+			void Invalidate (const int state) ;
+			void InvalidateCommand (const int id) ;
+			void InvalidateAll () ;
+
+			bool Update (const int maxCommands = DefaultBatch) ;
+
+			//-----------------------------------------------------------------
+			// Updates all the dirty commands at once.  Call it on
+			// WM_INITMENUPOPUP so a menu is never shown with stale items.
+			//-----------------------------------------------------------------
+
+			void Flush ()
+			{
+				while (Update (INT_MAX))
+				{}
+			}
+
+			//-----------------------------------------------------------------
+			// Determines if some commands are waiting for an update.
+			//
+			// Return value:  True if at least one command is dirty.
+			//-----------------------------------------------------------------
+
+			bool IsDirty () const
+			{
+				return !_dirty.empty () ;
+			}
+
+			int GetFlags (const int id) const ;
+
+		private:
+
+			CommandState (const CommandState &) ;
+			CommandState & operator = (const CommandState &) ;
+
+			enum { Unknown = -1 } ;
+
+			typedef int (*Query) (void * object, const int id) ;
+
+			//-----------------------------------------------------------------
+			// A user interface element showing the state of a command.
+			//-----------------------------------------------------------------
+
+			enum BindingType
+			{
+				MenuItem,
+				Button,
+				ToolBarButton
+			} ;
+
+			struct Binding
+			{
+				BindingType type ;
+				HMENU       menu ;
+				HWND        win ;
+			} ;
+
+			//-----------------------------------------------------------------
+			// A registered command.  Removed commands keep their slot with a
+			// NULL query so the indexes stored in the graph stay valid, and
+			// the slot is reused if the id is registered again.
+			//-----------------------------------------------------------------
+
+			struct Command
+			{
+				int                    id ;
+				void *                 object ;
+				Query                  query ;
+				int                    flags ;    // Last flags shown, or Unknown.
+				bool                   dirty ;    // True while in the dirty queue.
+				std::vector <Binding>  bindings ;
+			} ;
+
+			//-----------------------------------------------------------------
+			// A state:  the commands and the states that depend on it.
+			//-----------------------------------------------------------------
+
+			struct State
+			{
+				State ()
+					: mark (0)
+				{}
+
+				std::vector <int> commands ;
+				std::vector <int> states ;
+				unsigned int      mark ;      // Last propagation that reached the state.
+			} ;
+
+			//-----------------------------------------------------------------
+			// Calls a query method.
+			//-----------------------------------------------------------------
+
+			template <class T, int (T::*Method) (const int id)>
+			static int CallQuery (void * object, const int id)
+			{
+				return (static_cast <T *> (object)->*Method) (id) ;
+			}
+
+			void Add (const int id, void * object, Query query) ;
+			void AddBinding (const int id, const Binding & binding) ;
+			int FindCommand (const int id) const ;
+			Command & GetCommand (const int id) ;
+			void MarkDirty (const int index) ;
+			static void Apply (const Command & command, const int flags) ;
+
+			std::vector <Command>   _commands ; // Commands, in registration order.
+			std::map <int, int>     _index ;    // Command id -> index in _commands, removed ones included.
+			std::map <int, State>   _states ;   // State id -> dependents.
+			std::deque <int>        _dirty ;    // Indexes of the dirty commands, oldest first.
+			unsigned int            _mark ;     // Counter of the propagations.
+		} ;
+	}
+
+#endif
\ No newline at end of file
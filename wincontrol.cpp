@@ -1,4 +1,5 @@
 #include "wincontrol.h"
+#include <algorithm>
 
 //------------------------------------------------------
 //Obtain the text of a control as an Integer.
@@ -36,4 +37,52 @@ unsigned int Win::SimpleControlHandle::GetUnsignedInteger () const
 		throw Win::Exception (TEXT("Error, could not obtaint a unsigned integer from a control")) ;
 		
 	return val ;
+}
+
+//------------------------------------------------------
+// Compares two strings without regard to case, the same
+// way a sorted list box or combo box does.
+//------------------------------------------------------
+
+static bool LessNoCase (const std::tstring & first, const std::tstring & second)
+{
+	return ::lstrcmpi (first.c_str (), second.c_str ()) < 0 ;
+}
+
+//------------------------------------------------------
+// Computes the memory needed by a control to store a
+// group of strings.  Used to pre-allocate the storage of
+// list boxes and combo boxes before a bulk insertion.
+//
+// Return value:  The size in bytes, null characters included.
+//
+// Parameters:
+//
+// const std::vector <std::tstring> & strs -> The strings.
+//------------------------------------------------------
+
+int Win::SimpleControlHandle::GetStringStorage (const std::vector <std::tstring> & strs)
+{
+	size_t size = 0 ;
+
+	for (std::vector <std::tstring>::const_iterator it = strs.begin () ; it != strs.end () ; ++it)
+		size += (it->length () + 1) * sizeof (TCHAR) ;
+
+	return static_cast <int> (size) ;
+}
+
+//------------------------------------------------------
+// Sorts a group of strings in the order used by sorted
+// list boxes and combo boxes.  Strings added in that order
+// always go at the end of the control, so it never has to
+// move its items around.
+//
+// Parameters:
+//
+// std::vector <std::tstring> & strs -> The strings to sort.
+//------------------------------------------------------
+
+void Win::SimpleControlHandle::SortStrings (std::vector <std::tstring> & strs)
+{
+	std::stable_sort (strs.begin (), strs.end (), LessNoCase) ;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 	#include "useunicode.h"
 	#include "wincreator.h"
 	#include  "winunicodehelper.h"
+	#include <vector>
 	namespace Win
 	{
 
@@ -101,6 +102,10 @@
 				}
 
 			protected:
+
+				static int GetStringStorage (const std::vector <std::tstring> & strs) ;
+				static void SortStrings (std::vector <std::tstring> & strs) ;
+
 				int _id ; // Id of the control.
 
 			} ;
@@ -14,9 +14,14 @@
 
 bool Win::BaseController::OnControl (Win::dow::Handle & control, const int id, const int notificationCode)
 {
-	
+	if (_router.RouteControl (id, notificationCode))
+		return true ;
+
 	std::map <HWND, ControlEventHandler *>::iterator iter = _ctrlMap.find (control);
-	assert(iter != _ctrlMap.end ());
+
+	if (iter == _ctrlMap.end ())
+		return false ;
+
 	ControlEventHandler * ctrlHandler = iter->second;
 
 	switch (notificationCode)
@@ -10,6 +10,7 @@
 	#include "wincontroller.h"
 	#include "winupcast.h"
 	#include "winunicodehelper.h"
+	#include "winstyle.h"
 
 	namespace Win
 	{
@@ -476,6 +477,18 @@
 				_styleEX = style ;
 			}
 
+			//-----------------------------------------------------------
+			// Sets the style and the extended style from a
+			// Win::Style::Descriptor built at compile time.
+			//-----------------------------------------------------------
+
+			template <class Descriptor>
+			void SetStyles ()
+			{
+				_style   = Descriptor::WindowStyle ;
+				_styleEX = Descriptor::ExtendedStyle ;
+			}
+
 		protected:
 
 			BaseCreator (const std::tstring className, const HINSTANCE hInst) ;
@@ -806,6 +819,19 @@
 				_mdiCreate.style |= WS_VSCROLL ;
 			}
 
+			//----------------------------------------------------------------------
+			// Sets the style from a Win::Style::Descriptor built at compile
+			// time.  A MDI child window can not have an extended style, the
+			// descriptor must not have one.
+			//----------------------------------------------------------------------
+
+			template <class Descriptor>
+			void SetStyles ()
+			{
+				enum { NoExtendedStyle = sizeof (Win::Style::CompileTimeCheck <Descriptor::ExtendedStyle == 0>) } ;
+				_mdiCreate.style = Descriptor::WindowStyle ;
+			}
+
 			Win::MDIChild::Handle Create (StrongPointer <Win::MDIChild::Controller> & ctrl, const std::tstring title) ;
 
 			protected:
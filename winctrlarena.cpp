@@ -0,0 +1,466 @@
+#include "winctrlarena.h"
+#include <new>
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	// Arena of the current thread.
+	__declspec (thread) Win::ControllerArena * s_current = NULL ;
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Creates an empty map of 16 slots.
+//-----------------------------------------------------------------
+
+Win::ControllerMap::ControllerMap ()
+	: _count (0),
+	  _used (0)
+{
+	Slot empty = {NULL, NULL} ;
+	_slots.resize (16, empty) ;
+	ResetStats () ;
+}
+
+//-----------------------------------------------------------------
+// Associates a window with its controller.  Replaces the controller
+// if the window is already in the map.
+//
+// Parameters:
+//
+// const HWND hwnd -> Handle of the window.
+// void * ctrl     -> The controller of the window.
+//-----------------------------------------------------------------
+
+void Win::ControllerMap::Insert (const HWND hwnd, void * ctrl)
+{
+	assert (hwnd != NULL && hwnd != Tombstone ()) ;
+
+	if ((_used + 1) * 4 > static_cast <int> (_slots.size ()) * 3)
+		Grow () ;
+
+	size_t mask  = _slots.size () - 1 ;
+	size_t index = Hash (hwnd) & mask ;
+	size_t reuse = _slots.size () ;
+
+	while (_slots [index].key != NULL)
+	{
+		if (_slots [index].key == hwnd)
+		{
+			_slots [index].value = ctrl ;
+			return ;
+		}
+
+		if (_slots [index].key == Tombstone () && reuse == _slots.size ())
+			reuse = index ;
+
+		index = (index + 1) & mask ;
+	}
+
+	// The first tombstone met can be reused since the window is not
+	// further in the chain.
+	if (reuse != _slots.size ())
+		index = reuse ;
+	else
+		++_used ;
+
+	_slots [index].key   = hwnd ;
+	_slots [index].value = ctrl ;
+	++_count ;
+}
+
+//-----------------------------------------------------------------
+// Finds the controller of a window.
+//
+// Return value:  The controller or NULL if the window is not in the
+//				  map.
+//
+// Parameters:
+//
+// const HWND hwnd -> Handle of the window.
+//-----------------------------------------------------------------
+
+void * Win::ControllerMap::Find (const HWND hwnd) const
+{
+	size_t mask  = _slots.size () - 1 ;
+	size_t index = Hash (hwnd) & mask ;
+
+	++_stats.lookups ;
+
+	for (;;)
+	{
+		const Slot & slot = _slots [index] ;
+		++_stats.probes ;
+
+		if (slot.key == hwnd)
+		{
+			++_stats.hits ;
+			return slot.value ;
+		}
+
+		if (slot.key == NULL)
+			return NULL ;
+
+		index = (index + 1) & mask ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Removes a window from the map.
+//
+// Return value:  True if the window was in the map.
+//
+// Parameters:
+//
+// const HWND hwnd -> Handle of the window.
+//-----------------------------------------------------------------
+
+bool Win::ControllerMap::Remove (const HWND hwnd)
+{
+	size_t mask  = _slots.size () - 1 ;
+	size_t index = Hash (hwnd) & mask ;
+
+	while (_slots [index].key != NULL)
+	{
+		if (_slots [index].key == hwnd)
+		{
+			// The slot can be emptied when the next one is empty, no
+			// lookup goes through it.
+			if (_slots [(index + 1) & mask].key == NULL)
+			{
+				_slots [index].key = NULL ;
+				--_used ;
+			}
+			else
+				_slots [index].key = Tombstone () ;
+
+			_slots [index].value = NULL ;
+			--_count ;
+			return true ;
+		}
+
+		index = (index + 1) & mask ;
+	}
+
+	return false ;
+}
+
+//-----------------------------------------------------------------
+// Removes all the windows from the map.
+//-----------------------------------------------------------------
+
+void Win::ControllerMap::Clear ()
+{
+	Slot empty = {NULL, NULL} ;
+	std::fill (_slots.begin (), _slots.end (), empty) ;
+	_count = 0 ;
+	_used  = 0 ;
+}
+
+//-----------------------------------------------------------------
+// Rebuilds the table without the tombstones, doubling its size if
+// more than half of the slots hold windows.
+//-----------------------------------------------------------------
+
+void Win::ControllerMap::Grow ()
+{
+	size_t size = _slots.size () ;
+
+	if (_count * 2 >= static_cast <int> (size))
+		size *= 2 ;
+
+	std::vector <Slot> old (size) ;
+	old.swap (_slots) ;
+
+	Slot empty = {NULL, NULL} ;
+	std::fill (_slots.begin (), _slots.end (), empty) ;
+
+	size_t mask = size - 1 ;
+
+	for (std::vector <Slot>::const_iterator it = old.begin () ; it != old.end () ; ++it)
+	{
+		if (it->key == NULL || it->key == Tombstone ())
+			continue ;
+
+		size_t index = Hash (it->key) & mask ;
+
+		while (_slots [index].key != NULL)
+			index = (index + 1) & mask ;
+
+		_slots [index] = *it ;
+	}
+
+	_used = _count ;
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Makes the arena the current one of the calling
+// thread.  The previous one is restored by the destructor.
+//-----------------------------------------------------------------
+
+Win::ControllerArena::ControllerArena ()
+	: _previous (s_current),
+	  _threadId (::GetCurrentThreadId ()),
+	  _registry (new SlabRegistry)
+{
+	_registry->arena      = this ;
+	_registry->liveBlocks = 0 ;
+
+	for (int i = 0 ; i < ClassCount ; ++i)
+	{
+		_free [i] = NULL ;
+		_next [i] = NULL ;
+		_end  [i] = NULL ;
+	}
+
+	_stats.slabAllocations = 0 ;
+	_stats.heapAllocations = 0 ;
+	_stats.liveBlocks      = 0 ;
+	_stats.reservedBytes   = 0 ;
+
+	s_current = this ;
+}
+
+//-----------------------------------------------------------------
+// Destructor.  Releases the slabs.  If some controllers still live,
+// their blocks are orphaned:  the slabs are released by Free when
+// the last of them is deleted.
+//-----------------------------------------------------------------
+
+Win::ControllerArena::~ControllerArena ()
+{
+	// Nested arenas must be destroyed in the reverse order of their
+	// creation, so that the chain walked by Unregister stays valid.
+	assert (_threadId == ::GetCurrentThreadId ()) ;
+	assert (s_current == this) ;
+
+	s_current = _previous ;
+
+	if (_registry->liveBlocks != 0)
+		_registry->arena = NULL ;
+	else
+		FreeSlabs (_registry) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the arena of the calling thread.
+//
+// Return value:  The arena or NULL if the thread does not have one.
+//-----------------------------------------------------------------
+
+Win::ControllerArena * Win::ControllerArena::GetCurrent ()
+{
+	return s_current ;
+}
+
+//-----------------------------------------------------------------
+// Allocates the memory of a controller.  Used by the operator new
+// of Win::BaseController.  The memory comes from the arena of the
+// calling thread if it has one and the controller is not too large,
+// else from the heap.
+//
+// Return value:  The memory of the controller.
+//
+// Parameters:
+//
+// const size_t size -> Size of the controller.
+//-----------------------------------------------------------------
+
+void * Win::ControllerArena::Allocate (const size_t size)
+{
+	ControllerArena * arena     = s_current ;
+	int               sizeClass = arena != NULL ? GetSizeClass (size + sizeof (Header)) : NoClass ;
+	Header *          header ;
+
+	if (sizeClass != NoClass)
+	{
+		header = static_cast <Header *> (arena->AllocateBlock (sizeClass)) ;
+		++arena->_stats.slabAllocations ;
+		++arena->_stats.liveBlocks ;
+		++arena->_registry->liveBlocks ;
+		header->info.registry = arena->_registry ;
+	}
+	else
+	{
+		header = static_cast <Header *> (::operator new (size + sizeof (Header))) ;
+
+		if (arena != NULL)
+			++arena->_stats.heapAllocations ;
+
+		header->info.registry = NULL ;
+	}
+
+	header->info.sizeClass = sizeClass ;
+	return header + 1 ;
+}
+
+//-----------------------------------------------------------------
+// Frees the memory of a controller allocated by Allocate.  Used by
+// the operator delete of Win::BaseController.
+//
+// Parameters:
+//
+// void * p -> The memory of the controller, can be NULL.
+//-----------------------------------------------------------------
+
+void Win::ControllerArena::Free (void * p)
+{
+	if (p == NULL)
+		return ;
+
+	Header *       header   = static_cast <Header *> (p) - 1 ;
+	SlabRegistry * registry = header->info.registry ;
+
+	if (registry == NULL)
+	{
+		::operator delete (header) ;
+		return ;
+	}
+
+	--registry->liveBlocks ;
+
+	ControllerArena * arena = registry->arena ;
+
+	// The arena is gone, the slabs go with its last block.
+	if (arena == NULL)
+	{
+		if (registry->liveBlocks == 0)
+			FreeSlabs (registry) ;
+
+		return ;
+	}
+
+	assert (arena->_threadId == ::GetCurrentThreadId ()) ;
+
+	arena->ReleaseBlock (header, header->info.sizeClass) ;
+	--arena->_stats.liveBlocks ;
+}
+
+//-----------------------------------------------------------------
+// Adds a window to the map of the arena of the calling thread.
+// Called by the window procedures when the controller is attached
+// to the window.  Does nothing if the thread does not have an arena.
+//
+// Parameters:
+//
+// const HWND hwnd -> Handle of the window.
+// void * ctrl     -> The controller of the window.
+//-----------------------------------------------------------------
+
+void Win::ControllerArena::Register (const HWND hwnd, void * ctrl)
+{
+	if (s_current != NULL)
+		s_current->_map.Insert (hwnd, ctrl) ;
+}
+
+//-----------------------------------------------------------------
+// Removes a window from the maps of the arenas of the calling thread.
+// Called by the window procedures before the controller is deleted.
+// The window may have been registered by an outer arena, before the
+// current one was created, so all the nested arenas are searched.
+// Otherwise the outer map would keep the deleted controller, and a
+// new window reusing the handle would find it.
+//
+// Parameters:
+//
+// const HWND hwnd -> Handle of the window.
+//-----------------------------------------------------------------
+
+void Win::ControllerArena::Unregister (const HWND hwnd)
+{
+	for (ControllerArena * arena = s_current ; arena != NULL ; arena = arena->_previous)
+		arena->_map.Remove (hwnd) ;
+}
+
+//-----------------------------------------------------------------
+// Finds the smallest block size that can hold an allocation.
+//
+// Return value:  The index of the block size or NoClass if the
+//				  allocation is larger than the largest blocks.
+//
+// Parameters:
+//
+// const size_t size -> Size of the allocation, header included.
+//-----------------------------------------------------------------
+
+int Win::ControllerArena::GetSizeClass (const size_t size)
+{
+	size_t block = SmallestBlock ;
+
+	for (int i = 0 ; i < ClassCount ; ++i, block *= 2)
+	{
+		if (size <= block)
+			return i ;
+	}
+
+	return NoClass ;
+}
+
+//-----------------------------------------------------------------
+// Takes a block from the free list of a block size, or cuts a new
+// one from the current slab of that size.
+//
+// Return value:  The block.
+//
+// Parameters:
+//
+// const int sizeClass -> Index of the block size.
+//-----------------------------------------------------------------
+
+void * Win::ControllerArena::AllocateBlock (const int sizeClass)
+{
+	if (_free [sizeClass] != NULL)
+	{
+		FreeLink * block = _free [sizeClass] ;
+		_free [sizeClass] = block->next ;
+		return block ;
+	}
+
+	size_t blockSize = static_cast <size_t> (SmallestBlock) << sizeClass ;
+
+	if (_next [sizeClass] == _end [sizeClass])
+	{
+		char * slab = static_cast <char *> (::operator new (SlabSize)) ;
+		_registry->slabs.push_back (slab) ;
+		_stats.reservedBytes += SlabSize ;
+
+		_next [sizeClass] = slab ;
+		_end  [sizeClass] = slab + (SlabSize / blockSize) * blockSize ;
+	}
+
+	void * block = _next [sizeClass] ;
+	_next [sizeClass] += blockSize ;
+	return block ;
+}
+
+//-----------------------------------------------------------------
+// Puts a block back in the free list of its size.
+//
+// Parameters:
+//
+// void * block        -> The block.
+// const int sizeClass -> Index of the block size.
+//-----------------------------------------------------------------
+
+void Win::ControllerArena::ReleaseBlock (void * block, const int sizeClass)
+{
+	FreeLink * link = static_cast <FreeLink *> (block) ;
+	link->next = _free [sizeClass] ;
+	_free [sizeClass] = link ;
+}
+
+//-----------------------------------------------------------------
+// Frees the slabs of an arena and their registry.
+//
+// Parameters:
+//
+// SlabRegistry * registry -> The registry, no block must be in use.
+//-----------------------------------------------------------------
+
+void Win::ControllerArena::FreeSlabs (SlabRegistry * registry)
+{
+	for (std::vector <char *>::iterator it = registry->slabs.begin () ; it != registry->slabs.end () ; ++it)
+		::operator delete (*it) ;
+
+	delete registry ;
+}
\ No newline at end of file
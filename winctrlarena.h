@@ -0,0 +1,284 @@
+//-----------------------------------------------------------------
+//  This file contains two classes:  Win::ControllerMap and
+//  Win::ControllerArena.
+//-----------------------------------------------------------------
+
+#if !defined (WINCTRLARENA_H)
+
+	#define WINCTRLARENA_H
+	#include "useunicode.h"
+	#include "win.h"
+	#include <windows.h>
+	#include <vector>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// A Win::ControllerMap object associates window handles with the
+		// controllers of the windows.  It is a hash table with open
+		// addressing and linear probing:  a lookup reads one or two
+		// adjacent slots of a flat array instead of calling
+		// GetWindowLong, which must enter the window manager.  The size of
+		// the table is a power of two and it grows when three quarters of
+		// the slots are used.
+		//-----------------------------------------------------------------
+
+		class ControllerMap
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// The cost of the lookups made in the map.  The average number of
+			// slots read by a lookup is probes / lookups.
+			//-----------------------------------------------------------------
+
+			struct Stats
+			{
+				unsigned long lookups ; // Number of calls to Find.
+				unsigned long hits ;    // Number of lookups that found the window.
+				unsigned long probes ;  // Number of slots read by the lookups.
+			} ;
+
+			ControllerMap () ;
+
+			void Insert (const HWND hwnd, void * ctrl) ;
+			void * Find (const HWND hwnd) const ;
+			bool Remove (const HWND hwnd) ;
+			void Clear () ;
+
+			//-----------------------------------------------------------------
+			// Obtains the number of windows in the map.
+			//
+			// Return value:  The number of windows.
+			//-----------------------------------------------------------------
+
+			int GetCount () const
+			{
+				return _count ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the cost of the lookups made since the map was created
+			// or since the last call to ResetStats.
+			//
+			// Return value:  The statistics.
+			//-----------------------------------------------------------------
+
+			const Stats & GetStats () const
+			{
+				return _stats ;
+			}
+
+			//-----------------------------------------------------------------
+			// Sets the statistics to zero.
+			//-----------------------------------------------------------------
+
+			void ResetStats ()
+			{
+				_stats.lookups = 0 ;
+				_stats.hits    = 0 ;
+				_stats.probes  = 0 ;
+			}
+
+		private:
+
+			//-----------------------------------------------------------------
+			// A slot of the table.  An empty slot has a NULL key, a slot whose
+			// window was removed has the Tombstone key so the lookups going
+			// through it continue probing.
+			//-----------------------------------------------------------------
+
+			struct Slot
+			{
+				HWND   key ;
+				void * value ;
+			} ;
+
+			static HWND Tombstone ()
+			{
+				return reinterpret_cast <HWND> (~static_cast <ULONG_PTR> (0)) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Mixes the bits of a handle.  The low bits of the handles are
+			// mostly constant, so they can not be used as is.
+			//-----------------------------------------------------------------
+
+			static size_t Hash (const HWND hwnd)
+			{
+				ULONG_PTR bits = reinterpret_cast <ULONG_PTR> (hwnd) ;
+				bits ^= bits >> 16 ;
+				bits *= 0x45d9f3b ;
+				bits ^= bits >> 16 ;
+				return static_cast <size_t> (bits) ;
+			}
+
+			void Grow () ;
+
+			std::vector <Slot> _slots ;    // The table, its size is a power of two.
+			int                _count ;    // Number of windows in the table.
+			int                _used ;     // Number of windows and tombstones.
+			mutable Stats      _stats ;    // Cost of the lookups.
+
+			ControllerMap (const ControllerMap &) ;
+			ControllerMap & operator = (const ControllerMap &) ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// A Win::ControllerArena object owns the memory of the controllers
+		// created by a UI thread and the map from their windows to them.
+		// Create one on the stack of the thread, around its message loop:
+		// while it exists, the controllers created by the thread are
+		// allocated from slabs of fixed size blocks instead of the heap,
+		// and the window procedures find the controller of a window in the
+		// map instead of calling GetWindowLong.  Without an arena, the
+		// controllers are allocated on the heap and found with
+		// GetWindowLong, as before.  A controller must be destroyed by the
+		// thread that created it.  Controllers still alive when the arena
+		// is destroyed keep their slabs, which are freed with the last of
+		// them.  Arenas can be nested, the innermost one is current, and
+		// they must be destroyed in the reverse order of their creation.
+		//-----------------------------------------------------------------
+
+		class ControllerArena
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// The memory used by the arena.
+			//-----------------------------------------------------------------
+
+			struct Stats
+			{
+				unsigned long slabAllocations ; // Controllers allocated from the slabs.
+				unsigned long heapAllocations ; // Controllers too large for the slabs.
+				unsigned long liveBlocks ;      // Controllers in the slabs not yet deleted.
+				unsigned long reservedBytes ;   // Memory reserved for the slabs.
+			} ;
+
+			ControllerArena () ;
+			~ControllerArena () ;
+
+			static ControllerArena * GetCurrent () ;
+
+			static void * Allocate (const size_t size) ;
+			static void Free (void * p) ;
+
+			static void Register (const HWND hwnd, void * ctrl) ;
+			static void Unregister (const HWND hwnd) ;
+
+			//-----------------------------------------------------------------
+			// Finds the controller of a window.  The map of the arena of the
+			// thread is searched first, the window long is read when the
+			// window is not in it.
+			//
+			// Return value:  The controller or NULL if the window does not
+			//				  have one yet.
+			//
+			// Parameters:
+			//
+			// const HWND hwnd -> Handle of the window.
+			//-----------------------------------------------------------------
+
+			template <class T>
+			static T * Find (const HWND hwnd)
+			{
+				ControllerArena * arena = GetCurrent () ;
+
+				if (arena != NULL)
+				{
+					void * ctrl = arena->_map.Find (hwnd) ;
+
+					if (ctrl != NULL)
+						return static_cast <T *> (ctrl) ;
+				}
+
+				return Win::GetLong <T *> (hwnd) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the map of the windows to their controllers.
+			//
+			// Return value:  The map.
+			//-----------------------------------------------------------------
+
+			const ControllerMap & GetMap () const
+			{
+				return _map ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the memory used by the arena.
+			//
+			// Return value:  The statistics.
+			//-----------------------------------------------------------------
+
+			const Stats & GetStats () const
+			{
+				return _stats ;
+			}
+
+		private:
+
+			enum
+			{
+				ClassCount = 5,       // Number of block sizes, from 64 to 1024 bytes.
+				SmallestBlock = 64,   // Size of the smallest blocks.
+				SlabSize = 16384,     // Size of the slabs the blocks are cut from.
+				NoClass = -1          // Allocation made on the heap.
+			} ;
+
+			//-----------------------------------------------------------------
+			// The slabs of an arena.  Allocated on the heap so it can outlive
+			// the arena while controllers still use its blocks.
+			//-----------------------------------------------------------------
+
+			struct SlabRegistry
+			{
+				ControllerArena *    arena ;      // NULL once the arena is destroyed.
+				std::vector <char *> slabs ;      // All the slabs.
+				unsigned long        liveBlocks ; // Blocks not yet freed.
+			} ;
+
+			//-----------------------------------------------------------------
+			// Placed in front of every controller so Free knows where the
+			// memory comes from.  The union keeps the controller aligned on
+			// 16 bytes.
+			//-----------------------------------------------------------------
+
+			union Header
+			{
+				struct
+				{
+					SlabRegistry * registry ;  // NULL for the heap.
+					int            sizeClass ; // Index of the block size.
+				} info ;
+
+				double align [2] ;
+			} ;
+
+			struct FreeLink
+			{
+				FreeLink * next ;
+			} ;
+
+			static int GetSizeClass (const size_t size) ;
+			void * AllocateBlock (const int sizeClass) ;
+			void ReleaseBlock (void * block, const int sizeClass) ;
+			static void FreeSlabs (SlabRegistry * registry) ;
+
+			ControllerArena *     _previous ;            // Arena that was current before this one.
+			DWORD                 _threadId ;            // Thread that owns the arena.
+			ControllerMap         _map ;                 // Windows to controllers.
+			FreeLink *            _free [ClassCount] ;   // Freed blocks of each size.
+			char *                _next [ClassCount] ;   // Next unused block of each size.
+			char *                _end  [ClassCount] ;   // End of the current slab of each size.
+			SlabRegistry *        _registry ;            // The slabs.
+			Stats                 _stats ;               // Memory used.
+
+			ControllerArena (const ControllerArena &) ;
+			ControllerArena & operator = (const ControllerArena &) ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
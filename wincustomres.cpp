@@ -13,13 +13,15 @@
 
 Win::CustomRes::CustomRes (HINSTANCE hInstance, int id, const std::tstring type)
 {
-	_res = ::LoadResource(hInstance, ::FindResource (hInstance, MAKEINTRESOURCE (id), type.c_str ())) ;
+	HRSRC hInfo = ::FindResource (hInstance, MAKEINTRESOURCE (id), type.c_str ()) ;
+
+	_res = ::LoadResource(hInstance, hInfo) ;
 	
 	// Could not load the resource.
 	if (!_res) 
 		throw Win::Exception (TEXT("Could not load a custom ressource")) ;
 
-	_ptr = ::LockResource (_res) ;
+	_reader = Win::ResourceReader (::LockResource (_res), ::SizeofResource (hInstance, hInfo)) ;
 }
 
 //------------------------------------------------------------------------
@@ -30,12 +32,7 @@ Win::CustomRes::CustomRes (HINSTANCE hInstance, int id, const std::tstring type)
 
 long Win::CustomRes::ReadLong () 
 {
-	long * p = reinterpret_cast <long *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <long> () ;
 }
 
 //------------------------------------------------------------------------
@@ -46,12 +43,7 @@ long Win::CustomRes::ReadLong ()
 
 unsigned long Win::CustomRes::ReadUnsignedLong () 
 {
-	unsigned long * p = reinterpret_cast <unsigned long *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <unsigned long> () ;
 }
 
 //------------------------------------------------------------------------
@@ -62,12 +54,7 @@ unsigned long Win::CustomRes::ReadUnsignedLong ()
 
 short Win::CustomRes::ReadShort () 
 {
-	short * p = reinterpret_cast <short *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <short> () ;
 }
 
 //------------------------------------------------------------------------
@@ -78,12 +65,7 @@ short Win::CustomRes::ReadShort ()
 
 unsigned short Win::CustomRes::ReadUnsignedShort () 
 {
-	unsigned short * p = reinterpret_cast <unsigned short *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <unsigned short> () ;
 }
 
 //------------------------------------------------------------------------
@@ -94,12 +76,7 @@ unsigned short Win::CustomRes::ReadUnsignedShort ()
 
 TCHAR Win::CustomRes::ReadChar () 
 {
-	TCHAR * p = reinterpret_cast <TCHAR *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <TCHAR> () ;
 }
 
 //------------------------------------------------------------------------
@@ -110,12 +87,7 @@ TCHAR Win::CustomRes::ReadChar ()
 
 BYTE Win::CustomRes::ReadByte () 
 {
-	BYTE * p = reinterpret_cast <unsigned char *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <BYTE> () ;
 }
 
 //------------------------------------------------------------------------
@@ -126,12 +98,7 @@ BYTE Win::CustomRes::ReadByte ()
 
 bool Win::CustomRes::ReadBool () 
 {
-	bool * p = reinterpret_cast <bool *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <bool> () ;
 }
 
 //------------------------------------------------------------------------
@@ -142,12 +109,7 @@ bool Win::CustomRes::ReadBool ()
 
 float Win::CustomRes::ReadFloat () 
 {
-	float * p = reinterpret_cast <float *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <float> () ;
 }
 
 //------------------------------------------------------------------------
@@ -158,12 +120,7 @@ float Win::CustomRes::ReadFloat ()
 
 double Win::CustomRes::ReadDouble () 
 {
-	double * p = reinterpret_cast <double *> (_ptr) ;
-
-	_ptr = ++p;
-	--p ;
-
-	return *p ;
+	return _reader.Read <double> () ;
 }
 
 //------------------------------------------------------------------------
@@ -174,10 +131,40 @@ double Win::CustomRes::ReadDouble ()
 
 wchar_t Win::CustomRes::ReadWideChar ()
 {
-	wchar_t * p = reinterpret_cast <wchar_t *> (_ptr) ;
+	return _reader.Read <wchar_t> () ;
+}
+
+//------------------------------------------------------------------------
+// Reads a string of chars preceded by its length stored in a WORD.
+//
+// Return value:  The string.
+//------------------------------------------------------------------------
+
+std::string Win::ResourceReader::ReadString ()
+{
+	WORD        len = Read <WORD> () ;
+	std::string str (len, '\0') ;
+
+	if (len > 0)
+		ReadArray (&str [0], len) ;
+
+	return str ;
+}
+
+//------------------------------------------------------------------------
+// Reads a string of wide chars preceded by its length in characters
+// stored in a WORD.
+//
+// Return value:  The string.
+//------------------------------------------------------------------------
+
+std::wstring Win::ResourceReader::ReadWideString ()
+{
+	WORD         len = Read <WORD> () ;
+	std::wstring str (len, L'\0') ;
 
-	_ptr = ++p;
-	--p ;
+	if (len > 0)
+		ReadArray (&str [0], len) ;
 
-	return *p ;
+	return str ;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------
-//  This file contains only one class:  Win::CustomRes
+//  This file contains classes used to read custom resources.
 //-----------------------------------------------------------------
 
 #if !defined (WINCUSTOMRES_H)
@@ -10,9 +10,221 @@
 	#include "winunicodehelper.h"
 	#include <wchar.h>
 	#include "winglobalhandle.h"
+	#include "winexception.h"
 
 	namespace Win
 	{
+		//----------------------------------------------------------------------------
+		// Exception that is thrown when trying to read past the end of a resource.
+		//----------------------------------------------------------------------------
+
+		class ResourceTruncatedException : public Win::Exception
+		{
+		public:
+			ResourceTruncatedException ()
+				: Win::Exception (TEXT("Error, tried to read past the end of a resource."))
+			{}
+		} ;
+
+		//----------------------------------------------------------------------------
+		// Win::ResourceReader reads values one after the other from a block of 
+		// memory of known size, like the data of a resource.  Every read is checked
+		// against the end of the block and may be unaligned.  Values are stored in
+		// little endian order unless a BigEndian method is used.  View gives access
+		// to an array of the block without copying it.
+		//----------------------------------------------------------------------------
+
+		class ResourceReader
+		{
+		public:
+
+			//------------------------------------------------------------------------
+			// Constructor.
+			//
+			// Parameters:
+			//
+			// const void * data -> The beginning of the block.
+			// const DWORD size  -> The size of the block in bytes.
+			//------------------------------------------------------------------------
+
+			ResourceReader (const void * data = NULL, const DWORD size = 0)
+				: _begin (static_cast <const BYTE *> (data)),
+				  _pos   (0),
+				  _size  (data == NULL ? 0 : size)
+			{}
+
+			//------------------------------------------------------------------------
+			// Obtains the size of the block in bytes.
+			//------------------------------------------------------------------------
+
+			DWORD GetSize () const
+			{
+				return _size ;
+			}
+
+			//------------------------------------------------------------------------
+			// Obtains the position of the next read, in bytes from the beginning.
+			//------------------------------------------------------------------------
+
+			DWORD GetPosition () const
+			{
+				return _pos ;
+			}
+
+			//------------------------------------------------------------------------
+			// Obtains the number of bytes that are left to read.
+			//------------------------------------------------------------------------
+
+			DWORD GetRemaining () const
+			{
+				return _size - _pos ;
+			}
+
+			//------------------------------------------------------------------------
+			// Moves the position of the next read.
+			//
+			// Parameters:
+			//
+			// const DWORD pos -> The new position, in bytes from the beginning.
+			//------------------------------------------------------------------------
+
+			void Seek (const DWORD pos)
+			{
+				if (pos > _size)
+					throw Win::ResourceTruncatedException () ;
+
+				_pos = pos ;
+			}
+
+			//------------------------------------------------------------------------
+			// Skips some bytes.
+			//
+			// Parameters:
+			//
+			// const DWORD count -> The number of bytes to skip.
+			//------------------------------------------------------------------------
+
+			void Skip (const DWORD count)
+			{
+				Seek (Advance (count)) ;
+			}
+
+			//------------------------------------------------------------------------
+			// Reads a value of type T.  T must be a plain type like int or double.
+			//
+			// Return value:  The value.
+			//------------------------------------------------------------------------
+
+			template <class T>
+			T Read ()
+			{
+				T value ;
+				::CopyMemory (&value, _begin + Take (sizeof (T)), sizeof (T)) ;
+				return value ;
+			}
+
+			//------------------------------------------------------------------------
+			// Reads an integer stored in big endian order (most significant byte
+			// first), like in many file formats.
+			//
+			// Return value:  The value.
+			//------------------------------------------------------------------------
+
+			template <class T>
+			T ReadBigEndian ()
+			{
+				const BYTE * p     = _begin + Take (sizeof (T)) ;
+				T            value = 0 ;
+
+				for (size_t i = 0 ; i < sizeof (T) ; ++i)
+					value = static_cast <T> ((value << 8) | p [i]) ;
+
+				return value ;
+			}
+
+			//------------------------------------------------------------------------
+			// Reads many values of type T at once.
+			//
+			// Parameters:
+			//
+			// T * dest          -> Will contain the values.
+			// const DWORD count -> The number of values.
+			//------------------------------------------------------------------------
+
+			template <class T>
+			void ReadArray (T * dest, const DWORD count)
+			{
+				::CopyMemory (dest, _begin + Take (ArraySize (sizeof (T), count)), count * sizeof (T)) ;
+			}
+
+			//------------------------------------------------------------------------
+			// Gives access to many values of type T without copying them.  Throws
+			// an exception if the values are not aligned in memory.
+			//
+			// Return value:  A pointer on the first value, valid as long as the 
+			//				  block is.
+			//
+			// Parameters:
+			//
+			// const DWORD count -> The number of values.
+			//------------------------------------------------------------------------
+
+			template <class T>
+			const T * View (const DWORD count)
+			{
+				if (count != 0 && reinterpret_cast <size_t> (_begin + _pos) % sizeof (T) != 0)
+					throw Win::Exception (TEXT("Error, the data of the resource is not aligned")) ;
+
+				return reinterpret_cast <const T *> (_begin + Take (ArraySize (sizeof (T), count))) ;
+			}
+
+			std::string  ReadString () ;
+			std::wstring ReadWideString () ;
+
+		private:
+
+			//------------------------------------------------------------------------
+			// Computes the position after some bytes, checking the end of the block.
+			//------------------------------------------------------------------------
+
+			DWORD Advance (const DWORD count) const
+			{
+				if (count > _size - _pos)
+					throw Win::ResourceTruncatedException () ;
+
+				return _pos + count ;
+			}
+
+			//------------------------------------------------------------------------
+			// Moves past some bytes, checking the end of the block.
+			//
+			// Return value:  The position of the first byte.
+			//------------------------------------------------------------------------
+
+			DWORD Take (const DWORD count)
+			{
+				DWORD pos = _pos ;
+				_pos = Advance (count) ;
+				return pos ;
+			}
+
+			//------------------------------------------------------------------------
+			// Computes the size of an array, checking for overflow.
+			//------------------------------------------------------------------------
+
+			static DWORD ArraySize (const DWORD elemSize, const DWORD count)
+			{
+				if (count != 0 && elemSize > 0xFFFFFFFF / count)
+					throw Win::ResourceTruncatedException () ;
+
+				return elemSize * count ;
+			}
+
+			const BYTE * _begin ; // Beginning of the block.
+			DWORD        _pos ;   // Position of the next read.
+			DWORD        _size ;  // Size of the block.
+		} ;
+
 		//----------------------------------------------------------------------------
 		// Win::CustomRes allows to load and use a custom resource.
 		//----------------------------------------------------------------------------
@@ -43,6 +255,25 @@
 				return ::LockResource (_res) ;
 			}
 
+			//------------------------------------------------------------------------
+			// Obtains the size of the custom resource in bytes.
+			//------------------------------------------------------------------------
+
+			DWORD GetSize () const
+			{
+				return _reader.GetSize () ;
+			}
+
+			//------------------------------------------------------------------------
+			// Obtains the reader used by the Read methods.  Gives access to bulk
+			// reads, views and big endian values.
+			//------------------------------------------------------------------------
+
+			Win::ResourceReader & GetReader ()
+			{
+				return _reader ;
+			}
+
 			long ReadLong () ;
 			unsigned long ReadUnsignedLong () ;
 			short ReadShort () ;
@@ -60,8 +291,8 @@
 			CustomRes operator = (Win::CustomRes & res) ;
 
 		protected:
-			Win::Global::Handle _res ; //Handle to the resource.
-			void *				_ptr ; //Points on the data of the resource.
+			Win::Global::Handle _res ;    //Handle to the resource.
+			Win::ResourceReader _reader ; //Reads the data of the resource.
 
 		} ;
 	}
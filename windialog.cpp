@@ -333,6 +333,31 @@ Win::Dialog::Modeless::Handle Win::Dialog::Modeless::Creator::Create (StrongPoin
 	return dlg ;
 }
 
+//-----------------------------------------------------------------------------
+//Creates a modeless dialog from a template built in memory.
+//
+// Parameters:
+//
+// StrongPointer <ModelessController> & ctrl -> Points on the Controller of the 
+//												dialog box.
+//-----------------------------------------------------------------------------
+
+Win::Dialog::Modeless::Handle Win::Dialog::Modeless::TemplateCreator::Create (StrongPointer <Win::Dialog::Modeless::Controller> & ctrl)
+{
+	Win::Dialog::Modeless::Handle dlg ;
+
+	dlg = ::CreateDialogIndirectParam ( _parent.GetInstance (),
+										 _template.Get (),
+										 _parent,
+										 static_cast <DLGPROC> (Win::Dialog::ModelessProc),
+										 reinterpret_cast <LPARAM> (&ctrl)) ;
+
+	if (!dlg) // Make sure the dialog was created.
+		throw Win::Exception (TEXT("Internal error: Cannot create modeless dialog.")) ;
+
+	return dlg ;
+}
+
 //-----------------------------------------------------------------------------
 //Creates a find modelfes dialog.
 //
@@ -12,6 +12,8 @@
 	#include "winlogdrawingtool.h"
 	#include "winupcast.h"
 	#include "wincanvas.h"
+	#include "wincommandrouter.h"
+	#include "windlgtemplate.h"
 
 
 	namespace Win
@@ -86,10 +88,10 @@
 				//-------------------------------------------------------------------
 
 				virtual bool OnCommand (const int id, const bool isAccelerator) throw ()
-				{return false ;}
+				{return _router.RouteCommand (id, isAccelerator) ;}
 
 				virtual bool OnControl (Win::Base & control, const int id, const int notificationCode) throw ()
-				{return false ;}
+				{return _router.RouteControl (id, notificationCode) ;}
 
 				//-------------------------------------------------------------------
 				// Represents the WM_NOTIFY message.
@@ -104,7 +106,7 @@
 
 				virtual bool OnNotify (Win::Base dlg, const int id, NMHDR * hdr) throw ()
 				{
-					return false ;
+					return _router.RouteNotify (hdr) ;
 				}
 
 				//-------------------------------------------------------------------------
@@ -144,6 +146,19 @@
 				virtual void EndOk () throw () = 0 ;
 				virtual void EndCancel () throw ()= 0 ;
 
+				//-------------------------------------------------------------------------
+				// Obtains the command router of the controller.  The default
+				// OnCommand, OnControl and OnNotify methods route the messages to the
+				// handlers registered in it.
+				//
+				// Return value: The command router.
+				//-------------------------------------------------------------------------
+
+				Win::CommandRouter & GetRouter ()
+				{
+					return _router ;
+				}
+
 			protected:
 
 				//-------------------------------------------------------------------------
@@ -174,7 +189,8 @@
 
 			protected:
 
-				Win::Dialog::Handle _dlg ; // Dialog owning the controller.
+				Win::Dialog::Handle _dlg ;    // Dialog owning the controller.
+				Win::CommandRouter  _router ; // Handlers of WM_COMMAND and WM_NOTIFY.
 
 			} ;
 
@@ -1791,6 +1807,47 @@
 					int	_result ; // Used to determine if od or cancel was pressed.
 				} ;
 
+				//----------------------------------------------------------------------
+				// Win::Dialog::Modal::TemplateCreator creates a modal dialog from a 
+				// template built in memory instead of a dialog resource.
+				//----------------------------------------------------------------------
+
+				class TemplateCreator
+				{
+				public:
+
+					//----------------------------------------------------------------------
+					// Constructor.  Creates a modal dialog.
+					//
+					// Parameters:
+					//
+					// const Win::Base & win                -> Window owning the dialog box.
+					// const Win::Dialog::Template & tmpl   -> Template of the dialog box.
+					// Win::Dialog::Modal::Controller & ctrl -> Controller of the dialog box
+					//----------------------------------------------------------------------
+
+					TemplateCreator (const Win::Base & win, const Win::Dialog::Template & tmpl, Win::Dialog::Modal::Controller & ctrl)
+					{
+						_result = ::DialogBoxIndirectParam (win.GetInstance (), tmpl.Get (), win,
+															(DLGPROC) ModalProc, (LPARAM) & ctrl) ;
+					}
+
+					//----------------------------------------------------------------------
+					// Determines if the dialog was closed with the ok or cancel button.
+					//
+					// Return value:  True if closed with ok, else false.
+					//----------------------------------------------------------------------
+
+					bool IsOk () const 
+					{ 
+						return (_result == -1) ? false : _result != 0 ; 
+					}
+
+				private:
+
+					INT_PTR	_result ; // Used to determine if ok or cancel was pressed.
+				} ;
+
 				//----------------------------------------------------------------------
 				// Win::Dialog::OpenFile allows to create a open common dialog.
 				//----------------------------------------------------------------------
@@ -2367,6 +2424,41 @@
 					int				 _id ;
 				};
 
+				//----------------------------------------------------------------------
+				// Win::Dialog::Modeless::TemplateCreator creates a modeless dialog from
+				// a template built in memory instead of a dialog resource.  All the
+				// controls of the template are created by a single call.
+				//----------------------------------------------------------------------
+
+				class TemplateCreator
+				{
+				public:
+
+					//----------------------------------------------------------------------
+					// Constructor.
+					//
+					// Parameters:
+					//
+					// Win::Base parent                    -> Window owning the dialog box.
+					// const Win::Dialog::Template & tmpl  -> Template of the dialog box.  It
+					//										  must outlive the creator.
+					//----------------------------------------------------------------------
+
+					TemplateCreator (Win::Base parent, const Win::Dialog::Template & tmpl)
+						: _parent   (parent),
+						  _template (tmpl)
+					{}
+
+					Win::Dialog::Modeless::Handle Create (StrongPointer <Win::Dialog::Modeless::Controller> & ctrl) ;
+
+				private:
+
+					TemplateCreator & operator = (const TemplateCreator &) ;
+
+					Win::Base                     _parent ;
+					const Win::Dialog::Template & _template ;
+				} ;
+
 				//----------------------------------------------------------------------
 				// Win::Dialog::Find allows to create a find common dialog.
 				//----------------------------------------------------------------------
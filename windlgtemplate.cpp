@@ -0,0 +1,396 @@
+#include "windlgtemplate.h"
+
+//-----------------------------------------------------------------
+// Constructor.  Describes a dialog without any control.
+//
+// Parameters:
+//
+// const std::tstring & title -> Caption of the dialog.
+// const short x              -> Left of the dialog, in dialog units.
+// const short y              -> Top of the dialog, in dialog units.
+// const short cx             -> Width of the dialog, in dialog units.
+// const short cy             -> Height of the dialog, in dialog units.
+// const DWORD style          -> Style of the dialog.
+// const DWORD exStyle        -> Extended style of the dialog.
+//-----------------------------------------------------------------
+
+Win::Dialog::Template::Template (const std::tstring & title, const short x, const short y, const short cx, const short cy,
+								 const DWORD style, const DWORD exStyle)
+	: _helpId    (0),
+	  _exStyle   (exStyle),
+	  _style     (style),
+	  _x         (x),
+	  _y         (y),
+	  _cx        (cx),
+	  _cy        (cy),
+	  _menu      (0),
+	  _title     (ToWide (title.c_str ())),
+	  _hasFont   (false),
+	  _pointSize (0),
+	  _weight    (0),
+	  _italic    (0),
+	  _charSet   (0),
+	  _modified  (true)
+{}
+
+//-----------------------------------------------------------------
+// Sets the font of the dialog and of its controls.  DS_SETFONT is
+// added to the style of the dialog.
+//
+// Parameters:
+//
+// const std::tstring & typeFace -> Name of the font.
+// const WORD pointSize          -> Size of the font, in points.
+// const WORD weight             -> Weight of the font, FW_NORMAL, FW_BOLD...
+// const bool italic             -> True for an italic font.
+// const BYTE charSet            -> Character set of the font.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::SetFont (const std::tstring & typeFace, const WORD pointSize, const WORD weight,
+									 const bool italic, const BYTE charSet)
+{
+	_hasFont   = true ;
+	_typeFace  = ToWide (typeFace.c_str ()) ;
+	_pointSize = pointSize ;
+	_weight    = weight ;
+	_italic    = italic ? 1 : 0 ;
+	_charSet   = charSet ;
+	_modified  = true ;
+}
+
+//-----------------------------------------------------------------
+// Adds a control described by a Control structure.
+//
+// Parameters:
+//
+// const Control & control -> Description of the control.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::Add (const Control & control)
+{
+	AddItem (control.id, static_cast <WORD> (control.classOrdinal), ToWide (control.className), ToWide (control.text),
+			 control.x, control.y, control.cx, control.cy, control.style, control.exStyle) ;
+}
+
+//-----------------------------------------------------------------
+// Adds the controls described by an array of Control structures, in
+// order.  The order is the tab order of the dialog.
+//
+// Parameters:
+//
+// const Control controls [] -> Description of the controls.
+// const int count           -> Number of controls in the array.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::Add (const Control controls [], const int count)
+{
+	_items.reserve (_items.size () + count) ;
+
+	for (int i = 0 ; i < count ; ++i)
+		Add (controls [i]) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a control of a predefined class.
+//
+// Parameters:
+//
+// const int id                    -> Id of the control.
+// const ClassOrdinal classOrdinal -> Class of the control.
+// const std::tstring & text       -> Text of the control.
+// const short x                   -> Left of the control, in dialog units.
+// const short y                   -> Top of the control, in dialog units.
+// const short cx                  -> Width of the control, in dialog units.
+// const short cy                  -> Height of the control, in dialog units.
+// const DWORD style               -> Style of the control.
+// const DWORD exStyle             -> Extended style of the control.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::Add (const int id, const ClassOrdinal classOrdinal, const std::tstring & text,
+								 const short x, const short y, const short cx, const short cy,
+								 const DWORD style, const DWORD exStyle)
+{
+	AddItem (id, static_cast <WORD> (classOrdinal), std::wstring (), ToWide (text.c_str ()), x, y, cx, cy, style, exStyle) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a control of a registered window class, common controls
+// included.
+//
+// Parameters:
+//
+// const int id                    -> Id of the control.
+// const std::tstring & className  -> Name of the window class.
+// const std::tstring & text       -> Text of the control.
+// const short x                   -> Left of the control, in dialog units.
+// const short y                   -> Top of the control, in dialog units.
+// const short cx                  -> Width of the control, in dialog units.
+// const short cy                  -> Height of the control, in dialog units.
+// const DWORD style               -> Style of the control.
+// const DWORD exStyle             -> Extended style of the control.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::Add (const int id, const std::tstring & className, const std::tstring & text,
+								 const short x, const short y, const short cx, const short cy,
+								 const DWORD style, const DWORD exStyle)
+{
+	AddItem (id, Custom, ToWide (className.c_str ()), ToWide (text.c_str ()), x, y, cx, cy, style, exStyle) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the template, ready for CreateDialogIndirectParam or
+// DialogBoxIndirectParam.  The pointer is valid until the template
+// is modified or destroyed.
+//
+// Return value:  The template.
+//-----------------------------------------------------------------
+
+const DLGTEMPLATE * Win::Dialog::Template::Get () const
+{
+	Build () ;
+
+	// The memory allocated by std::vector is suitably aligned for any
+	// type, which satisfies the DWORD alignment required by the system.
+	return reinterpret_cast <const DLGTEMPLATE *> (&_data [0]) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the size of the template.
+//
+// Return value:  The size of the template, in bytes.
+//-----------------------------------------------------------------
+
+size_t Win::Dialog::Template::GetSize () const
+{
+	Build () ;
+	return _data.size () ;
+}
+
+//-----------------------------------------------------------------
+// Appends a control to the list.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::AddItem (const int id, const WORD classOrdinal, const std::wstring & className, const std::wstring & text,
+									 const short x, const short y, const short cx, const short cy,
+									 const DWORD style, const DWORD exStyle)
+{
+	// cDlgItems is a WORD.
+	if (_items.size () >= 0xFFFF)
+		throw Win::Exception (TEXT("Error, a dialog template cannot contain more than 65535 controls")) ;
+
+	if (classOrdinal == Custom && className.empty ())
+		throw Win::Exception (TEXT("Error, the class of a dialog control is missing")) ;
+
+	Item item ;
+	item.id           = static_cast <DWORD> (id) ;
+	item.classOrdinal = classOrdinal ;
+	item.className    = className ;
+	item.text         = text ;
+	item.x            = x ;
+	item.y            = y ;
+	item.cx           = cx ;
+	item.cy           = cy ;
+	item.style        = style | WS_CHILD ;
+	item.exStyle      = exStyle ;
+
+	_items.push_back (item) ;
+	_modified = true ;
+}
+
+//-----------------------------------------------------------------
+// Serializes the template in _data if it was modified.  The layout
+// is the one documented for DLGTEMPLATEEX and DLGITEMTEMPLATEEX:  a
+// header followed by the controls, each starting on a DWORD
+// boundary.  Strings are null terminated UTF-16 and ordinals are
+// 0xFFFF followed by the value.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::Build () const
+{
+	if (!_modified)
+		return ;
+
+	_data.assign (ComputeSize (), 0) ;
+
+	size_t offset = 0 ;
+
+	// DLGTEMPLATEEX.
+	WriteWord  (offset, 1) ;      // dlgVer.
+	WriteWord  (offset, 0xFFFF) ; // signature.
+	WriteDword (offset, _helpId) ;
+	WriteDword (offset, _exStyle) ;
+	WriteDword (offset, _hasFont ? _style | DS_SETFONT : _style & ~DS_SETFONT) ;
+	WriteWord  (offset, static_cast <WORD> (_items.size ())) ;
+	WriteWord  (offset, static_cast <WORD> (_x)) ;
+	WriteWord  (offset, static_cast <WORD> (_y)) ;
+	WriteWord  (offset, static_cast <WORD> (_cx)) ;
+	WriteWord  (offset, static_cast <WORD> (_cy)) ;
+	WriteNameOrOrdinal (offset, _menu, std::wstring ()) ;
+	WriteWord  (offset, 0) ;      // Predefined dialog class.
+	WriteString (offset, _title) ;
+
+	if (_hasFont)
+	{
+		WriteWord (offset, _pointSize) ;
+		WriteWord (offset, _weight) ;
+		_data [offset++] = _italic ;
+		_data [offset++] = _charSet ;
+		WriteString (offset, _typeFace) ;
+	}
+
+	// DLGITEMTEMPLATEEX.
+	for (std::vector <Item>::const_iterator it = _items.begin () ; it != _items.end () ; ++it)
+	{
+		offset = Align (offset) ;
+
+		WriteDword (offset, 0) ;      // helpID.
+		WriteDword (offset, it->exStyle) ;
+		WriteDword (offset, it->style) ;
+		WriteWord  (offset, static_cast <WORD> (it->x)) ;
+		WriteWord  (offset, static_cast <WORD> (it->y)) ;
+		WriteWord  (offset, static_cast <WORD> (it->cx)) ;
+		WriteWord  (offset, static_cast <WORD> (it->cy)) ;
+		WriteDword (offset, it->id) ;
+		WriteNameOrOrdinal (offset, it->classOrdinal, it->className) ;
+		WriteString (offset, it->text) ;
+		WriteWord  (offset, 0) ;      // extraCount.
+	}
+
+	_modified = false ;
+}
+
+//-----------------------------------------------------------------
+// Computes the size of the serialized template so _data is
+// allocated once.
+//
+// Return value:  The size, in bytes.
+//-----------------------------------------------------------------
+
+size_t Win::Dialog::Template::ComputeSize () const
+{
+	// Fixed part of DLGTEMPLATEEX, up to the menu.
+	size_t size = 26 ;
+
+	size += _menu != 0 ? 2 * sizeof (WORD) : sizeof (WORD) ;
+	size += sizeof (WORD) ;
+	size += StringSize (_title) ;
+
+	if (_hasFont)
+		size += 2 * sizeof (WORD) + 2 * sizeof (BYTE) + StringSize (_typeFace) ;
+
+	for (std::vector <Item>::const_iterator it = _items.begin () ; it != _items.end () ; ++it)
+	{
+		// Fixed part of DLGITEMTEMPLATEEX, up to the class.
+		size = Align (size) + 24 ;
+		size += it->classOrdinal != Custom ? 2 * sizeof (WORD) : StringSize (it->className) ;
+		size += StringSize (it->text) ;
+		size += sizeof (WORD) ;
+	}
+
+	return size ;
+}
+
+//-----------------------------------------------------------------
+// Converts a string to UTF-16.
+//
+// Return value:  The converted string.
+//
+// Parameters:
+//
+// const TCHAR * str -> The string, or NULL for an empty string.
+//-----------------------------------------------------------------
+
+std::wstring Win::Dialog::Template::ToWide (const TCHAR * str)
+{
+	if (str == NULL || *str == 0)
+		return std::wstring () ;
+
+	#if defined (UNICODE)
+
+		return std::wstring (str) ;
+
+	#else
+
+		int length = ::MultiByteToWideChar (CP_ACP, 0, str, -1, NULL, 0) ;
+
+		if (length == 0)
+			throw Win::Exception (TEXT("Error, could not convert a string of a dialog template")) ;
+
+		std::vector <WCHAR> wide (length) ;
+		::MultiByteToWideChar (CP_ACP, 0, str, -1, &wide [0], length) ;
+
+		return std::wstring (&wide [0], length - 1) ;
+
+	#endif
+}
+
+//-----------------------------------------------------------------
+// Obtains the size of a serialized string.
+//
+// Return value:  The size, terminating null included, in bytes.
+//
+// Parameters:
+//
+// const std::wstring & str -> The string.
+//-----------------------------------------------------------------
+
+size_t Win::Dialog::Template::StringSize (const std::wstring & str)
+{
+	return (str.length () + 1) * sizeof (WORD) ;
+}
+
+//-----------------------------------------------------------------
+// Rounds an offset up to the next DWORD boundary.
+//
+// Return value:  The aligned offset.
+//
+// Parameters:
+//
+// const size_t offset -> The offset.
+//-----------------------------------------------------------------
+
+size_t Win::Dialog::Template::Align (const size_t offset)
+{
+	return (offset + 3) & ~static_cast <size_t> (3) ;
+}
+
+//-----------------------------------------------------------------
+// The following methods write a value at an offset of _data, in
+// little endian order, and move the offset after it.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::WriteWord (size_t & offset, const WORD value) const
+{
+	_data [offset++] = static_cast <BYTE> (value) ;
+	_data [offset++] = static_cast <BYTE> (value >> 8) ;
+}
+
+void Win::Dialog::Template::WriteDword (size_t & offset, const DWORD value) const
+{
+	WriteWord (offset, static_cast <WORD> (value)) ;
+	WriteWord (offset, static_cast <WORD> (value >> 16)) ;
+}
+
+void Win::Dialog::Template::WriteString (size_t & offset, const std::wstring & str) const
+{
+	for (std::wstring::const_iterator it = str.begin () ; it != str.end () ; ++it)
+		WriteWord (offset, static_cast <WORD> (*it)) ;
+
+	WriteWord (offset, 0) ;
+}
+
+//-----------------------------------------------------------------
+// Writes a sz_Or_Ord field:  an ordinal if it is not 0, else the
+// string, which is a single null character when empty.
+//-----------------------------------------------------------------
+
+void Win::Dialog::Template::WriteNameOrOrdinal (size_t & offset, const WORD ordinal, const std::wstring & str) const
+{
+	if (ordinal != 0)
+	{
+		WriteWord (offset, 0xFFFF) ;
+		WriteWord (offset, ordinal) ;
+	}
+	else
+		WriteString (offset, str) ;
+}
\ No newline at end of file
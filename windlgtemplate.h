@@ -0,0 +1,196 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Dialog::Template.
+//-----------------------------------------------------------------
+
+#if !defined (WINDLGTEMPLATE_H)
+
+	#define WINDLGTEMPLATE_H
+	#include "useunicode.h"
+	#include "winunicodehelper.h"
+	#include "winexception.h"
+	#include <windows.h>
+	#include <vector>
+	#include <string>
+
+	namespace Win
+	{
+		namespace Dialog
+		{
+			//-----------------------------------------------------------------
+			// A Win::Dialog::Template object builds an extended dialog
+			// template (DLGTEMPLATEEX) in memory, the same block of data the
+			// resource compiler produces from a DIALOGEX statement.  The
+			// whole form, with all its controls, is then created by a single
+			// call to CreateDialogIndirectParam or DialogBoxIndirectParam
+			// instead of one CreateWindowEx per control.  See
+			// Win::Dialog::Modal::TemplateCreator and
+			// Win::Dialog::Modeless::TemplateCreator.
+			//
+			// Controls can be described by an array of Control structures:
+			//
+			// static const Win::Dialog::Template::Control controls [] =
+			// {
+			//	 {IDC_NAME, Win::Dialog::Template::Edit,   NULL, TEXT(""),   50, 7, 100, 14, WS_VISIBLE | WS_TABSTOP | WS_BORDER, 0},
+			//	 {IDOK,     Win::Dialog::Template::Button, NULL, TEXT("OK"), 50, 30, 50, 14, WS_VISIBLE | WS_TABSTOP | BS_DEFPUSHBUTTON, 0}
+			// } ;
+			//
+			// Coordinates are in dialog units.
+			//-----------------------------------------------------------------
+
+			class Template
+			{
+			public:
+
+				//-----------------------------------------------------------------
+				// Ordinals of the predefined control classes.
+				//-----------------------------------------------------------------
+
+				enum ClassOrdinal
+				{
+					Custom    = 0,
+					Button    = 0x0080,
+					Edit      = 0x0081,
+					Static    = 0x0082,
+					ListBox   = 0x0083,
+					ScrollBar = 0x0084,
+					ComboBox  = 0x0085
+				} ;
+
+				//-----------------------------------------------------------------
+				// Describes a control of the dialog.  WS_CHILD is always added to
+				// the style.  className is only used when classOrdinal is Custom.
+				//-----------------------------------------------------------------
+
+				struct Control
+				{
+					int          id ;
+					ClassOrdinal classOrdinal ;
+					const TCHAR* className ;
+					const TCHAR* text ;
+					short        x ;
+					short        y ;
+					short        cx ;
+					short        cy ;
+					DWORD        style ;
+					DWORD        exStyle ;
+				} ;
+
+				Template (const std::tstring & title, const short x, const short y, const short cx, const short cy,
+						  const DWORD style = DS_MODALFRAME | WS_POPUP | WS_CAPTION | WS_SYSMENU, const DWORD exStyle = 0) ;
+
+				void SetFont (const std::tstring & typeFace, const WORD pointSize, const WORD weight = FW_NORMAL,
+							  const bool italic = false, const BYTE charSet = DEFAULT_CHARSET) ;
+
+				//-----------------------------------------------------------------
+				// Sets the menu of the dialog.
+				//
+				// Parameters:
+				//
+				// const WORD id -> Id of the menu resource.
+				//-----------------------------------------------------------------
+
+				void SetMenu (const WORD id)
+				{
+					_menu     = id ;
+					_modified = true ;
+				}
+
+				//-----------------------------------------------------------------
+				// Sets the context help id of the dialog.
+				//
+				// Parameters:
+				//
+				// const DWORD helpId -> The help id.
+				//-----------------------------------------------------------------
+
+				void SetHelpId (const DWORD helpId)
+				{
+					_helpId   = helpId ;
+					_modified = true ;
+				}
+
+				void Add (const Control & control) ;
+				void Add (const Control controls [], const int count) ;
+
+				void Add (const int id, const ClassOrdinal classOrdinal, const std::tstring & text,
+						  const short x, const short y, const short cx, const short cy,
+						  const DWORD style, const DWORD exStyle = 0) ;
+
+				void Add (const int id, const std::tstring & className, const std::tstring & text,
+						  const short x, const short y, const short cx, const short cy,
+						  const DWORD style, const DWORD exStyle = 0) ;
+
+				//-----------------------------------------------------------------
+				// Obtains the number of controls.
+				//
+				// Return value:  The number of controls.
+				//-----------------------------------------------------------------
+
+				int GetCount () const
+				{
+					return static_cast <int> (_items.size ()) ;
+				}
+
+				const DLGTEMPLATE * Get () const ;
+				size_t GetSize () const ;
+
+			private:
+
+				//-----------------------------------------------------------------
+				// A control, with its strings already converted to UTF-16.
+				//-----------------------------------------------------------------
+
+				struct Item
+				{
+					DWORD        id ;
+					WORD         classOrdinal ;
+					std::wstring className ;
+					std::wstring text ;
+					short        x ;
+					short        y ;
+					short        cx ;
+					short        cy ;
+					DWORD        style ;
+					DWORD        exStyle ;
+				} ;
+
+				void AddItem (const int id, const WORD classOrdinal, const std::wstring & className, const std::wstring & text,
+							  const short x, const short y, const short cx, const short cy,
+							  const DWORD style, const DWORD exStyle) ;
+
+				void Build () const ;
+				size_t ComputeSize () const ;
+
+				static std::wstring ToWide (const TCHAR * str) ;
+				static size_t StringSize (const std::wstring & str) ;
+				static size_t Align (const size_t offset) ;
+
+				void WriteWord (size_t & offset, const WORD value) const ;
+				void WriteDword (size_t & offset, const DWORD value) const ;
+				void WriteString (size_t & offset, const std::wstring & str) const ;
+				void WriteNameOrOrdinal (size_t & offset, const WORD ordinal, const std::wstring & str) const ;
+
+				DWORD               _helpId ;
+				DWORD               _exStyle ;
+				DWORD               _style ;
+				short               _x ;
+				short               _y ;
+				short               _cx ;
+				short               _cy ;
+				WORD                _menu ;      // Menu resource id, or 0.
+				std::wstring        _title ;
+				bool                _hasFont ;
+				WORD                _pointSize ;
+				WORD                _weight ;
+				BYTE                _italic ;
+				BYTE                _charSet ;
+				std::wstring        _typeFace ;
+				std::vector <Item>  _items ;
+
+				mutable std::vector <BYTE> _data ;     // The template, rebuilt when _modified is true.
+				mutable bool               _modified ;
+			} ;
+		}
+	}
+
+#endif
\ No newline at end of file
@@ -1145,24 +1145,46 @@ void Win::Bitmap::DIBSection::Handle::Save (const std::tstring fileName)
 	saver.close () ;
 }
 
+//--------------------------------------------------------------------
+// Packs the DIB section in a global block for the clipboard.  The
+// block is filled in a single pass:  the header, the masks and the
+// color table, then the pixels in large chunks.  A top down DIB 
+// section is written bottom up, row by row, as most applications 
+// expect.
+//
+// Return value:  The global block (HGLOBAL) containing the packed DIB.
+//--------------------------------------------------------------------
+
 BITMAPINFO * Win::Bitmap::DIBSection::Handle::CopyToClipboard ()
 {
 	DIBSECTION				  ds ;
-	DWORD					  dibSize ;
 	Win::Global::StrongHandle hGlobal ;
 	BITMAPINFO *              packedDib ;
 	RGBQUAD *				  rgb ;
-	int                       numColor ;
 	BYTE *                    bits ;
 
 	if (_bits == NULL || _h == NULL)
 		throw Win::Exception (TEXT("Error, could not send a DIB section to the clipboard")) ;
 
-	::GetObject (_h, sizeof (DIBSECTION),  &ds) ;
+	if (::GetObject (_h, sizeof (DIBSECTION),  &ds) == 0)
+		throw Win::Exception (TEXT("Error, could not send a DIB section to the clipboard")) ;
+
+	// Everything is computed from a single GetObject.
+	DWORD rowLength = ds.dsBm.bmWidthBytes ;
+	DWORD height    = ds.dsBm.bmHeight ;
+	DWORD imageSize = rowLength * height ;
+	DWORD maskSize  = ds.dsBmih.biCompression == BI_BITFIELDS ? 3 * sizeof (DWORD) : 0 ;
+	int   numColor  = 0 ;
 
-	dibSize = (GetNumColorsInTable () * sizeof (RGBQUAD)) + ds.dsBmih.biSize + (GetHeight () * GetRowLenght ()) ;
+	if (ds.dsBmih.biClrUsed != 0)
+		numColor = ds.dsBmih.biClrUsed ;
+	else if (ds.dsBm.bmBitsPixel <= 8)
+		numColor = 1 << ds.dsBm.bmBitsPixel ;
 
-	hGlobal = Win::Global::Creator::Create (dibSize, GHND | GMEM_SHARE) ;
+	DWORD dibSize = sizeof (BITMAPINFOHEADER) + maskSize + (numColor * sizeof (RGBQUAD)) + imageSize ;
+
+	// Every byte is written below, so the block does not need to be zeroed.
+	hGlobal = Win::Global::Creator::Create (dibSize, GMEM_MOVEABLE | GMEM_SHARE) ;
 	Win::Global::Lock lock (hGlobal, (void **) &packedDib) ;
 
 	if (packedDib == NULL)
@@ -1170,102 +1192,160 @@ BITMAPINFO * Win::Bitmap::DIBSection::Handle::CopyToClipboard ()
 
 	::CopyMemory (packedDib, &ds.dsBmih, sizeof (BITMAPINFOHEADER)) ;
 
+	packedDib->bmiHeader.biSize      = sizeof (BITMAPINFOHEADER) ;
+	packedDib->bmiHeader.biHeight    = height ;
+	packedDib->bmiHeader.biSizeImage = imageSize ;
+
 	rgb = (RGBQUAD *) ((BYTE *) packedDib + sizeof (BITMAPINFOHEADER)) ;
 
-	if (ds.dsBmih.biCompression == BI_BITFIELDS)
+	if (maskSize != 0)
 	{
-		::CopyMemory (rgb, ds.dsBitfields, 3 * sizeof(DWORD)) ;
+		::CopyMemory (rgb, ds.dsBitfields, maskSize) ;
 
-		rgb = (RGBQUAD *) ((BYTE *) rgb + 3 * sizeof (DWORD)) ;
+		rgb = (RGBQUAD *) ((BYTE *) rgb + maskSize) ;
 	}
 
-	numColor = GetNumColorsInTable () ;
-
 	if (numColor != 0)
 	{
 		Win::MemoryCanvas canvas (NULL) ;
 		Win::Bitmap::DIBSection::Holder hold (canvas, _h) ;
 
-		::GetDIBColorTable (canvas, 0, numColor, rgb) ;
+		UINT copied = ::GetDIBColorTable (canvas, 0, numColor, rgb) ;
+
+		if (copied < static_cast <UINT> (numColor))
+			::ZeroMemory (rgb + copied, (numColor - copied) * sizeof (RGBQUAD)) ;
 	}
 
 	bits = (BYTE *) (rgb + numColor) ;
 
-	::CopyMemory (bits, _bits, GetHeight () * GetRowLenght ()) ;
+	if (ds.dsBmih.biHeight > 0)
+	{
+		::CopyMemory (bits, _bits, imageSize) ;
+	}
+	else
+	{
+		// Top down, the last row of the DIB section is the first row of the block.
+		const BYTE * src = _bits + imageSize ;
+
+		for (DWORD y = 0 ; y < height ; ++y)
+		{
+			src -= rowLength ;
+			::CopyMemory (bits, src, rowLength) ;
+			bits += rowLength ;
+		}
+	}
 
 	HGLOBAL tmp = hGlobal.Release () ;
 	return (BITMAPINFO *) tmp ;
 
 }
 
-void Win::Bitmap::DIBSection::StrongHandle::PasteFromClipboard (BITMAPINFO * packedDib)
+//--------------------------------------------------------------------
+// Computes the layout of a packed DIB and checks that it fits in its
+// memory block.
+//
+// Return value:  A pointer on the pixels of the packed DIB.
+//
+// Parameters:
+//
+// const BITMAPINFO * packedDib -> The packed DIB.
+// const DWORD size             -> The size of the memory block in bytes.
+// DWORD & imageSize            -> Will contain the size of the pixels.
+//--------------------------------------------------------------------
+
+const BYTE * Win::Bitmap::DIBSection::GetPackedDIBBits (const BITMAPINFO * packedDib, const DWORD size, DWORD & imageSize)
 {
-	BYTE *      bits ;
-	DWORD       infoSize = 0 ;
-	DWORD       maskSize = 0;
-	DWORD       colorSize = 0;
-	int         bitCount = 0;
+	DWORD infoSize  = 0 ;
+	DWORD maskSize  = 0 ;
+	DWORD colorSize = 0 ;
+	DWORD width     = 0 ;
+	DWORD height    = 0 ;
+	DWORD bitCount  = 0 ;
 
-	if (packedDib == 0)
-	{
-		throw Win::Exception (TEXT("Error, could not pas a DIB section from the clipboard")) ;
-	}
+	if (packedDib == NULL || size < sizeof (BITMAPCOREHEADER))
+		throw Win::Exception (TEXT("Error, invalid packed DIB")) ;
 
 	infoSize = packedDib->bmiHeader.biSize ;
 
-	if (infoSize != sizeof (BITMAPCOREHEADER) && infoSize != sizeof (BITMAPINFOHEADER) && infoSize != sizeof (BITMAPV4HEADER))
-	{
-		throw Win::Exception (TEXT("Error, could not paste a DIB section")) ;
-	}
-
-	if (infoSize == sizeof (BITMAPINFOHEADER) && packedDib->bmiHeader.biCompression == BI_BITFIELDS)
-	{
-		maskSize = 3 * sizeof (DWORD) ;
-	}
-	else
-	{
-		maskSize = 0 ;
-	}
+	if (infoSize != sizeof (BITMAPCOREHEADER) && infoSize != sizeof (BITMAPINFOHEADER) && infoSize != sizeof (BITMAPV4HEADER) && infoSize != sizeof (BITMAPV5HEADER))
+		throw Win::Exception (TEXT("Error, invalid packed DIB")) ;
 
+	if (size < infoSize)
+		throw Win::Exception (TEXT("Error, invalid packed DIB")) ;
 
 	if (infoSize == sizeof (BITMAPCOREHEADER))
 	{
-		bitCount = ((BITMAPCOREHEADER *) packedDib)->bcBitCount ;
+		const BITMAPCOREHEADER * core = (const BITMAPCOREHEADER *) packedDib ;
+
+		width    = core->bcWidth ;
+		height   = core->bcHeight ;
+		bitCount = core->bcBitCount ;
 
 		if (bitCount <= 8)
-		{
 			colorSize = (1 << bitCount) * sizeof (RGBTRIPLE) ;
-		}
-		else
-		{
-			colorSize = 0 ;
-		}
 	}
 	else
 	{
-		if (packedDib->bmiHeader.biClrUsed > 0)
-		{
-			colorSize = packedDib->bmiHeader.biClrUsed * sizeof (RGBQUAD) ;
-		}
-		else if (packedDib->bmiHeader.biBitCount <= 8)
-		{
-			colorSize = (1 << packedDib->bmiHeader.biBitCount) * sizeof (RGBQUAD) ;
-		}
-		else
-			colorSize = 0 ;
+		const BITMAPINFOHEADER & header = packedDib->bmiHeader ;
+
+		if (header.biCompression != BI_RGB && header.biCompression != BI_BITFIELDS)
+			throw Win::Exception (TEXT("Error, compressed packed DIB are not supported")) ;
+
+		width    = header.biWidth < 0 ? -header.biWidth : header.biWidth ;
+		height   = header.biHeight < 0 ? -header.biHeight : header.biHeight ;
+		bitCount = header.biBitCount ;
+
+		// The masks are part of the V4 and V5 headers.
+		if (infoSize == sizeof (BITMAPINFOHEADER) && header.biCompression == BI_BITFIELDS)
+			maskSize = 3 * sizeof (DWORD) ;
+
+		if (header.biClrUsed > 0)
+			colorSize = header.biClrUsed * sizeof (RGBQUAD) ;
+		else if (bitCount <= 8)
+			colorSize = (1 << bitCount) * sizeof (RGBQUAD) ;
 	}
-	
 
-	bits = (BYTE *) packedDib ;
-		;
-	bits += infoSize + maskSize + colorSize ;
+	DWORD rowLength = ((width * bitCount + 31) / 32) * 4 ;
+	DWORD offset    = infoSize + maskSize + colorSize ;
+
+	imageSize = rowLength * height ;
+
+	if (offset > size || imageSize > size - offset || (height != 0 && imageSize / height != rowLength))
+		throw Win::Exception (TEXT("Error, the packed DIB is truncated")) ;
+
+	return (const BYTE *) packedDib + offset ;
+}
+
+//--------------------------------------------------------------------
+// Creates the DIB section from a packed DIB.  The pixels are copied
+// once, directly from the packed DIB to the DIB section.
+//
+// Parameters:
+//
+// BITMAPINFO * packedDib -> The packed DIB.
+// const DWORD size       -> Size of the memory block containing the
+//							 packed DIB.
+//--------------------------------------------------------------------
+
+void Win::Bitmap::DIBSection::StrongHandle::PasteFromClipboard (BITMAPINFO * packedDib, const DWORD size)
+{
+	DWORD        imageSize ;
+	const BYTE * bits = GetPackedDIBBits (packedDib, size, imageSize) ;
+
+	BYTE *  pixels = NULL ;
+	HBITMAP h      = ::CreateDIBSection (NULL, packedDib, DIB_RGB_COLORS, reinterpret_cast <void **> (&pixels),NULL, 0);
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not paste a DIB section from the clipboard")) ;
 
-	_h = ::CreateDIBSection (NULL, packedDib, DIB_RGB_COLORS, reinterpret_cast <void **> (&_bits),NULL, 0);
+	// Owned through the constructor, so that the handle is counted.
+	Win::Bitmap::DIBSection::StrongHandle created (h, pixels) ;
 
-	if (_h == NULL || bits == NULL)
+	if (pixels == NULL)
 		throw Win::Exception (TEXT("Error, could not paste a DIB section from the clipboard")) ;
 
-	::CopyMemory (_bits, bits,GetHeight () * GetRowLenght ()) ;
+	*this = created ;
+	::CopyMemory (_bits, bits, imageSize) ;
 }
 
 //--------------------------------------------------------------------
@@ -1282,7 +1362,6 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadFile
 {
 	BITMAPFILEHEADER bmfh;
 	BITMAPINFO     * pbmi;
-	Win::Bitmap::DIBSection::StrongHandle bitmap ;
 	int              sizeInfo;
 	int              sizeBit;
 
@@ -1329,15 +1408,18 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadFile
 		throw Win::Exception (TEXT("Could not read the bitmap file"));
 	}
 
-	bitmap._h = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bitmap._bits),NULL, 0);
+	BYTE *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bits),NULL, 0);
 
-	if (!bitmap._h)
+	if (h == NULL)
 	{
 		reader.close () ;
 		free (pbmi) ;
 		throw Win::Exception (TEXT("Could not cteatre a DIB section"));
 	}
 
+	Win::Bitmap::DIBSection::StrongHandle bitmap (h, bits) ;
+
 	free (pbmi);
 
 	sizeBit = bmfh.bfSize - bmfh.bfOffBits;
@@ -1370,7 +1452,6 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 {
 	BITMAPFILEHEADER bmfh;
 	BITMAPINFO     * pbmi;
-	Win::Bitmap::DIBSection::StrongHandle bitmap ;
 	int              sizeInfo;
 	int              sizeBit;
 	HGLOBAL          resource ;
@@ -1408,9 +1489,10 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 
 	pResource += sizeInfo ;
 
-	bitmap._h = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bitmap._bits),NULL, 0);
+	BYTE *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bits),NULL, 0);
 
-	if (!bitmap._h)
+	if (h == NULL)
 	{
 		free (pbmi);
 		::FreeResource (resource) ;
@@ -1418,6 +1500,8 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 		throw Win::Exception (TEXT("Could not cteatre a DIB section"));
 	}
 
+	Win::Bitmap::DIBSection::StrongHandle bitmap (h, bits) ;
+
 	free (pbmi);
 
 	sizeBit = bmfh.bfSize - bmfh.bfOffBits;
@@ -1444,7 +1528,6 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 {
 	BITMAPFILEHEADER bmfh;
 	BITMAPINFO     * pbmi;
-	Win::Bitmap::DIBSection::StrongHandle bitmap ;
 	int              sizeInfo;
 	int              sizeBit;
 	HGLOBAL          resource ;
@@ -1482,9 +1565,10 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 
 	pResource += sizeInfo ;
 
-	bitmap._h = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bitmap._bits),NULL, 0);
+	BYTE *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bits),NULL, 0);
 
-	if (!bitmap._h)
+	if (h == NULL)
 	{
 		free (pbmi);
 		::FreeResource (resource) ;
@@ -1492,6 +1576,8 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Loader::LoadResou
 		throw Win::Exception (TEXT("Could not cteatre a DIB section"));
 	}
 
+	Win::Bitmap::DIBSection::StrongHandle bitmap (h, bits) ;
+
 	free (pbmi);
 
 	sizeBit = bmfh.bfSize - bmfh.bfOffBits;
@@ -1513,7 +1599,6 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Creator::Create (
 {
 	BITMAPINFO * pbmi;
 	int entries = 1;
-	Win::Bitmap::DIBSection::StrongHandle bitmap ;
 
 	assert (width > 0 && height > 0 && (colorBits == 1 || colorBits == 4 || colorBits == 8 || colorBits == 16 || colorBits == 24 || colorBits == 32));
 
@@ -1541,14 +1626,17 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Creator::Create (
 	pbmi->bmiHeader.biClrUsed = colorUsed;
 	pbmi->bmiHeader.biClrImportant = 0;
 
-	bitmap._h = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bitmap._bits),NULL, 0);
+	BYTE *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bits),NULL, 0);
 
-	if (!bitmap._h)
+	if (h == NULL)
 	{
 		free (pbmi);
 		throw Win::Exception (TEXT("Could not cteatre a DIB section"));
 	}
 
+	Win::Bitmap::DIBSection::StrongHandle bitmap (h, bits) ;
+
 	free (pbmi);
 
 	memset (bitmap._bits, 0, bitmap.GetHeight () * bitmap.GetRowLenght ()) ;
@@ -1567,7 +1655,6 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Creator::Create (
 {
 	BITMAPINFO * pbmi;
 	int entries = 1;
-	Win::Bitmap::DIBSection::StrongHandle bitmap ;
 
 	assert (_width > 0 && _height > 0 && (_colorBits == 1 || _colorBits == 4 || _colorBits == 8 || _colorBits == 16 || _colorBits == 24 || _colorBits == 32));
 
@@ -1595,14 +1682,17 @@ Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::DIBSection::Creator::Create (
 	pbmi->bmiHeader.biClrUsed = _colorUsed;
 	pbmi->bmiHeader.biClrImportant = 0;
 
-	bitmap._h = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bitmap._bits),NULL, 0);
+	BYTE *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, pbmi, DIB_RGB_COLORS, reinterpret_cast <void **> (&bits),NULL, 0);
 
-	if (!bitmap._h)
+	if (h == NULL)
 	{
 		free (pbmi);
 		throw Win::Exception (TEXT("Could not cteatre a DIB section"));
 	}
 
+	Win::Bitmap::DIBSection::StrongHandle bitmap (h, bits) ;
+
 	free (pbmi);
 
 	memset (bitmap._bits, 0, bitmap.GetHeight () * bitmap.GetRowLenght ()) ;
@@ -1706,7 +1796,8 @@ void Win::Bitmap::DIBSection::PixelPlotter::PlotMaker ()
 		}
 	}
 
-	_ptr.Resize (ds.dsBm.bmHeight);
+	// Every row is set below, the old rows need not be kept.
+	_ptr.ReAllocate (ds.dsBm.bmHeight);
 
 	rowLenght = _h.GetRowLenght ();
 
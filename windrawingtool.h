@@ -662,16 +662,18 @@
 					{
 
 						StrongHandle tmp = sh ;
-						std::swap (_h, tmp._h) ;
+						Swap (tmp) ;
 						_bits = sh._bits ;
 						return *this ;
 					}
 
 				protected:
 
-					void PasteFromClipboard (BITMAPINFO * packedDib) ;
+					void PasteFromClipboard (BITMAPINFO * packedDib, const DWORD size) ;
 				} ;
 
+				const BYTE * GetPackedDIBBits (const BITMAPINFO * packedDib, const DWORD size, DWORD & imageSize) ;
+
 				//---------------------------------------------------------------------
 				// Win::Bitmap::DIBSection::Loader is used to load a DIBSection from
 				// a file or a resource.
@@ -872,7 +874,7 @@
 				private:
 
 					Win::Bitmap::DIBSection::Handle _h ;
-					StrongArrayPointer <BYTE *>    _ptr ;
+					StrongArrayPointer <BYTE *, 64> _ptr ; // Rows of the bitmap, inline up to 64 rows.
 					unsigned int					_rightShift [3] ;
 					unsigned int					_leftShift  [3] ;
 					unsigned int					_bitFields  [3] ;					
@@ -61,3 +61,266 @@ Win::Global::Handle Win::Global::Creator::CreateClipboardHandle (DWORD size)
 
 	 return Win::Global::Handle (h) ;
 }
+
+
+//------------------------------------------------------------------
+// Constructor.  Creates an empty pool.
+//
+// Parameters:
+//
+// const DWORD maxBytesHeld -> Maximum size of the released blocks kept
+//							   by the pool.
+//------------------------------------------------------------------
+
+Win::Global::Pool::Pool (const DWORD maxBytesHeld)
+	: _maxBytesHeld (maxBytesHeld)
+{
+	_stats.allocations = 0 ;
+	_stats.reuses      = 0 ;
+	_stats.bytesHeld   = 0 ;
+}
+
+//------------------------------------------------------------------
+// Destructor.  Frees all the blocks kept by the pool.
+//------------------------------------------------------------------
+
+Win::Global::Pool::~Pool ()
+{
+	Clear () ;
+}
+
+//------------------------------------------------------------------
+// Obtains a block from the pool, or creates one if none is available.
+// Blocks bigger than the biggest size class are not pooled.
+//
+// Return value:  The handle of the block, owned by the caller.  It
+//				  must be given back with Release or freed with
+//				  GlobalFree.
+//
+// Parameters:
+//
+// const DWORD size  -> The minimum size of the block.
+// const bool zeroed -> True if the block must be zeroed.
+//------------------------------------------------------------------
+
+HGLOBAL Win::Global::Pool::Acquire (const DWORD size, const bool zeroed)
+{
+	int sizeClass = GetClass (size) ;
+
+	if (sizeClass < NbClass)
+	{
+		SizeClass & sc = _classes [sizeClass] ;
+		HGLOBAL     h  = NULL ;
+
+		if (!sc.clean.empty ())
+		{
+			h = sc.clean.back () ;
+			sc.clean.pop_back () ;
+		}
+		else if (!sc.dirty.empty ())
+		{
+			h = sc.dirty.back () ;
+			sc.dirty.pop_back () ;
+
+			if (zeroed)
+			{
+				void * data ;
+				Win::Global::Lock lock (h, &data) ;
+				::ZeroMemory (data, GetClassSize (sizeClass)) ;
+			}
+		}
+
+		if (h != NULL)
+		{
+			++_stats.reuses ;
+			_stats.bytesHeld -= GetClassSize (sizeClass) ;
+			return h ;
+		}
+	}
+
+	DWORD   allocSize = sizeClass < NbClass ? GetClassSize (sizeClass) : size ;
+	HGLOBAL h         = ::GlobalAlloc (GMEM_MOVEABLE | GMEM_SHARE | (zeroed ? GMEM_ZEROINIT : 0), allocSize) ;
+
+	if (h == NULL) 
+		throw Win::Exception (TEXT("Error, could not create a global handle.")) ; 
+
+	++_stats.allocations ;
+	return h ;
+}
+
+//------------------------------------------------------------------
+// Gives a block back to the pool.  The block is freed if it is too
+// big or if the pool already holds too much memory.
+//
+// Parameters:
+//
+// const HGLOBAL h -> The block, obtained with Acquire.  Must not be
+//					  locked.
+//------------------------------------------------------------------
+
+void Win::Global::Pool::Release (const HGLOBAL h)
+{
+	if (h == NULL)
+		return ;
+
+	int sizeClass = GetClass (static_cast <DWORD> (::GlobalSize (h))) ;
+
+	if (sizeClass >= NbClass || GetClassSize (sizeClass) != ::GlobalSize (h) || _stats.bytesHeld + GetClassSize (sizeClass) > _maxBytesHeld)
+	{
+		::GlobalFree (h) ;
+		return ;
+	}
+
+	_classes [sizeClass].dirty.push_back (h) ;
+	_stats.bytesHeld += GetClassSize (sizeClass) ;
+}
+
+//------------------------------------------------------------------
+// Creates zeroed blocks in advance, for example at startup.
+//
+// Parameters:
+//
+// const DWORD size -> The size of the blocks.
+// const int count  -> The number of blocks.
+//------------------------------------------------------------------
+
+void Win::Global::Pool::Reserve (const DWORD size, const int count)
+{
+	int sizeClass = GetClass (size) ;
+
+	if (sizeClass >= NbClass)
+		return ;
+
+	for (int i = 0 ; i < count && _stats.bytesHeld + GetClassSize (sizeClass) <= _maxBytesHeld ; ++i)
+	{
+		HGLOBAL h = ::GlobalAlloc (GMEM_MOVEABLE | GMEM_SHARE | GMEM_ZEROINIT, GetClassSize (sizeClass)) ;
+
+		if (h == NULL) 
+			throw Win::Exception (TEXT("Error, could not create a global handle.")) ; 
+
+		++_stats.allocations ;
+		_classes [sizeClass].clean.push_back (h) ;
+		_stats.bytesHeld += GetClassSize (sizeClass) ;
+	}
+}
+
+//------------------------------------------------------------------
+// Zeroes some of the released blocks.  Should be called when the 
+// application is idle, so that zeroed blocks are ready when needed.
+//
+// Return value:  True if some blocks still need to be zeroed.
+//
+// Parameters:
+//
+// const int maxBlocks -> Maximum number of blocks to zero.
+//------------------------------------------------------------------
+
+bool Win::Global::Pool::Idle (const int maxBlocks)
+{
+	int done = 0 ;
+
+	for (int i = 0 ; i < NbClass ; ++i)
+	{
+		SizeClass & sc = _classes [i] ;
+
+		while (!sc.dirty.empty ())
+		{
+			if (done == maxBlocks)
+				return true ;
+
+			HGLOBAL h = sc.dirty.back () ;
+			sc.dirty.pop_back () ;
+
+			void * data ;
+			{
+				Win::Global::Lock lock (h, &data) ;
+				::ZeroMemory (data, GetClassSize (i)) ;
+			}
+
+			sc.clean.push_back (h) ;
+			++done ;
+		}
+	}
+
+	return false ;
+}
+
+//------------------------------------------------------------------
+// Frees all the blocks kept by the pool.
+//------------------------------------------------------------------
+
+void Win::Global::Pool::Clear ()
+{
+	for (int i = 0 ; i < NbClass ; ++i)
+	{
+		SizeClass & sc = _classes [i] ;
+
+		for (size_t j = 0 ; j < sc.clean.size () ; ++j)
+			::GlobalFree (sc.clean [j]) ;
+
+		for (size_t j = 0 ; j < sc.dirty.size () ; ++j)
+			::GlobalFree (sc.dirty [j]) ;
+
+		sc.clean.clear () ;
+		sc.dirty.clear () ;
+	}
+
+	_stats.bytesHeld = 0 ;
+}
+
+//------------------------------------------------------------------
+// Unlocks the block and gives up ownership, to hand it to another
+// process or to code that frees it with GlobalFree.  The block will
+// not be given back to the pool.  A reused block still holds the data
+// of earlier leases past the requested size and is bigger than
+// requested, while the receivers size the data with GlobalSize:  the
+// bytes past the requested size are cleared and the block is shrunk to
+// the requested size.
+//
+// Return value:  The handle of the block.
+//------------------------------------------------------------------
+
+Win::Global::Handle Win::Global::Lease::Detach ()
+{
+	HGLOBAL h     = _h ;
+	SIZE_T  total = ::GlobalSize (h) ;
+
+	// Cleared first, in case the block can not be shrunk.
+	if (total > _size)
+		::ZeroMemory (static_cast <BYTE *> (_data) + _size, total - _size) ;
+
+	::GlobalUnlock (h) ;
+	_h    = NULL ;
+	_data = NULL ;
+
+	if (total > _size && _size != 0)
+	{
+		HGLOBAL shrunk = ::GlobalReAlloc (h, _size, 0) ;
+
+		if (shrunk != NULL)
+			h = shrunk ;
+	}
+
+	return h ;
+}
+
+//------------------------------------------------------------------
+// Finds the size class of a block.
+//
+// Return value:  The smallest size class that can hold the block, or
+//				  NbClass if the block is too big to be pooled.
+//
+// Parameters:
+//
+// const DWORD size -> The size of the block.
+//------------------------------------------------------------------
+
+int Win::Global::Pool::GetClass (const DWORD size)
+{
+	int sizeClass = 0 ;
+
+	while (sizeClass < NbClass && GetClassSize (sizeClass) < size)
+		++sizeClass ;
+
+	return sizeClass ;
+}
\ No newline at end of file
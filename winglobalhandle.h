@@ -7,6 +7,8 @@
 	#define WINGLOBALHANDLE_H
 	#include "useunicode.h"
 	#include "winhandle.h"
+	#include "winexception.h"
+	#include <vector>
 
 	namespace Win
 	{
@@ -170,6 +172,172 @@
 				UINT _flag ;
 
 			} ;
+
+			//------------------------------------------------------------------
+			// Win::Global::Pool keeps released global blocks to reuse them
+			// instead of calling GlobalAlloc and GlobalFree each time.  Blocks
+			// are moveable and shareable, and their size is rounded up to a 
+			// power of two (the size class).  Released blocks can be zeroed
+			// later in Idle, so that asking for zeroed memory does not cost
+			// anything when it is needed.
+			//
+			// Since blocks can be bigger than requested, GlobalSize must not
+			// be used to find the size of the data they contain.  Blocks given
+			// to another process (clipboard, DDE, drag and drop) must be
+			// handed off with Win::Global::Lease::Detach, which trims them to
+			// the requested size.
+			//------------------------------------------------------------------
+
+			class Pool
+			{
+			public:
+
+				//------------------------------------------------------------------
+				// Statistics about the pool.
+				//------------------------------------------------------------------
+
+				struct Stats
+				{
+					DWORD allocations ; // Calls to GlobalAlloc.
+					DWORD reuses ;      // Allocations avoided by reusing a block.
+					DWORD bytesHeld ;   // Size of the released blocks kept by the pool.
+				} ;
+
+				Pool (const DWORD maxBytesHeld = 64 * 1024 * 1024) ;
+				~Pool () ;
+
+				HGLOBAL Acquire (const DWORD size, const bool zeroed = false) ;
+				void Release (const HGLOBAL h) ;
+				void Reserve (const DWORD size, const int count) ;
+				bool Idle (const int maxBlocks = 1) ;
+				void Clear () ;
+
+				//------------------------------------------------------------------
+				// Obtains statistics about the pool.
+				//
+				// Return value:  The statistics.
+				//------------------------------------------------------------------
+
+				const Stats & GetStats () const
+				{
+					return _stats ;
+				}
+
+			private:
+
+				Pool (const Pool &) ;
+				Pool & operator = (const Pool &) ;
+
+				enum 
+				{
+					MinClassShift = 8,  // Smallest size class is 256 bytes.
+					NbClass       = 17  // Biggest size class is 16 MB.
+				} ;
+
+				//------------------------------------------------------------------
+				// The released blocks of a size class.
+				//------------------------------------------------------------------
+
+				struct SizeClass
+				{
+					std::vector <HGLOBAL> clean ; // Zeroed blocks.
+					std::vector <HGLOBAL> dirty ; // Blocks that still contain data.
+				} ;
+
+				static int GetClass (const DWORD size) ;
+
+				//------------------------------------------------------------------
+				// Obtains the size of the blocks of a size class.
+				//------------------------------------------------------------------
+
+				static DWORD GetClassSize (const int sizeClass)
+				{
+					return 1UL << (sizeClass + MinClassShift) ;
+				}
+
+				SizeClass _classes [NbClass] ;
+				DWORD     _maxBytesHeld ;       // The pool frees blocks above this size.
+				Stats     _stats ;
+			} ;
+
+			//------------------------------------------------------------------
+			// Win::Global::Lease obtains a block from a Win::Global::Pool and
+			// locks it.  When the object is destroyed, the block is unlocked 
+			// and given back to the pool unless it was detached, for example
+			// to give it to the clipboard.  Only the requested size must be
+			// written:  Detach clears and cuts off the rest of the block.
+			//------------------------------------------------------------------
+
+			class Lease
+			{
+			public:
+
+				//------------------------------------------------------------------
+				// Constructor.  Obtains a block and locks it.
+				//
+				// Parameters:
+				//
+				// Win::Global::Pool & pool -> The pool giving the block.
+				// const DWORD size         -> The minimum size of the block.
+				// const bool zeroed        -> True if the block must be zeroed.
+				//------------------------------------------------------------------
+
+				Lease (Win::Global::Pool & pool, const DWORD size, const bool zeroed = false)
+					: _pool (pool),
+					  _h (pool.Acquire (size, zeroed)),
+					  _data (::GlobalLock (_h)),
+					  _size (size)
+				{
+					if (_data == NULL)
+					{
+						_pool.Release (_h) ;
+						throw Win::Exception (TEXT("Error, could not lock a global handle.")) ;
+					}
+				}
+
+				//------------------------------------------------------------------
+				// Destructor.  Unlocks the block and gives it back to the pool.
+				//------------------------------------------------------------------
+
+				~Lease ()
+				{
+					if (_h != NULL)
+					{
+						::GlobalUnlock (_h) ;
+						_pool.Release (_h) ;
+					}
+				}
+
+				//------------------------------------------------------------------
+				// Obtains a pointer on the data of the block.
+				//------------------------------------------------------------------
+
+				void * GetData () const
+				{
+					return _data ;
+				}
+
+				//------------------------------------------------------------------
+				// Obtains the size requested for the block.
+				//------------------------------------------------------------------
+
+				DWORD GetSize () const
+				{
+					return _size ;
+				}
+
+				Win::Global::Handle Detach () ;
+
+			private:
+
+				Lease (const Lease &) ;
+				Lease & operator = (const Lease &) ;
+
+				Win::Global::Pool & _pool ;
+				HGLOBAL             _h ;
+				void *              _data ;
+				DWORD               _size ;  // Size requested, the block can be bigger.
+			} ;
 		}
 	}
 
@@ -4,6 +4,12 @@
 	#include "useunicode.h"
 	#include <windows.h>
 
+	#if ___TRACKHANDLES___ == 1
+		#include "winhandletracker.h"
+		#include <intrin.h>
+		#pragma intrinsic (_ReturnAddress)
+	#endif
+
 	namespace Sys
 	{
 
@@ -163,6 +169,9 @@
 
 			StrongHandle (typename BaseHandle::Type const & h = NULL) 
 				: BaseHandle (h)
+			#if ___TRACKHANDLES___ == 1
+				, _site (h != NULL ? Sys::HandleTracker::OnCreate (_type, __FUNCSIG__, _ReturnAddress ()) : NULL)
+			#endif
 			{}
 
 			//------------------------------------------------------------------
@@ -173,7 +182,10 @@
 			~StrongHandle ()
 			{	
 				if (!IsNull ())
+				{
+					Untrack () ;
 					DisposalPolicy::Dispose (_h) ;
+				}
 			}
 
 			//------------------------------------------------------------------
@@ -196,8 +208,14 @@
 
 			StrongHandle (StrongHandle & sh)
 				: BaseHandle (sh)
+			#if ___TRACKHANDLES___ == 1
+				, _site (sh._site)
+			#endif
 			{
 				sh._h = NULL ;
+			#if ___TRACKHANDLES___ == 1
+				sh._site = NULL ;
+			#endif
 			}
 
 			//------------------------------------------------------------------
@@ -214,20 +232,67 @@
 			{
 
 				StrongHandle tmp = sh ;
-				std::swap (_h, tmp._h) ;
+				Swap (tmp) ;
 				return *this ;
 			}
 
+			//------------------------------------------------------------------
+			// Exchanges the windows handles of two Sys::StrongHandle objects.
+			// Nothing is destroyed.
+			//
+			// Parameters:
+			// 
+			// StrongHandle & sh -> The other object.
+			//------------------------------------------------------------------
+
+			void Swap (StrongHandle & sh)
+			{
+				typename BaseHandle::Type tmp = _h ;
+				_h    = sh._h ;
+				sh._h = tmp ;
+
+			#if ___TRACKHANDLES___ == 1
+				Sys::HandleTracker::Site * site = _site ;
+				_site    = sh._site ;
+				sh._site = site ;
+			#endif
+			}
+
 			BaseHandle Release ()
 			{
 				BaseHandle h = _h ;
+				Untrack () ;
 				_h = NULL ;
 
 				return h ;
 			}
 
+		private:
+
+			//------------------------------------------------------------------
+			// Stops counting the handle, which is destroyed or released.
+			//------------------------------------------------------------------
+
+			void Untrack ()
+			{
+			#if ___TRACKHANDLES___ == 1
+				Sys::HandleTracker::OnDestroy (_type, _site) ;
+				_site = NULL ;
+			#endif
+			}
+
+		#if ___TRACKHANDLES___ == 1
+			Sys::HandleTracker::Site * _site ; // Counters of the place that created the handle.
+			static Sys::HandleType     _type ; // Counters of this type of strong handle.
+		#endif
+
 			
 		
 		} ;
+
+	#if ___TRACKHANDLES___ == 1
+		template <class BaseHandle, class DisposalPolicy>
+		Sys::HandleType StrongHandle <BaseHandle, DisposalPolicy>::_type = {NULL, 0, 0, 0, NULL} ;
+	#endif
 	}
 #endif
\ No newline at end of file
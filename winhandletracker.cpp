@@ -0,0 +1,209 @@
+#include "winhandletracker.h"
+#include <sstream>
+
+Sys::HandleTracker::Site  Sys::HandleTracker::_sites [SiteCount] ;
+Sys::HandleTracker::Site  Sys::HandleTracker::_overflow ;
+Sys::HandleType *         Sys::HandleTracker::_types = NULL ;
+
+namespace
+{
+	// Innermost SYS_HANDLE_SITE of the current thread.
+	__declspec (thread) const Sys::HandleSite * s_label = NULL ;
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Makes a site the current one of the thread.
+//
+// Parameters:
+//
+// const HandleSite & site -> The site.
+//-----------------------------------------------------------------
+
+Sys::HandleTracker::Scope::Scope (const HandleSite & site)
+	: _previous (s_label)
+{
+	s_label = &site ;
+}
+
+//-----------------------------------------------------------------
+// Destructor.  Restores the previous site.
+//-----------------------------------------------------------------
+
+Sys::HandleTracker::Scope::~Scope ()
+{
+	s_label = _previous ;
+}
+
+//-----------------------------------------------------------------
+// Counts a handle taken by a strong handle.
+//
+// Return value:  The site of the handle, to be passed to OnDestroy.
+//
+// Parameters:
+//
+// HandleType & type     -> Counters of the type of strong handle.
+// const char * name     -> Name of the type.
+// const void * address  -> Code that created the strong handle.
+//-----------------------------------------------------------------
+
+Sys::HandleTracker::Site * Sys::HandleTracker::OnCreate (HandleType & type, const char * name, const void * address)
+{
+	if (type.registered == 0)
+		Register (type, name) ;
+
+	RaisePeak (type.peak, ::InterlockedIncrement (&type.live)) ;
+
+	const HandleSite * label = s_label ;
+	Site * site = FindSite (type, label != NULL ? NULL : address, label) ;
+
+	RaisePeak (site->peak, ::InterlockedIncrement (&site->live)) ;
+	::InterlockedIncrement (&site->created) ;
+
+	return site ;
+}
+
+//-----------------------------------------------------------------
+// Counts a handle destroyed or released by a strong handle.
+//
+// Parameters:
+//
+// HandleType & type -> Counters of the type of strong handle.
+// Site * site       -> The site returned by OnCreate, can be NULL if
+//						the handle was not counted.
+//-----------------------------------------------------------------
+
+void Sys::HandleTracker::OnDestroy (HandleType & type, Site * site)
+{
+	if (site == NULL)
+		return ;
+
+	::InterlockedDecrement (&site->live) ;
+	::InterlockedDecrement (&type.live) ;
+}
+
+//-----------------------------------------------------------------
+// Writes the counters of the types and of their sites.
+//
+// Parameters:
+//
+// std::ostream & out -> The stream receiving the counters.
+//-----------------------------------------------------------------
+
+void Sys::HandleTracker::Dump (std::ostream & out)
+{
+	for (HandleType * type = _types ; type != NULL ; type = type->next)
+	{
+		out << type->name << ": live " << type->live << ", peak " << type->peak << '\n' ;
+
+		for (int i = 0 ; i < SiteCount ; ++i)
+		{
+			const Site & site = _sites [i] ;
+
+			if (site.state != Published || site.type != type)
+				continue ;
+
+			out << "    " ;
+
+			if (site.label != NULL)
+				out << site.label->file << '(' << site.label->line << ')' ;
+			else
+				out << site.address ;
+
+			out << ": live " << site.live << ", peak " << site.peak << ", created " << site.created << '\n' ;
+		}
+	}
+
+	if (_overflow.created != 0)
+		out << "Other sites: live " << _overflow.live << ", peak " << _overflow.peak << ", created " << _overflow.created << '\n' ;
+}
+
+//-----------------------------------------------------------------
+// Writes the counters in the output window of the debugger.
+//-----------------------------------------------------------------
+
+void Sys::HandleTracker::DumpToDebugger ()
+{
+	std::ostringstream out ;
+	Dump (out) ;
+	::OutputDebugStringA (out.str ().c_str ()) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a type to the list, once.
+//-----------------------------------------------------------------
+
+void Sys::HandleTracker::Register (HandleType & type, const char * name)
+{
+	if (::InterlockedCompareExchange (&type.registered, 1, 0) != 0)
+		return ;
+
+	type.name = name ;
+
+	HandleType * head ;
+
+	do
+	{
+		head = _types ;
+		type.next = head ;
+	}
+	while (::InterlockedCompareExchangePointer (reinterpret_cast <PVOID volatile *> (&_types), &type, head) != head) ;
+}
+
+//-----------------------------------------------------------------
+// Finds the counters of a type at a site, adding them to the table
+// the first time.  A slot is claimed with an interlocked exchange,
+// filled, then published.
+//-----------------------------------------------------------------
+
+Sys::HandleTracker::Site * Sys::HandleTracker::FindSite (HandleType & type, const void * address, const HandleSite * label)
+{
+	ULONG_PTR bits = reinterpret_cast <ULONG_PTR> (address) ^ reinterpret_cast <ULONG_PTR> (label)
+				   ^ (reinterpret_cast <ULONG_PTR> (&type) >> 4) ;
+	bits ^= bits >> 16 ;
+	bits *= 0x45d9f3b ;
+	bits ^= bits >> 16 ;
+
+	size_t index = static_cast <size_t> (bits) & (SiteCount - 1) ;
+
+	for (int probe = 0 ; probe < SiteCount ; ++probe, index = (index + 1) & (SiteCount - 1))
+	{
+		Site & site = _sites [index] ;
+
+		if (site.state == Empty && ::InterlockedCompareExchange (&site.state, Claimed, Empty) == Empty)
+		{
+			site.address = address ;
+			site.label   = label ;
+			site.type    = &type ;
+			::InterlockedExchange (&site.state, Published) ;
+			return &site ;
+		}
+
+		// Another thread is filling the slot.
+		while (site.state == Claimed)
+			::Sleep (0) ;
+
+		if (site.address == address && site.label == label && site.type == &type)
+			return &site ;
+	}
+
+	return &_overflow ;
+}
+
+//-----------------------------------------------------------------
+// Raises a high-water mark to a new count if it is higher.
+//-----------------------------------------------------------------
+
+void Sys::HandleTracker::RaisePeak (volatile LONG & peak, const LONG live)
+{
+	LONG current = peak ;
+
+	while (live > current)
+	{
+		LONG previous = ::InterlockedCompareExchange (&peak, live, current) ;
+
+		if (previous == current)
+			break ;
+
+		current = previous ;
+	}
+}
\ No newline at end of file
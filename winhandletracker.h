@@ -0,0 +1,125 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Sys::HandleTracker.
+//-----------------------------------------------------------------
+
+#if !defined (WINHANDLETRACKER_H)
+
+	#define WINHANDLETRACKER_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include <ostream>
+
+	namespace Sys
+	{
+		//-----------------------------------------------------------------
+		// Counters of the live handles of one type of Sys::StrongHandle.
+		// Each type of strong handle has one, it is added to the list of
+		// the tracker when its first handle is created.
+		//-----------------------------------------------------------------
+
+		struct HandleType
+		{
+			const char *  name ;       // Signature naming the type.
+			volatile LONG live ;       // Handles not yet destroyed.
+			volatile LONG peak ;       // Highest value of live.
+			volatile LONG registered ; // Not 0 once in the list.
+			HandleType *  next ;       // Next type in the list.
+		} ;
+
+		//-----------------------------------------------------------------
+		// A place in the code that creates handles.  Declared by
+		// SYS_HANDLE_SITE.
+		//-----------------------------------------------------------------
+
+		struct HandleSite
+		{
+			const char * file ;
+			int          line ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// Sys::HandleTracker counts the handles owned by the strong handles
+		// when ___TRACKHANDLES___ is set to 1 in useunicode.h.  The live
+		// handles and their high-water mark are counted for each type of
+		// handle and for each place that created them.  The place is the
+		// innermost SYS_HANDLE_SITE of the thread if there is one, else
+		// the address of the code that created the strong handle.  Dump
+		// writes the counters, to find the code that leaks handles before
+		// the limit of 10000 GDI or USER objects of a process is reached.
+		//
+		// The counters are kept in fixed tables and updated with
+		// interlocked operations, so they can be used from any thread
+		// without a lock.
+		//-----------------------------------------------------------------
+
+		class HandleTracker
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Counters of the handles of one type created at one place.
+			//-----------------------------------------------------------------
+
+			struct Site
+			{
+				volatile LONG      state ;   // Empty, Claimed or Published.
+				const void *       address ; // Code that created the handles.
+				const HandleSite * label ;   // SYS_HANDLE_SITE, or NULL.
+				HandleType *       type ;    // Type of the handles.
+				volatile LONG      live ;    // Handles not yet destroyed.
+				volatile LONG      peak ;    // Highest value of live.
+				volatile LONG      created ; // Handles created.
+			} ;
+
+			//-----------------------------------------------------------------
+			// Makes a SYS_HANDLE_SITE the current one of the thread for its
+			// scope.
+			//-----------------------------------------------------------------
+
+			class Scope
+			{
+			public:
+
+				Scope (const HandleSite & site) ;
+				~Scope () ;
+
+			private:
+
+				const HandleSite * _previous ; // Site that was current before.
+
+				Scope (const Scope &) ;
+				Scope & operator = (const Scope &) ;
+			} ;
+
+			enum { SiteCount = 4096 } ; // Number of places that can be told apart.
+
+			static Site * OnCreate (HandleType & type, const char * name, const void * address) ;
+			static void OnDestroy (HandleType & type, Site * site) ;
+
+			static void Dump (std::ostream & out) ;
+			static void DumpToDebugger () ;
+
+		private:
+
+			enum { Empty, Claimed, Published } ;
+
+			static void Register (HandleType & type, const char * name) ;
+			static Site * FindSite (HandleType & type, const void * address, const HandleSite * label) ;
+			static void RaisePeak (volatile LONG & peak, const LONG live) ;
+
+			static Site         _sites [SiteCount] ; // Open addressing table of the sites.
+			static Site         _overflow ;          // Used when the table is full.
+			static HandleType * _types ;             // List of the types.
+		} ;
+	}
+
+	//-----------------------------------------------------------------
+	// Attributes the handles created by the thread until the end of the
+	// enclosing scope to this line.
+	//-----------------------------------------------------------------
+
+	#define SYS_HANDLE_SITE() \
+		static const Sys::HandleSite sysHandleSite = {__FILE__, __LINE__} ; \
+		Sys::HandleTracker::Scope sysHandleScope (sysHandleSite)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include "winiconcache.h"
+#include "wincustomres.h"
+#include "winexception.h"
+
+//-----------------------------------------------------------------
+// Reads the content of a RT_GROUP_ICON or RT_GROUP_CURSOR resource.
+// Throws a Win::ResourceTruncatedException if the data is too short.
+//
+// Parameters:
+//
+// const void * data -> The data of the resource.
+// const DWORD size  -> The size of the data in bytes.
+//-----------------------------------------------------------------
+
+void Win::IconDirectory::Parse (const void * data, const DWORD size)
+{
+	Win::ResourceReader reader (data, size) ;
+
+	WORD reserved = reader.Read <WORD> () ;
+	WORD type     = reader.Read <WORD> () ;
+	WORD count    = reader.Read <WORD> () ;
+
+	if (reserved != 0 || (type != 1 && type != 2))
+		throw Win::Exception (TEXT("Error, invalid icon directory")) ;
+
+	std::vector <Entry> entries (count) ;
+
+	for (WORD i = 0 ; i < count ; ++i)
+	{
+		Entry & entry = entries [i] ;
+
+		if (type == 1)
+		{
+			// Icons:  sizes are bytes where 0 means 256.
+			BYTE width      = reader.Read <BYTE> () ;
+			BYTE height     = reader.Read <BYTE> () ;
+			BYTE colorCount = reader.Read <BYTE> () ;
+
+			reader.Skip (sizeof (BYTE) + sizeof (WORD)) ; // Reserved and planes.
+
+			entry.width    = width  == 0 ? 256 : width ;
+			entry.height   = height == 0 ? 256 : height ;
+			entry.bitCount = reader.Read <WORD> () ;
+
+			// Old resources give the number of colors instead.
+			if (entry.bitCount == 0)
+				entry.bitCount = colorCount == 0 ? 8 : colorCount <= 2 ? 1 : colorCount <= 16 ? 4 : 8 ;
+		}
+		else
+		{
+			// Cursors:  the height includes the mask, twice the image.
+			entry.width  = reader.Read <WORD> () ;
+			entry.height = reader.Read <WORD> () / 2 ;
+
+			reader.Skip (sizeof (WORD)) ; // Planes.
+
+			entry.bitCount = reader.Read <WORD> () ;
+		}
+
+		reader.Skip (sizeof (DWORD)) ; // Size of the image.
+		entry.id = reader.Read <WORD> () ;
+	}
+
+	_entries.swap (entries) ;
+	_cursor = type == 2 ;
+}
+
+//-----------------------------------------------------------------
+// Chooses the image that best fits a size.  Images at least as big
+// as the size are preferred because shrinking looks better than
+// enlarging, then the closest size, then the highest bit count the
+// display supports.
+//
+// Return value:  The id of the RT_ICON or RT_CURSOR resource of the
+//				  image, or NotFound if the directory is empty.
+//
+// Parameters:
+//
+// const int width       -> The width wanted.
+// const int height      -> The height wanted.
+// const int maxBitCount -> The bit count of the display.
+//-----------------------------------------------------------------
+
+int Win::IconDirectory::FindBest (const int width, const int height, const int maxBitCount) const
+{
+	if (_entries.empty ())
+		return NotFound ;
+
+	size_t best = 0 ;
+
+	for (size_t i = 1 ; i < _entries.size () ; ++i)
+	{
+		if (IsBetter (_entries [i], _entries [best], width, height, maxBitCount))
+			best = i ;
+	}
+
+	return _entries [best].id ;
+}
+
+//-----------------------------------------------------------------
+// Compares two images for FindBest.
+//
+// Return value:  True if entry fits the size better than best.
+//
+// Parameters:
+//
+// const Entry & entry   -> The image to compare.
+// const Entry & best    -> The best image found so far.
+// const int width       -> The width wanted.
+// const int height      -> The height wanted.
+// const int maxBitCount -> The bit count of the display.
+//-----------------------------------------------------------------
+
+bool Win::IconDirectory::IsBetter (const Entry & entry, const Entry & best, const int width, const int height, const int maxBitCount)
+{
+	bool entryFits = entry.width >= width && entry.height >= height ;
+	bool bestFits  = best.width  >= width && best.height  >= height ;
+
+	if (entryFits != bestFits)
+		return entryFits ;
+
+	int entryDistance = abs (entry.width - width) + abs (entry.height - height) ;
+	int bestDistance  = abs (best.width  - width) + abs (best.height  - height) ;
+
+	if (entryDistance != bestDistance)
+		return entryDistance < bestDistance ;
+
+	bool entrySupported = entry.bitCount <= maxBitCount ;
+	bool bestSupported  = best.bitCount  <= maxBitCount ;
+
+	if (entrySupported != bestSupported)
+		return entrySupported ;
+
+	// Among supported images the richest, else the poorest.
+	return entrySupported ? entry.bitCount > best.bitCount : entry.bitCount < best.bitCount ;
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Creates an empty cache.
+//-----------------------------------------------------------------
+
+Win::IconCache::IconCache ()
+{
+	_stats.hits        = 0 ;
+	_stats.misses      = 0 ;
+	_stats.directories = 0 ;
+}
+
+//-----------------------------------------------------------------
+// Destructor.  Destroys all the handles.
+//-----------------------------------------------------------------
+
+Win::IconCache::~IconCache ()
+{
+	Clear () ;
+}
+
+//-----------------------------------------------------------------
+// Obtains an icon.
+//
+// Return value:  A handle on the icon, owned by the cache.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> The module containing the icon.
+// const int id              -> Numerical id of the icon.
+// const int width           -> Width of the icon, 0 for the default.
+// const int height          -> Height of the icon, 0 for the default.
+//-----------------------------------------------------------------
+
+Win::Icon::Handle Win::IconCache::GetIcon (const HINSTANCE hInstance, const int id, const int width, const int height)
+{
+	Key key ;
+	key.hInstance = hInstance ;
+	key.id        = id ;
+	key.cursor    = false ;
+	key.width     = width ;
+	key.height    = height ;
+
+	return Find (key) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains an icon.
+//
+// Return value:  A handle on the icon, owned by the cache.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> The module containing the icon.
+// const std::tstring & name -> Name of the icon.
+// const int width           -> Width of the icon, 0 for the default.
+// const int height          -> Height of the icon, 0 for the default.
+//-----------------------------------------------------------------
+
+Win::Icon::Handle Win::IconCache::GetIcon (const HINSTANCE hInstance, const std::tstring & name, const int width, const int height)
+{
+	Key key ;
+	key.hInstance = hInstance ;
+	key.id        = 0 ;
+	key.name      = name ;
+	key.cursor    = false ;
+	key.width     = width ;
+	key.height    = height ;
+
+	return Find (key) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains a cursor.
+//
+// Return value:  A handle on the cursor, owned by the cache.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> The module containing the cursor.
+// const int id              -> Numerical id of the cursor.
+// const int width           -> Width of the cursor, 0 for the default.
+// const int height          -> Height of the cursor, 0 for the default.
+//-----------------------------------------------------------------
+
+Win::Cursor::Handle Win::IconCache::GetCursor (const HINSTANCE hInstance, const int id, const int width, const int height)
+{
+	Key key ;
+	key.hInstance = hInstance ;
+	key.id        = id ;
+	key.cursor    = true ;
+	key.width     = width ;
+	key.height    = height ;
+
+	return static_cast <HCURSOR> (Find (key)) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains a cursor.
+//
+// Return value:  A handle on the cursor, owned by the cache.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> The module containing the cursor.
+// const std::tstring & name -> Name of the cursor.
+// const int width           -> Width of the cursor, 0 for the default.
+// const int height          -> Height of the cursor, 0 for the default.
+//-----------------------------------------------------------------
+
+Win::Cursor::Handle Win::IconCache::GetCursor (const HINSTANCE hInstance, const std::tstring & name, const int width, const int height)
+{
+	Key key ;
+	key.hInstance = hInstance ;
+	key.id        = 0 ;
+	key.name      = name ;
+	key.cursor    = true ;
+	key.width     = width ;
+	key.height    = height ;
+
+	return static_cast <HCURSOR> (Find (key)) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the counters of the cache.
+//
+// Return value:  The counters.
+//-----------------------------------------------------------------
+
+Win::IconCache::Stats Win::IconCache::GetStats () const
+{
+	Win::Lock lock (_lock) ;
+	return _stats ;
+}
+
+//-----------------------------------------------------------------
+// Destroys all the handles.  The handles obtained before must not be
+// used anymore.
+//-----------------------------------------------------------------
+
+void Win::IconCache::Clear ()
+{
+	Win::Lock lock (_lock) ;
+
+	for (std::map <Key, HICON>::iterator it = _handles.begin () ; it != _handles.end () ; ++it)
+	{
+		if (it->first.cursor)
+			::DestroyCursor (static_cast <HCURSOR> (it->second)) ;
+		else
+			::DestroyIcon (it->second) ;
+	}
+
+	_handles.clear () ;
+	_directories.clear () ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the cache shared by the whole process.  Call it a first 
+// time before starting other threads.
+//
+// Return value:  The cache.
+//-----------------------------------------------------------------
+
+Win::IconCache & Win::IconCache::Get ()
+{
+	static Win::IconCache cache ;
+	return cache ;
+}
+
+//-----------------------------------------------------------------
+// Compares two keys.
+//-----------------------------------------------------------------
+
+bool Win::IconCache::Key::operator < (const Key & key) const
+{
+	if (hInstance != key.hInstance) return hInstance < key.hInstance ;
+	if (id        != key.id)        return id        < key.id ;
+	if (cursor    != key.cursor)    return cursor    < key.cursor ;
+	if (width     != key.width)     return width     < key.width ;
+	if (height    != key.height)    return height    < key.height ;
+
+	return name < key.name ;
+}
+
+//-----------------------------------------------------------------
+// Finds a handle in the cache or creates it.
+//
+// Return value:  The handle.
+//
+// Parameters:
+//
+// Key & key -> The resource and its size.  A size of 0 is replaced 
+//				by the default size.
+//-----------------------------------------------------------------
+
+HICON Win::IconCache::Find (Key & key)
+{
+	if (key.width == 0)
+		key.width  = ::GetSystemMetrics (key.cursor ? SM_CXCURSOR : SM_CXICON) ;
+
+	if (key.height == 0)
+		key.height = ::GetSystemMetrics (key.cursor ? SM_CYCURSOR : SM_CYICON) ;
+
+	Win::Lock lock (_lock) ;
+
+	std::map <Key, HICON>::iterator it = _handles.find (key) ;
+
+	if (it != _handles.end ())
+	{
+		++_stats.hits ;
+		return it->second ;
+	}
+
+	++_stats.misses ;
+
+	const Win::IconDirectory & directory = GetDirectory (key) ;
+	int                        id        = directory.FindBest (key.width, key.height, ::GetDeviceCaps (NULL, BITSPIXEL)) ;
+
+	if (id == Win::IconDirectory::NotFound)
+		throw Win::Exception (TEXT("Error, the icon has no image")) ;
+
+	HRSRC   hInfo = ::FindResource (key.hInstance, MAKEINTRESOURCE (id), key.cursor ? RT_CURSOR : RT_ICON) ;
+	HGLOBAL hRes  = ::LoadResource (key.hInstance, hInfo) ;
+
+	if (hRes == NULL)
+		throw Win::Exception (TEXT("Could not load an icon image")) ;
+
+	HICON h = ::CreateIconFromResourceEx (static_cast <PBYTE> (::LockResource (hRes)), ::SizeofResource (key.hInstance, hInfo),
+										  !key.cursor, 0x00030000, key.width, key.height, LR_DEFAULTCOLOR) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Could not create an icon")) ;
+
+	_handles [key] = h ;
+	return h ;
+}
+
+//-----------------------------------------------------------------
+// Finds the directory of a resource or reads it.  The lock must be
+// held.
+//
+// Return value:  The directory.
+//
+// Parameters:
+//
+// const Key & key -> The resource, the size is ignored.
+//-----------------------------------------------------------------
+
+const Win::IconDirectory & Win::IconCache::GetDirectory (const Key & key)
+{
+	Key resource (key) ;
+	resource.width  = 0 ;
+	resource.height = 0 ;
+
+	std::map <Key, Win::IconDirectory>::iterator it = _directories.find (resource) ;
+
+	if (it != _directories.end ())
+		return it->second ;
+
+	LPCTSTR name  = resource.name.empty () ? MAKEINTRESOURCE (resource.id) : resource.name.c_str () ;
+	HRSRC   hInfo = ::FindResource (resource.hInstance, name, resource.cursor ? RT_GROUP_CURSOR : RT_GROUP_ICON) ;
+	HGLOBAL hRes  = ::LoadResource (resource.hInstance, hInfo) ;
+
+	if (hRes == NULL)
+		throw Win::Exception (TEXT("Could not load an icon directory")) ;
+
+	Win::IconDirectory directory ;
+	directory.Parse (::LockResource (hRes), ::SizeofResource (resource.hInstance, hInfo)) ;
+
+	++_stats.directories ;
+
+	return _directories [resource] = directory ;
+}
\ No newline at end of file
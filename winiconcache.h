@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------
+//  This file contains classes used to share icons and cursors
+//  loaded from resources:  Win::IconDirectory and Win::IconCache.
+//-----------------------------------------------------------------
+
+#if !defined (WINICONCACHE_H)
+
+	#define WINICONCACHE_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include "winunicodehelper.h"
+	#include "winicon.h"
+	#include "wincursor.h"
+	#include "winsync.h"
+	#include <vector>
+	#include <map>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// Win::IconDirectory holds the content of a RT_GROUP_ICON or
+		// RT_GROUP_CURSOR resource:  the list of the images available for
+		// an icon or a cursor.  It chooses the image that best fits a size.
+		//-----------------------------------------------------------------
+
+		class IconDirectory
+		{
+		public:
+
+			enum { NotFound = -1 } ;
+
+			//-----------------------------------------------------------------
+			// An image of the icon or cursor.
+			//-----------------------------------------------------------------
+
+			struct Entry
+			{
+				int  width ;
+				int  height ;
+				int  bitCount ;
+				WORD id ;       // Id of the RT_ICON or RT_CURSOR resource.
+			} ;
+
+			//-----------------------------------------------------------------
+			// Constructor.  Creates an empty directory.
+			//-----------------------------------------------------------------
+
+			IconDirectory ()
+				: _cursor (false)
+			{}
+
+			void Parse (const void * data, const DWORD size) ;
+			int FindBest (const int width, const int height, const int maxBitCount = 32) const ;
+
+			//-----------------------------------------------------------------
+			// Returns true if the directory describes a cursor.
+			//-----------------------------------------------------------------
+
+			bool IsCursor () const
+			{
+				return _cursor ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the number of images.
+			//-----------------------------------------------------------------
+
+			int GetCount () const
+			{
+				return static_cast <int> (_entries.size ()) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains an image.
+			//
+			// Parameters:
+			//
+			// const int index -> Index of the image.
+			//-----------------------------------------------------------------
+
+			const Entry & GetEntry (const int index) const
+			{
+				return _entries [index] ;
+			}
+
+		private:
+
+			static bool IsBetter (const Entry & entry, const Entry & best, const int width, const int height, const int maxBitCount) ;
+
+			std::vector <Entry> _entries ;
+			bool                _cursor ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// Win::IconCache loads each icon or cursor once per module, name
+		// and size, and shares the handle between all its users.  The
+		// directory of an icon is read once and the image that best fits
+		// the size is chosen without loading the others.  The handles
+		// belong to the cache and must not be destroyed.  Use Get to obtain
+		// the cache shared by the whole process.
+		//-----------------------------------------------------------------
+
+		class IconCache
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Counters about the use of the cache.
+			//-----------------------------------------------------------------
+
+			struct Stats
+			{
+				unsigned long hits ;        // Handles found in the cache.
+				unsigned long misses ;      // Handles that were created.
+				unsigned long directories ; // Directories read.
+			} ;
+
+			IconCache () ;
+			~IconCache () ;
+
+			Win::Icon::Handle GetIcon (const HINSTANCE hInstance, const int id, const int width, const int height) ;
+			Win::Icon::Handle GetIcon (const HINSTANCE hInstance, const std::tstring & name, const int width, const int height) ;
+			Win::Cursor::Handle GetCursor (const HINSTANCE hInstance, const int id, const int width = 0, const int height = 0) ;
+			Win::Cursor::Handle GetCursor (const HINSTANCE hInstance, const std::tstring & name, const int width = 0, const int height = 0) ;
+
+			Stats GetStats () const ;
+			void Clear () ;
+
+			static Win::IconCache & Get () ;
+
+		private:
+
+			IconCache (const Win::IconCache & cache) ;
+			IconCache & operator = (const Win::IconCache & cache) ;
+
+			//-----------------------------------------------------------------
+			// Identifies a resource:  by id if name is empty, else by name.
+			//-----------------------------------------------------------------
+
+			struct Key
+			{
+				HINSTANCE    hInstance ;
+				int          id ;
+				std::tstring name ;
+				bool         cursor ;
+				int          width ;
+				int          height ;
+
+				bool operator < (const Key & key) const ;
+			} ;
+
+			HICON Find (Key & key) ;
+			const Win::IconDirectory & GetDirectory (const Key & key) ;
+
+			std::map <Key, Win::IconDirectory> _directories ; // Directories by resource (size is 0).
+			std::map <Key, HICON>              _handles ;     // Handles by resource and size.
+			Stats                              _stats ;
+			mutable Win::CriticalSection       _lock ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
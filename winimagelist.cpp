@@ -1,4 +1,5 @@
 #include "winimagelist.h"
+#include "wincanvas.h"
 
 //---------------------------------------------------------------------
 // Add a DDB to the image list
@@ -103,6 +104,46 @@ int Win::ImageListHandle::AddIcon (Win::Icon::StrongHandle icon)
 	return i ;
 }
 
+//---------------------------------------------------------------------
+// Adds all the images of a strip with one call.  The image at index i
+// in the strip is at index (return value + i) in the image list.
+//
+// Return value:  Index of the first added image.
+//
+// Parameters:
+//
+// const Win::ImageListStrip & strip -> The images to add.  Their size
+//										must be the size of the images of
+//										the list.
+//---------------------------------------------------------------------
+
+int Win::ImageListHandle::Add (const Win::ImageListStrip & strip)
+{
+	int first = GetNbImage () ;
+
+	if (strip.GetCount () == 0)
+		return first ;
+
+	// Make sure GDI is done drawing in the strip.
+	::GdiFlush () ;
+
+	// Only the used cells are added, so that the list grows once to its
+	// final size.
+	Win::Bitmap::DIBSection::StrongHandle used ;
+	HBITMAP                               bitmap = strip.GetBitmap () ;
+
+	if (strip.GetCount () < strip.GetCapacity ())
+	{
+		strip.CopyUsedCells (used) ;
+		bitmap = used ;
+	}
+
+	if (ImageList_Add (_h, bitmap, NULL) == -1)
+		throw Win::Exception (TEXT("Error, could not add a strip of images to the image list")) ;
+
+	return first ;
+}
+
 //---------------------------------------------------------------------
 // Replace an image from the list by a new DDB
 //
@@ -239,4 +280,219 @@ Win::ImageListStrongHandle Win::ImageListCreator::Merge (Win::ImageListHandle h1
 
 	return Win::ImageListStrongHandle (h) ;	
 			
+}
+
+//---------------------------------------------------------------------
+// Constructor.  Creates a strip with room for a number of images.
+//
+// Parameters:
+//
+// const int cellWidth  -> Width of the images of the image list.
+// const int cellHeight -> Height of the images of the image list.
+// const int capacity   -> Maximum number of images in the strip.
+//---------------------------------------------------------------------
+
+Win::ImageListStrip::ImageListStrip (const int cellWidth, const int cellHeight, const int capacity)
+	: _bits       (NULL),
+	  _cellWidth  (cellWidth),
+	  _cellHeight (cellHeight),
+	  _capacity   (capacity),
+	  _count      (0)
+{
+	if (cellWidth <= 0 || cellHeight <= 0 || capacity <= 0 || capacity > 0x7FFFFFFF / 4 / cellWidth / cellHeight)
+		throw Win::Exception (TEXT("Error, invalid size for a strip of images")) ;
+
+	_bits = CreateBitmap (cellWidth * capacity, cellHeight, _bitmap) ;
+}
+
+//---------------------------------------------------------------------
+// Adds an image from 32 bits pixels.
+//
+// Return value:  Index of the image in the strip.
+//
+// Parameters:
+//
+// const DWORD * pixels -> The pixels, in top-down rows.
+// const int width      -> Width of the image.
+// const int height     -> Height of the image.
+// const int stride     -> Number of pixels from one row to the next.
+//---------------------------------------------------------------------
+
+int Win::ImageListStrip::Add (const DWORD * pixels, const int width, const int height, const int stride)
+{
+	int index = FreeCell () ;
+
+	// Make sure GDI is done drawing before writing in the strip.
+	::GdiFlush () ;
+
+	CopyToCell (_bits + index * _cellWidth, _cellWidth * _capacity, _cellWidth, _cellHeight, pixels, width, height, stride) ;
+	++_count ;
+
+	return index ;
+}
+
+//---------------------------------------------------------------------
+// Adds an icon.  The icon is stretched to the size of the cells.
+//
+// Return value:  Index of the image in the strip.
+//
+// Parameters:
+//
+// Win::Icon::Handle icon -> The icon.
+//---------------------------------------------------------------------
+
+int Win::ImageListStrip::Add (Win::Icon::Handle icon)
+{
+	std::vector <Win::Icon::Handle> icons (1, icon) ;
+	return Add (icons) ;
+}
+
+//---------------------------------------------------------------------
+// Adds many icons, drawing all of them with the same device context.
+// The icons are stretched to the size of the cells.
+//
+// Return value:  Index of the first icon in the strip.
+//
+// Parameters:
+//
+// const std::vector <Win::Icon::Handle> & icons -> The icons.
+//---------------------------------------------------------------------
+
+int Win::ImageListStrip::Add (const std::vector <Win::Icon::Handle> & icons)
+{
+	if (static_cast <int> (icons.size ()) > _capacity - _count)
+		throw Win::Exception (TEXT("Error, the strip of images is full")) ;
+
+	int                              first = _count ;
+	Win::MemoryCanvas                canvas ;
+	Win::Bitmap::DIBSection::Holder  holder (canvas, _bitmap) ;
+
+	for (size_t i = 0 ; i < icons.size () ; ++i)
+	{
+		int index = FreeCell () ;
+
+		if (!::DrawIconEx (canvas, index * _cellWidth, 0, icons [i], _cellWidth, _cellHeight, 0, NULL, DI_NORMAL))
+			throw Win::Exception (TEXT("Error, could not draw an icon in the strip of images")) ;
+
+		++_count ;
+	}
+
+	return first ;
+}
+
+//---------------------------------------------------------------------
+// Copies the used cells in a new bitmap of their exact width, so that
+// an image list does not receive the unused cells.
+//
+// Parameters:
+//
+// Win::Bitmap::DIBSection::StrongHandle & bitmap -> Will own the copy.
+//---------------------------------------------------------------------
+
+void Win::ImageListStrip::CopyUsedCells (Win::Bitmap::DIBSection::StrongHandle & bitmap) const
+{
+	if (_count == 0)
+		throw Win::Exception (TEXT("Error, the strip of images is empty")) ;
+
+	int     width = _cellWidth * _count ;
+	DWORD * bits  = CreateBitmap (width, _cellHeight, bitmap) ;
+
+	// Make sure GDI is done drawing in the strip.
+	::GdiFlush () ;
+
+	for (int row = 0 ; row < _cellHeight ; ++row)
+	{
+		::CopyMemory (bits + row * width, _bits + row * _cellWidth * _capacity, width * sizeof (DWORD)) ;
+	}
+}
+
+//---------------------------------------------------------------------
+// Copies an image in a cell.  The image is centered in the cell and
+// clipped if it is bigger.  The parts of the cell that are not covered
+// are left as they are.
+//
+// Parameters:
+//
+// DWORD * cell         -> The top left pixel of the cell.
+// const int cellStride -> Number of pixels from one row of the cell to
+//						   the next.
+// const int cellWidth  -> Width of the cell.
+// const int cellHeight -> Height of the cell.
+// const DWORD * pixels -> The pixels of the image, in top-down rows.
+// const int width      -> Width of the image.
+// const int height     -> Height of the image.
+// const int stride     -> Number of pixels from one row of the image to
+//						   the next.
+//---------------------------------------------------------------------
+
+void Win::ImageListStrip::CopyToCell (DWORD * cell, const int cellStride, const int cellWidth, const int cellHeight,
+									  const DWORD * pixels, const int width, const int height, const int stride)
+{
+	// Offset of the image in the cell, negative if the image is clipped.
+	int x = (cellWidth  - width)  / 2 ;
+	int y = (cellHeight - height) / 2 ;
+
+	int srcX = x < 0 ? -x : 0 ;
+	int srcY = y < 0 ? -y : 0 ;
+	int dstX = x < 0 ? 0 : x ;
+	int dstY = y < 0 ? 0 : y ;
+	int cx   = width  - srcX < cellWidth  - dstX ? width  - srcX : cellWidth  - dstX ;
+	int cy   = height - srcY < cellHeight - dstY ? height - srcY : cellHeight - dstY ;
+
+	for (int row = 0 ; row < cy ; ++row)
+	{
+		::CopyMemory (cell + (dstY + row) * cellStride + dstX, pixels + (srcY + row) * stride + srcX, cx * sizeof (DWORD)) ;
+	}
+}
+
+//---------------------------------------------------------------------
+// Obtains the next free cell.  The cell is counted only once an image
+// has been put in it, so that a failure leaves no empty cell behind.
+//
+// Return value:  Index of the cell.
+//---------------------------------------------------------------------
+
+int Win::ImageListStrip::FreeCell () const
+{
+	if (_count == _capacity)
+		throw Win::Exception (TEXT("Error, the strip of images is full")) ;
+
+	return _count ;
+}
+
+//---------------------------------------------------------------------
+// Creates a top-down 32 bits DIB section.  Its memory is zeroed
+// (transparent).
+//
+// Return value:  The pixels of the bitmap.
+//
+// Parameters:
+//
+// const int width                                -> Width of the bitmap.
+// const int height                               -> Height of the bitmap.
+// Win::Bitmap::DIBSection::StrongHandle & bitmap -> Will own the bitmap.
+//---------------------------------------------------------------------
+
+DWORD * Win::ImageListStrip::CreateBitmap (const int width, const int height, Win::Bitmap::DIBSection::StrongHandle & bitmap)
+{
+	BITMAPINFO info ;
+	::ZeroMemory (&info, sizeof (info)) ;
+
+	info.bmiHeader.biSize        = sizeof (BITMAPINFOHEADER) ;
+	info.bmiHeader.biWidth       = width ;
+	info.bmiHeader.biHeight      = -height ; // Top-down.
+	info.bmiHeader.biPlanes      = 1 ;
+	info.bmiHeader.biBitCount    = 32 ;
+	info.bmiHeader.biCompression = BI_RGB ;
+
+	void *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, &info, DIB_RGB_COLORS, &bits, NULL, 0) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not create a strip of images")) ;
+
+	Win::Bitmap::DIBSection::StrongHandle created (h, static_cast <BYTE *> (bits)) ;
+	bitmap = created ;
+
+	return static_cast <DWORD *> (bits) ;
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 	#include "wincontrol.h"
 	#include "winicon.h"
 	#include "windrawingtool.h"
+	#include <vector>
 
 	namespace Win
 	{
@@ -88,6 +89,8 @@
 		// Object represents a weak handle to an imagle list.
 		//---------------------------------------------------------------------
 
+		class ImageListStrip ;
+
 		class ImageListHandle : public Sys::Handle <HIMAGELIST>
 		{
 		public:
@@ -105,6 +108,7 @@
 			int Add (Win::Bitmap::DDB::StrongHandle bitmap, Win::Color & color) ;
 			int Add (Win::Bitmap::DIBSection::StrongHandle bitmap, Win::Color & color) ;
 			int AddIcon (Win::Icon::StrongHandle icon) ;
+			int Add (const Win::ImageListStrip & strip) ;
 			void Replace (int index, Win::Bitmap::DDB::StrongHandle bitmap, Win::Bitmap::DDB::StrongHandle mask = NULL);
 			void Replace (int index, Win::Bitmap::DIBSection::StrongHandle bitmap, Win::Bitmap::DIBSection::StrongHandle mask = NULL) ;
 			int ReplaceIcon (int index, Win::Icon::StrongHandle icon) ;
@@ -297,6 +301,74 @@
 		// Strong handle to an image list
 		typedef Sys::StrongHandle <Win::ImageListHandle, Win::ImageListDisposal> ImageListStrongHandle ;
 
+		//---------------------------------------------------------------------
+		// Win::ImageListStrip composes many images side by side in a single
+		// 32 bits DIB section.  The whole strip is then added to an image list
+		// with one call instead of one call per image, which makes the image
+		// list grow only once.  Each image is centered in a cell of the size
+		// of the images of the list and clipped if it is bigger.
+		//---------------------------------------------------------------------
+
+		class ImageListStrip
+		{
+		public:
+
+			ImageListStrip (const int cellWidth, const int cellHeight, const int capacity) ;
+
+			int Add (const DWORD * pixels, const int width, const int height, const int stride) ;
+			int Add (Win::Icon::Handle icon) ;
+			int Add (const std::vector <Win::Icon::Handle> & icons) ;
+
+			void CopyUsedCells (Win::Bitmap::DIBSection::StrongHandle & bitmap) const ;
+
+			static void CopyToCell (DWORD * cell, const int cellStride, const int cellWidth, const int cellHeight,
+									const DWORD * pixels, const int width, const int height, const int stride) ;
+
+			//---------------------------------------------------------------------
+			// Obtains the number of images in the strip.
+			//---------------------------------------------------------------------
+
+			int GetCount () const
+			{
+				return _count ;
+			}
+
+			//---------------------------------------------------------------------
+			// Obtains the maximum number of images in the strip.
+			//---------------------------------------------------------------------
+
+			int GetCapacity () const
+			{
+				return _capacity ;
+			}
+
+			//---------------------------------------------------------------------
+			// Obtains the bitmap containing the images.  Its width is the width
+			// of a cell multiplied by the capacity.
+			//---------------------------------------------------------------------
+
+			Win::Bitmap::DIBSection::Handle GetBitmap () const
+			{
+				return _bitmap ;
+			}
+
+		private:
+
+			ImageListStrip (const Win::ImageListStrip & strip) ;
+			ImageListStrip & operator = (const Win::ImageListStrip & strip) ;
+
+			int FreeCell () const ;
+
+			static DWORD * CreateBitmap (const int width, const int height, Win::Bitmap::DIBSection::StrongHandle & bitmap) ;
+
+			Win::Bitmap::DIBSection::StrongHandle _bitmap ;     // Top-down 32 bits strip.
+			DWORD *                               _bits ;       // Pixels of the strip.
+			int                                   _cellWidth ;  // Width of an image.
+			int                                   _cellHeight ; // Height of an image.
+			int                                   _capacity ;   // Maximum number of images.
+			int                                   _count ;      // Number of images added.
+		} ;
+
 		//---------------------------------------------------------------------
 		// Object allowing to drag an image from an image list.
 		//---------------------------------------------------------------------
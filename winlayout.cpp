@@ -0,0 +1,1242 @@
+#include "winlayout.h"
+
+//-----------------------------------------------------------------
+// Constructor.  Creates a layout whose root is an empty vertical
+// stack.
+//-----------------------------------------------------------------
+
+Win::Layout::Layout ()
+	: _visited (0)
+{
+	AddNode (NoNode, Stack) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a stack container.  Its children are placed one after the
+// other and fill its whole height, or width.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent      -> The container receiving the node.
+// const bool horizontal -> True to place the children from left to
+//							right, false from top to bottom.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddStack (const int parent, const bool horizontal)
+{
+	int node = AddNode (parent, Stack) ;
+	_nodes [node].horizontal = horizontal ;
+
+	return node ;
+}
+
+//-----------------------------------------------------------------
+// Adds a grid container.  Its children are placed in the next free
+// cell, row by row, unless SetCell is called.  Rows are added when
+// needed.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent  -> The container receiving the node.
+// const int rows    -> Initial number of rows.
+// const int columns -> Number of columns.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddGrid (const int parent, const int rows, const int columns)
+{
+	if (rows < 0 || columns <= 0)
+		throw Win::Exception (TEXT("Error, invalid number of rows or columns")) ;
+
+	int node = AddNode (parent, Grid) ;
+
+	GridInfo info ;
+	info.rowStretch.resize (rows, 0) ;
+	info.columnStretch.resize (columns, 0) ;
+
+	_nodes [node].grid = static_cast <int> (_grids.size ()) ;
+	_grids.push_back (info) ;
+
+	return node ;
+}
+
+//-----------------------------------------------------------------
+// Adds a dock container.  Each child is attached to a side of the
+// space left by the children before it.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent -> The container receiving the node.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddDock (const int parent)
+{
+	return AddNode (parent, Dock) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a control.  The layout decides whether the control is shown.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent            -> The container receiving the node.
+// const Win::dow::Handle win  -> The control.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddControl (const int parent, const Win::dow::Handle win)
+{
+	int node = AddNode (parent, Leaf) ;
+	_nodes [node].win = win ;
+
+	return node ;
+}
+
+//-----------------------------------------------------------------
+// Adds an empty node that takes space.  A spacer stretches by
+// default.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent -> The container receiving the node.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddSpacer (const int parent)
+{
+	int node = AddNode (parent, Leaf) ;
+	_nodes [node].stretch = 1 ;
+
+	return node ;
+}
+
+//-----------------------------------------------------------------
+// Removes a node and all its children from the layout.  The controls
+// are left where they are.
+//
+// Parameters:
+//
+// const int node -> The node, which cannot be the root.
+//-----------------------------------------------------------------
+
+void Win::Layout::Remove (const int node)
+{
+	if (node == Root)
+		throw Win::Exception (TEXT("Error, the root of a layout cannot be removed")) ;
+
+	int parent = GetNode (node).parent ;
+	Node & p   = _nodes [parent] ;
+
+	// Unlinks the node.
+	int previous = NoNode ;
+
+	for (int child = p.first ; child != node ; child = _nodes [child].next)
+		previous = child ;
+
+	if (previous == NoNode)
+		p.first = _nodes [node].next ;
+	else
+		_nodes [previous].next = _nodes [node].next ;
+
+	if (p.last == node)
+		p.last = previous ;
+
+	// Frees the subtree.  The slots are not reused.
+	std::vector <int> pending (1, node) ;
+
+	while (!pending.empty ())
+	{
+		int current = pending.back () ;
+		pending.pop_back () ;
+
+		for (int child = _nodes [current].first ; child != NoNode ; child = _nodes [child].next)
+			pending.push_back (child) ;
+
+		_nodes [current].kind = Unused ;
+	}
+
+	Invalidate (parent) ;
+}
+
+//-----------------------------------------------------------------
+// Sets the minimum size of a node, margin excluded.  A container is
+// never smaller than its children.
+//
+// Parameters:
+//
+// const int node   -> The node.
+// const int width  -> Minimum width.
+// const int height -> Minimum height.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetMinSize (const int node, const int width, const int height)
+{
+	Node & n = GetNode (node) ;
+	n.minWidth  = width ;
+	n.minHeight = height ;
+
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Sets the maximum size of a node, margin excluded.  A node given
+// more space is kept at the top left corner of it.
+//
+// Parameters:
+//
+// const int node   -> The node.
+// const int width  -> Maximum width, or Unlimited.
+// const int height -> Maximum height, or Unlimited.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetMaxSize (const int node, const int width, const int height)
+{
+	Node & n = GetNode (node) ;
+	n.maxWidth  = width ;
+	n.maxHeight = height ;
+
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Sets how a node shares the space left in a stack once every
+// child has its minimum size.  The space is shared in proportion of
+// the weights.  Controls do not stretch by default, containers and
+// spacers do.
+//
+// Parameters:
+//
+// const int node    -> The node.
+// const int stretch -> The weight, 0 to keep the minimum size.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetStretch (const int node, const int stretch)
+{
+	GetNode (node).stretch = stretch < 0 ? 0 : stretch ;
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Sets the empty space around a node.
+//
+// Parameters:
+//
+// const int node   -> The node.
+// const int margin -> The space on each side.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetMargin (const int node, const int margin)
+{
+	GetNode (node).margin = margin < 0 ? 0 : margin ;
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Sets the space between the children of a container.
+//
+// Parameters:
+//
+// const int node    -> The container.
+// const int spacing -> The space.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetSpacing (const int node, const int spacing)
+{
+	GetNode (node).spacing = spacing < 0 ? 0 : spacing ;
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Shows or hides a node.  A hidden node takes no space and its
+// controls are hidden by the next Apply.
+//
+// Parameters:
+//
+// const int node     -> The node.
+// const bool visible -> True to show the node, false to hide it.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetVisible (const int node, const bool visible)
+{
+	GetNode (node).visible = visible ;
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Places a child of a grid in a cell.  Rows are added when needed.
+//
+// Parameters:
+//
+// const int node       -> A child of a grid.
+// const int row        -> Row of the cell.
+// const int column     -> Column of the cell.
+// const int rowSpan    -> Number of rows covered by the node.
+// const int columnSpan -> Number of columns covered by the node.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetCell (const int node, const int row, const int column, const int rowSpan, const int columnSpan)
+{
+	Node & n = GetNode (node) ;
+
+	if (_nodes [n.parent].kind != Grid)
+		throw Win::Exception (TEXT("Error, the node is not in a grid")) ;
+
+	GridInfo & info = _grids [_nodes [n.parent].grid] ;
+
+	if (row < 0 || column < 0 || rowSpan < 1 || columnSpan < 1 ||
+		column + columnSpan > static_cast <int> (info.columnStretch.size ()))
+	{
+		throw Win::Exception (TEXT("Error, invalid grid cell")) ;
+	}
+
+	if (row + rowSpan > static_cast <int> (info.rowStretch.size ()))
+		info.rowStretch.resize (row + rowSpan, 0) ;
+
+	n.row        = row ;
+	n.column     = column ;
+	n.rowSpan    = rowSpan ;
+	n.columnSpan = columnSpan ;
+
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Attaches a child of a dock to a side.
+//
+// Parameters:
+//
+// const int node      -> A child of a dock.
+// const DockSide side -> The side.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetDock (const int node, const DockSide side)
+{
+	GetNode (node).dock = side ;
+	Invalidate (node) ;
+}
+
+//-----------------------------------------------------------------
+// Sets how a row of a grid shares the height left once every row
+// has its minimum height.
+//
+// Parameters:
+//
+// const int grid    -> The grid.
+// const int row     -> The row.
+// const int stretch -> The weight, 0 to keep the minimum height.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetRowStretch (const int grid, const int row, const int stretch)
+{
+	Node & n = GetNode (grid) ;
+
+	if (n.kind != Grid || row < 0)
+		throw Win::Exception (TEXT("Error, invalid grid row")) ;
+
+	GridInfo & info = _grids [n.grid] ;
+
+	if (row >= static_cast <int> (info.rowStretch.size ()))
+		info.rowStretch.resize (row + 1, 0) ;
+
+	info.rowStretch [row] = stretch < 0 ? 0 : stretch ;
+	Invalidate (grid) ;
+}
+
+//-----------------------------------------------------------------
+// Sets how a column of a grid shares the width left once every
+// column has its minimum width.
+//
+// Parameters:
+//
+// const int grid    -> The grid.
+// const int column  -> The column.
+// const int stretch -> The weight, 0 to keep the minimum width.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetColumnStretch (const int grid, const int column, const int stretch)
+{
+	Node & n = GetNode (grid) ;
+
+	if (n.kind != Grid || column < 0 || column >= static_cast <int> (_grids [n.grid].columnStretch.size ()))
+		throw Win::Exception (TEXT("Error, invalid grid column")) ;
+
+	_grids [n.grid].columnStretch [column] = stretch < 0 ? 0 : stretch ;
+	Invalidate (grid) ;
+}
+
+//-----------------------------------------------------------------
+// Changes the direction of a stack.
+//
+// Parameters:
+//
+// const int stack       -> The stack.
+// const bool horizontal -> True to place the children from left to
+//							right, false from top to bottom.
+//-----------------------------------------------------------------
+
+void Win::Layout::SetHorizontal (const int stack, const bool horizontal)
+{
+	Node & n = GetNode (stack) ;
+
+	if (n.kind != Stack)
+		throw Win::Exception (TEXT("Error, the node is not a stack")) ;
+
+	n.horizontal = horizontal ;
+	Invalidate (stack) ;
+}
+
+//-----------------------------------------------------------------
+// Computes the rectangle of the nodes and queues the moves of the
+// controls whose rectangle changed.  Only the modified subtrees and
+// the subtrees given a new rectangle are visited.
+//
+// Parameters:
+//
+// const RECT & rect -> The area given to the root.
+//-----------------------------------------------------------------
+
+void Win::Layout::Arrange (const RECT & rect)
+{
+	_visited = 0 ;
+
+	Measure (Root) ;
+	ArrangeNode (Root, rect) ;
+}
+
+//-----------------------------------------------------------------
+// Moves the controls in a single BeginDeferWindowPos and
+// EndDeferWindowPos batch, so each window is moved and repainted
+// once.
+//-----------------------------------------------------------------
+
+void Win::Layout::Apply ()
+{
+	if (_moves.empty ())
+		return ;
+
+	HDWP dwp = ::BeginDeferWindowPos (static_cast <int> (_moves.size ())) ;
+
+	if (dwp == NULL)
+		throw Win::Exception (TEXT("Error, could not move the controls")) ;
+
+	for (std::vector <Move>::const_iterator it = _moves.begin () ; it != _moves.end () ; ++it)
+	{
+		UINT flags = SWP_NOZORDER | SWP_NOACTIVATE ;
+
+		if (it->hide)
+			flags |= SWP_HIDEWINDOW | SWP_NOMOVE | SWP_NOSIZE ;
+		else if (it->show)
+			flags |= SWP_SHOWWINDOW ;
+
+		dwp = ::DeferWindowPos (dwp, it->win, NULL, it->rect.left, it->rect.top,
+								it->rect.right - it->rect.left, it->rect.bottom - it->rect.top, flags) ;
+
+		// The system freed the batch.
+		if (dwp == NULL)
+		{
+			_moves.clear () ;
+			throw Win::Exception (TEXT("Error, could not move the controls")) ;
+		}
+	}
+
+	_moves.clear () ;
+
+	if (!::EndDeferWindowPos (dwp))
+		throw Win::Exception (TEXT("Error, could not move the controls")) ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the smallest size the root can be given, for example to
+// answer WM_GETMINMAXINFO.
+//
+// Parameters:
+//
+// int & width  -> Will contain the minimum width.
+// int & height -> Will contain the minimum height.
+//-----------------------------------------------------------------
+
+void Win::Layout::GetMinSize (int & width, int & height)
+{
+	Measure (Root) ;
+
+	width  = _nodes [Root].measuredWidth ;
+	height = _nodes [Root].measuredHeight ;
+}
+
+//-----------------------------------------------------------------
+// Creates a node and appends it to the children of a container.
+//
+// Return value:  The new node.
+//
+// Parameters:
+//
+// const int parent -> The container, or NoNode for the root.
+// const Kind kind  -> The kind of node.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddNode (const int parent, const Kind kind)
+{
+	if (parent != NoNode && !IsContainer (GetNode (parent).kind))
+		throw Win::Exception (TEXT("Error, only stacks, grids and docks can contain nodes")) ;
+
+	Node n ;
+	n.kind           = kind ;
+	n.parent         = parent ;
+	n.first          = NoNode ;
+	n.last           = NoNode ;
+	n.next           = NoNode ;
+	n.win            = NULL ;
+	n.minWidth       = 0 ;
+	n.minHeight      = 0 ;
+	n.maxWidth       = Unlimited ;
+	n.maxHeight      = Unlimited ;
+	n.stretch        = IsContainer (kind) ? 1 : 0 ;
+	n.margin         = 0 ;
+	n.spacing        = 0 ;
+	n.horizontal     = false ;
+	n.grid           = NoNode ;
+	n.row            = 0 ;
+	n.column         = 0 ;
+	n.rowSpan        = 1 ;
+	n.columnSpan     = 1 ;
+	n.dock           = DockFill ;
+	n.visible        = true ;
+	n.shown          = ShownUnknown ;
+	n.measureDirty   = true ;
+	n.arrangeDirty   = true ;
+	n.arranged       = false ;
+	n.measuredWidth  = 0 ;
+	n.measuredHeight = 0 ;
+	n.rect.left      = 0 ;
+	n.rect.top       = 0 ;
+	n.rect.right     = 0 ;
+	n.rect.bottom    = 0 ;
+
+	int node = static_cast <int> (_nodes.size ()) ;
+
+	if (parent != NoNode)
+	{
+		Node & p = _nodes [parent] ;
+
+		// Children of a grid go to the next cell, row by row.
+		if (p.kind == Grid)
+		{
+			int count = 0 ;
+
+			for (int child = p.first ; child != NoNode ; child = _nodes [child].next)
+				++count ;
+
+			GridInfo & info = _grids [p.grid] ;
+			int columns = static_cast <int> (info.columnStretch.size ()) ;
+
+			n.row    = count / columns ;
+			n.column = count % columns ;
+
+			if (n.row >= static_cast <int> (info.rowStretch.size ()))
+				info.rowStretch.resize (n.row + 1, 0) ;
+		}
+
+		if (p.last == NoNode)
+			p.first = node ;
+		else
+			_nodes [p.last].next = node ;
+
+		p.last = node ;
+	}
+
+	_nodes.push_back (n) ;
+	Invalidate (node) ;
+
+	return node ;
+}
+
+//-----------------------------------------------------------------
+// Obtains a node, checking that it exists.
+//
+// Return value:  The node.
+//
+// Parameters:
+//
+// const int node -> Index of the node.
+//-----------------------------------------------------------------
+
+Win::Layout::Node & Win::Layout::GetNode (const int node)
+{
+	if (node < 0 || node >= static_cast <int> (_nodes.size ()) || _nodes [node].kind == Unused)
+		throw Win::Exception (TEXT("Error, invalid layout node")) ;
+
+	return _nodes [node] ;
+}
+
+const Win::Layout::Node & Win::Layout::GetNode (const int node) const
+{
+	if (node < 0 || node >= static_cast <int> (_nodes.size ()) || _nodes [node].kind == Unused)
+		throw Win::Exception (TEXT("Error, invalid layout node")) ;
+
+	return _nodes [node] ;
+}
+
+//-----------------------------------------------------------------
+// Marks a node and its ancestors for measuring and arranging.  The
+// siblings are not marked:  they are only visited again if their
+// rectangle changes.
+//
+// Parameters:
+//
+// const int node -> The modified node.
+//-----------------------------------------------------------------
+
+void Win::Layout::Invalidate (const int node)
+{
+	for (int current = node ; current != NoNode ; current = _nodes [current].parent)
+	{
+		Node & n = _nodes [current] ;
+
+		// The ancestors are already marked.
+		if (n.measureDirty && n.arrangeDirty && current != node)
+			break ;
+
+		n.measureDirty = true ;
+		n.arrangeDirty = true ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Computes the minimum size of a node and of its modified children.
+//
+// Parameters:
+//
+// const int node -> The node.
+//-----------------------------------------------------------------
+
+void Win::Layout::Measure (const int node)
+{
+	Node & n = _nodes [node] ;
+
+	if (!n.measureDirty)
+		return ;
+
+	int width  = 0 ;
+	int height = 0 ;
+
+	switch (n.kind)
+	{
+	case Stack:
+		{
+			int count = 0 ;
+
+			for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+			{
+				const Node & c = _nodes [child] ;
+
+				if (!c.visible)
+					continue ;
+
+				Measure (child) ;
+
+				int along = n.horizontal ? c.measuredWidth : c.measuredHeight ;
+				int cross = n.horizontal ? c.measuredHeight : c.measuredWidth ;
+
+				(n.horizontal ? width : height) += along + (count > 0 ? n.spacing : 0) ;
+				int & across = n.horizontal ? height : width ;
+				across = cross > across ? cross : across ;
+				++count ;
+			}
+		}
+		break ;
+
+	case Grid:
+		{
+			MeasureGrid (node) ;
+
+			const GridInfo & info = _grids [n.grid] ;
+
+			for (size_t i = 0 ; i < info.columnMin.size () ; ++i)
+				width += info.columnMin [i] + (i > 0 ? n.spacing : 0) ;
+
+			for (size_t i = 0 ; i < info.rowMin.size () ; ++i)
+				height += info.rowMin [i] + (i > 0 ? n.spacing : 0) ;
+		}
+		break ;
+
+	case Dock:
+		{
+			// The children are measured from the last one, which is
+			// surrounded by the ones before it.
+			size_t base = _scratch.size () ;
+
+			for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+			{
+				if (_nodes [child].visible)
+				{
+					Measure (child) ;
+					_scratch.push_back (child) ;
+				}
+			}
+
+			for (size_t i = _scratch.size () ; i > base ; --i)
+			{
+				const Node & c = _nodes [_scratch [i - 1]] ;
+				int spacing    = i < _scratch.size () ? n.spacing : 0 ;
+
+				switch (c.dock)
+				{
+				case DockLeft:
+				case DockRight:
+					width  = c.measuredWidth + spacing + width ;
+					height = c.measuredHeight > height ? c.measuredHeight : height ;
+					break ;
+
+				case DockTop:
+				case DockBottom:
+					height = c.measuredHeight + spacing + height ;
+					width  = c.measuredWidth > width ? c.measuredWidth : width ;
+					break ;
+
+				case DockFill:
+					width  = c.measuredWidth > width ? c.measuredWidth : width ;
+					height = c.measuredHeight > height ? c.measuredHeight : height ;
+					break ;
+				}
+			}
+
+			_scratch.resize (base) ;
+		}
+		break ;
+
+	default:
+		break ;
+	}
+
+	width  = n.minWidth > width ? n.minWidth : width ;
+	height = n.minHeight > height ? n.minHeight : height ;
+
+	n.measuredWidth  = AddMargin (width, n.margin) ;
+	n.measuredHeight = AddMargin (height, n.margin) ;
+	n.measureDirty   = false ;
+}
+
+//-----------------------------------------------------------------
+// Computes the minimum size of the rows and columns of a grid.  A
+// child spanning several lines adds what it lacks to the last one.
+//
+// Parameters:
+//
+// const int node -> The grid.
+//-----------------------------------------------------------------
+
+void Win::Layout::MeasureGrid (const int node)
+{
+	const Node & n  = _nodes [node] ;
+	GridInfo & info = _grids [n.grid] ;
+
+	info.rowMin.assign (info.rowStretch.size (), 0) ;
+	info.columnMin.assign (info.columnStretch.size (), 0) ;
+
+	// Single cells first, then spans.
+	for (int pass = 0 ; pass < 2 ; ++pass)
+	{
+		for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+		{
+			const Node & c = _nodes [child] ;
+
+			if (!c.visible)
+				continue ;
+
+			if (pass == 0)
+			{
+				Measure (child) ;
+
+				if (c.rowSpan == 1 && c.measuredHeight > info.rowMin [c.row])
+					info.rowMin [c.row] = c.measuredHeight ;
+
+				if (c.columnSpan == 1 && c.measuredWidth > info.columnMin [c.column])
+					info.columnMin [c.column] = c.measuredWidth ;
+			}
+			else
+			{
+				if (c.rowSpan > 1)
+				{
+					int covered = n.spacing * (c.rowSpan - 1) ;
+
+					for (int r = c.row ; r < c.row + c.rowSpan ; ++r)
+						covered += info.rowMin [r] ;
+
+					if (c.measuredHeight > covered)
+						info.rowMin [c.row + c.rowSpan - 1] += c.measuredHeight - covered ;
+				}
+
+				if (c.columnSpan > 1)
+				{
+					int covered = n.spacing * (c.columnSpan - 1) ;
+
+					for (int col = c.column ; col < c.column + c.columnSpan ; ++col)
+						covered += info.columnMin [col] ;
+
+					if (c.measuredWidth > covered)
+						info.columnMin [c.column + c.columnSpan - 1] += c.measuredWidth - covered ;
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// Gives a rectangle to a node.  Nothing is done if the node was not
+// modified and already has this rectangle.
+//
+// Parameters:
+//
+// const int node    -> The node.
+// const RECT & rect -> The rectangle, margin included.
+//-----------------------------------------------------------------
+
+void Win::Layout::ArrangeNode (const int node, const RECT & rect)
+{
+	Node & n = _nodes [node] ;
+
+	bool moved = !n.arranged || n.rect.left != rect.left || n.rect.top != rect.top ||
+				 n.rect.right != rect.right || n.rect.bottom != rect.bottom ;
+
+	if (!moved && !n.arrangeDirty && n.shown == ShownVisible)
+		return ;
+
+	++_visited ;
+
+	n.rect         = rect ;
+	n.arranged     = true ;
+	n.arrangeDirty = false ;
+
+	bool show = n.shown != ShownVisible ;
+	n.shown   = ShownVisible ;
+
+	// The area inside the margin, limited by the maximum size.
+	RECT inner = rect ;
+	inner.left   += n.margin ;
+	inner.top    += n.margin ;
+	inner.right  -= n.margin ;
+	inner.bottom -= n.margin ;
+
+	if (inner.right < inner.left)
+		inner.right = inner.left ;
+
+	if (inner.bottom < inner.top)
+		inner.bottom = inner.top ;
+
+	if (inner.right - inner.left > n.maxWidth)
+		inner.right = inner.left + n.maxWidth ;
+
+	if (inner.bottom - inner.top > n.maxHeight)
+		inner.bottom = inner.top + n.maxHeight ;
+
+	switch (n.kind)
+	{
+	case Leaf:
+		if (n.win != NULL)
+		{
+			Move move ;
+			move.win  = n.win ;
+			move.rect = inner ;
+			move.show = show ;
+			move.hide = false ;
+
+			_moves.push_back (move) ;
+		}
+		break ;
+
+	case Stack:
+		ArrangeStack (node, inner) ;
+		break ;
+
+	case Grid:
+		ArrangeGrid (node, inner) ;
+		break ;
+
+	case Dock:
+		ArrangeDock (node, inner) ;
+		break ;
+
+	default:
+		break ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Arranges the children of a stack.  Each child gets its minimum
+// size along the stack, plus its share of the space left, and the
+// whole size across.
+//
+// Parameters:
+//
+// const int node     -> The stack.
+// const RECT & inner -> The area of the children.
+//-----------------------------------------------------------------
+
+void Win::Layout::ArrangeStack (const int node, const RECT & inner)
+{
+	const Node & n  = _nodes [node] ;
+	bool horizontal = n.horizontal ;
+	int  count      = 0 ;
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+	{
+		if (_nodes [child].visible)
+			++count ;
+	}
+
+	// The frame of this stack in _scratch:  minimums, maximums,
+	// weights and sizes of the visible children.
+	size_t base = _scratch.size () ;
+	_scratch.resize (base + 4 * count) ;
+
+	int i = 0 ;
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+	{
+		const Node & c = _nodes [child] ;
+
+		if (!c.visible)
+			continue ;
+
+		_scratch [base + i]             = horizontal ? c.measuredWidth : c.measuredHeight ;
+		_scratch [base + count + i]     = AddMargin (horizontal ? c.maxWidth : c.maxHeight, c.margin) ;
+		_scratch [base + 2 * count + i] = c.stretch ;
+		++i ;
+	}
+
+	int length  = horizontal ? inner.right - inner.left : inner.bottom - inner.top ;
+	int spacing = count > 1 ? n.spacing * (count - 1) : 0 ;
+
+	Distribute (base, count, length > spacing ? length - spacing : 0) ;
+
+	int pos = horizontal ? inner.left : inner.top ;
+	i = 0 ;
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+	{
+		if (!_nodes [child].visible)
+		{
+			HideNode (child) ;
+			continue ;
+		}
+
+		int size  = _scratch [base + 3 * count + i] ;
+		RECT rect = inner ;
+
+		if (horizontal)
+		{
+			rect.left  = pos ;
+			rect.right = pos + size ;
+		}
+		else
+		{
+			rect.top    = pos ;
+			rect.bottom = pos + size ;
+		}
+
+		ArrangeNode (child, rect) ;
+
+		pos += size + n.spacing ;
+		++i ;
+	}
+
+	_scratch.resize (base) ;
+}
+
+//-----------------------------------------------------------------
+// Arranges the children of a grid in their cells.
+//
+// Parameters:
+//
+// const int node     -> The grid.
+// const RECT & inner -> The area of the children.
+//-----------------------------------------------------------------
+
+void Win::Layout::ArrangeGrid (const int node, const RECT & inner)
+{
+	const Node & n  = _nodes [node] ;
+	GridInfo & info = _grids [n.grid] ;
+
+	DistributeLines (info.columnMin, info.columnStretch, inner.left, inner.right - inner.left, n.spacing, info.columnStart) ;
+	DistributeLines (info.rowMin, info.rowStretch, inner.top, inner.bottom - inner.top, n.spacing, info.rowStart) ;
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+	{
+		const Node & c = _nodes [child] ;
+
+		if (!c.visible)
+		{
+			HideNode (child) ;
+			continue ;
+		}
+
+		RECT rect ;
+		rect.left   = info.columnStart [c.column] ;
+		rect.top    = info.rowStart [c.row] ;
+		rect.right  = info.columnStart [c.column + c.columnSpan] - n.spacing ;
+		rect.bottom = info.rowStart [c.row + c.rowSpan] - n.spacing ;
+
+		ArrangeNode (child, rect) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Arranges the children of a dock.  Each child takes its minimum
+// size on its side of the space left by the children before it.
+//
+// Parameters:
+//
+// const int node     -> The dock.
+// const RECT & inner -> The area of the children.
+//-----------------------------------------------------------------
+
+void Win::Layout::ArrangeDock (const int node, const RECT & inner)
+{
+	const Node & n = _nodes [node] ;
+	RECT left      = inner ;
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+	{
+		const Node & c = _nodes [child] ;
+
+		if (!c.visible)
+		{
+			HideNode (child) ;
+			continue ;
+		}
+
+		int  width  = left.right - left.left ;
+		int  height = left.bottom - left.top ;
+		int  w      = c.measuredWidth < width ? c.measuredWidth : width ;
+		int  h      = c.measuredHeight < height ? c.measuredHeight : height ;
+		RECT rect   = left ;
+
+		switch (c.dock)
+		{
+		case DockLeft:
+			rect.right = left.left + w ;
+			left.left  = rect.right + n.spacing < left.right ? rect.right + n.spacing : left.right ;
+			break ;
+
+		case DockRight:
+			rect.left  = left.right - w ;
+			left.right = rect.left - n.spacing > left.left ? rect.left - n.spacing : left.left ;
+			break ;
+
+		case DockTop:
+			rect.bottom = left.top + h ;
+			left.top    = rect.bottom + n.spacing < left.bottom ? rect.bottom + n.spacing : left.bottom ;
+			break ;
+
+		case DockBottom:
+			rect.top    = left.bottom - h ;
+			left.bottom = rect.top - n.spacing > left.top ? rect.top - n.spacing : left.top ;
+			break ;
+
+		case DockFill:
+			break ;
+		}
+
+		ArrangeNode (child, rect) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Hides the controls of a hidden node.  The node will be arranged
+// again when it is shown.
+//
+// Parameters:
+//
+// const int node -> The node.
+//-----------------------------------------------------------------
+
+void Win::Layout::HideNode (const int node)
+{
+	Node & n = _nodes [node] ;
+
+	if (n.shown == ShownHidden)
+		return ;
+
+	n.shown    = ShownHidden ;
+	n.arranged = false ;
+
+	if (n.kind == Leaf && n.win != NULL)
+	{
+		Move move ;
+		move.win  = n.win ;
+		move.rect = n.rect ;
+		move.show = false ;
+		move.hide = true ;
+
+		_moves.push_back (move) ;
+	}
+
+	for (int child = n.first ; child != NoNode ; child = _nodes [child].next)
+		HideNode (child) ;
+}
+
+//-----------------------------------------------------------------
+// Shares a length between the children of a stack.  Each child gets
+// its minimum, then the space left is given in proportion of the
+// weights.  A child reaching its maximum stops growing and the rest
+// of its share goes to the others.
+//
+// Parameters:
+//
+// const size_t base -> Frame in _scratch:  count minimums, count
+//						maximums, count weights and count sizes.
+// const int count   -> Number of children.
+// const int total   -> The length to share.
+//-----------------------------------------------------------------
+
+void Win::Layout::Distribute (const size_t base, const int count, const int total)
+{
+	const size_t mins    = base ;
+	const size_t maxs    = base + count ;
+	const size_t weights = base + 2 * count ;
+	const size_t sizes   = base + 3 * count ;
+
+	int extra = total ;
+
+	for (int i = 0 ; i < count ; ++i)
+	{
+		_scratch [sizes + i] = _scratch [mins + i] ;
+		extra -= _scratch [mins + i] ;
+	}
+
+	while (extra > 0)
+	{
+		LONGLONG weight = 0 ;
+
+		for (int i = 0 ; i < count ; ++i)
+		{
+			if (_scratch [weights + i] > 0 && _scratch [sizes + i] < _scratch [maxs + i])
+				weight += _scratch [weights + i] ;
+		}
+
+		if (weight == 0)
+			break ;
+
+		// Cumulative rounding gives away exactly extra.
+		LONGLONG cumulative = 0 ;
+		int      given      = 0 ;
+		bool     clamped    = false ;
+
+		for (int i = 0 ; i < count ; ++i)
+		{
+			int w = _scratch [weights + i] ;
+
+			if (w <= 0 || _scratch [sizes + i] >= _scratch [maxs + i])
+				continue ;
+
+			int share = static_cast <int> (extra * (cumulative + w) / weight - extra * cumulative / weight) ;
+			int room  = _scratch [maxs + i] - _scratch [sizes + i] ;
+
+			cumulative += w ;
+
+			if (share > room)
+			{
+				share   = room ;
+				clamped = true ;
+			}
+
+			_scratch [sizes + i] += share ;
+			given += share ;
+		}
+
+		extra -= given ;
+
+		if (!clamped)
+			break ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Shares a length between the rows or the columns of a grid and
+// computes where each one starts.
+//
+// Parameters:
+//
+// const std::vector <int> & mins    -> Minimum size of the lines.
+// const std::vector <int> & stretch -> Weight of the lines.
+// const int start                   -> Position of the first line.
+// const int total                   -> The length to share, spacing
+//										included.
+// const int spacing                 -> Space between the lines.
+// std::vector <int> & starts        -> Will contain the position of
+//										each line, plus the end of the
+//										last one followed by spacing.
+//-----------------------------------------------------------------
+
+void Win::Layout::DistributeLines (const std::vector <int> & mins, const std::vector <int> & stretch,
+								   const int start, const int total, const int spacing, std::vector <int> & starts)
+{
+	size_t   count  = mins.size () ;
+	int      extra  = total - (count > 1 ? spacing * static_cast <int> (count - 1) : 0) ;
+	LONGLONG weight = 0 ;
+
+	for (size_t i = 0 ; i < count ; ++i)
+	{
+		extra  -= mins [i] ;
+		weight += stretch [i] ;
+	}
+
+	starts.resize (count + 1) ;
+
+	LONGLONG cumulative = 0 ;
+	int      pos        = start ;
+
+	for (size_t i = 0 ; i < count ; ++i)
+	{
+		int size = mins [i] ;
+
+		if (extra > 0 && weight > 0)
+		{
+			size += static_cast <int> (extra * (cumulative + stretch [i]) / weight - extra * cumulative / weight) ;
+			cumulative += stretch [i] ;
+		}
+
+		starts [i] = pos ;
+		pos += size + spacing ;
+	}
+
+	starts [count] = pos ;
+}
+
+//-----------------------------------------------------------------
+// Determines if a kind of node contains other nodes.
+//
+// Return value:  True for stacks, grids and docks.
+//
+// Parameters:
+//
+// const Kind kind -> The kind of node.
+//-----------------------------------------------------------------
+
+bool Win::Layout::IsContainer (const Kind kind)
+{
+	return kind == Stack || kind == Grid || kind == Dock ;
+}
+
+//-----------------------------------------------------------------
+// Adds a margin on both sides of a size.
+//
+// Return value:  The size with the margin, Unlimited stays Unlimited.
+//
+// Parameters:
+//
+// const int size   -> The size.
+// const int margin -> The margin.
+//-----------------------------------------------------------------
+
+int Win::Layout::AddMargin (const int size, const int margin)
+{
+	return size >= Unlimited - 2 * margin ? Unlimited : size + 2 * margin ;
+}
\ No newline at end of file
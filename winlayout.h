@@ -0,0 +1,259 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Layout.
+//-----------------------------------------------------------------
+
+#if !defined (WINLAYOUT_H)
+
+	#define WINLAYOUT_H
+	#include "useunicode.h"
+	#include "win.h"
+	#include "winexception.h"
+	#include <windows.h>
+	#include <limits.h>
+	#include <vector>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// A Win::Layout object positions the child controls of a window
+		// from a tree of nodes instead of a MoveWindow call per child in
+		// OnSize.  Containers are stacks, grids and docks.  Every node has
+		// a minimum size, a maximum size, a margin and a stretch weight
+		// telling how it shares the space left by the minimum sizes.
+		//
+		// The solver only uses integer arithmetic and never calls the
+		// system.  It remembers the rectangle given to each node:  on a new
+		// Arrange, a subtree whose rectangle did not change and whose nodes
+		// were not modified is skipped.  The controls whose rectangle did
+		// change are queued as moves, which Apply sends to the system in a
+		// single BeginDeferWindowPos/EndDeferWindowPos batch.  Typical use
+		// in OnSize:
+		//
+		// _layout.Update (width, height) ;
+		//-----------------------------------------------------------------
+
+		class Layout
+		{
+		public:
+
+			enum
+			{
+				Root      = 0,       // The root node, a vertical stack by default.
+				Unlimited = INT_MAX  // No maximum size.
+			} ;
+
+			//-----------------------------------------------------------------
+			// The side of a dock container a child is attached to.  A Fill
+			// child takes the space left by the children before it.
+			//-----------------------------------------------------------------
+
+			enum DockSide
+			{
+				DockLeft,
+				DockTop,
+				DockRight,
+				DockBottom,
+				DockFill
+			} ;
+
+			//-----------------------------------------------------------------
+			// A control to move, computed by Arrange.
+			//-----------------------------------------------------------------
+
+			struct Move
+			{
+				HWND win ;
+				RECT rect ;
+				bool show ;   // True to show the control.
+				bool hide ;   // True to hide the control.
+			} ;
+
+			Layout () ;
+
+			int AddStack (const int parent, const bool horizontal) ;
+			int AddGrid (const int parent, const int rows, const int columns) ;
+			int AddDock (const int parent) ;
+			int AddControl (const int parent, const Win::dow::Handle win) ;
+			int AddSpacer (const int parent) ;
+			void Remove (const int node) ;
+
+			void SetMinSize (const int node, const int width, const int height) ;
+			void SetMaxSize (const int node, const int width, const int height) ;
+			void SetStretch (const int node, const int stretch) ;
+			void SetMargin (const int node, const int margin) ;
+			void SetSpacing (const int node, const int spacing) ;
+			void SetVisible (const int node, const bool visible) ;
+			void SetCell (const int node, const int row, const int column, const int rowSpan = 1, const int columnSpan = 1) ;
+			void SetDock (const int node, const DockSide side) ;
+			void SetRowStretch (const int grid, const int row, const int stretch) ;
+			void SetColumnStretch (const int grid, const int column, const int stretch) ;
+			void SetHorizontal (const int stack, const bool horizontal) ;
+
+			void Arrange (const RECT & rect) ;
+			void Apply () ;
+
+			//-----------------------------------------------------------------
+			// Arranges the nodes in a client area and moves the controls.
+			//
+			// Parameters:
+			//
+			// const int width  -> Width of the client area.
+			// const int height -> Height of the client area.
+			//-----------------------------------------------------------------
+
+			void Update (const int width, const int height)
+			{
+				RECT rect = {0, 0, width, height} ;
+				Arrange (rect) ;
+				Apply () ;
+			}
+
+			void GetMinSize (int & width, int & height) ;
+
+			//-----------------------------------------------------------------
+			// Obtains the rectangle given to a node by the last Arrange.
+			//
+			// Return value:  The rectangle, margin included.
+			//
+			// Parameters:
+			//
+			// const int node -> The node.
+			//-----------------------------------------------------------------
+
+			const RECT & GetRect (const int node) const
+			{
+				return GetNode (node).rect ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the moves computed by the last Arrange and not applied
+			// yet.
+			//
+			// Return value:  The moves.
+			//-----------------------------------------------------------------
+
+			const std::vector <Move> & GetMoves () const
+			{
+				return _moves ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the number of nodes the last Arrange went through.
+			// Nodes in skipped subtrees are not counted.
+			//
+			// Return value:  The number of nodes.
+			//-----------------------------------------------------------------
+
+			int GetVisitedCount () const
+			{
+				return _visited ;
+			}
+
+		private:
+
+			Layout (const Layout &) ;
+			Layout & operator = (const Layout &) ;
+
+			enum Kind
+			{
+				Unused,
+				Leaf,
+				Stack,
+				Grid,
+				Dock
+			} ;
+
+			enum { NoNode = -1 } ;
+
+			//-----------------------------------------------------------------
+			// The visibility given to a node by the moves.  A control starts
+			// Unknown, so its first move shows or hides it.
+			//-----------------------------------------------------------------
+
+			enum Shown
+			{
+				ShownUnknown,
+				ShownVisible,
+				ShownHidden
+			} ;
+
+			//-----------------------------------------------------------------
+			// A node of the tree.  Children are linked through next.  Sizes
+			// do not include the margin, measured does.
+			//-----------------------------------------------------------------
+
+			struct Node
+			{
+				Kind     kind ;
+				int      parent ;
+				int      first ;
+				int      last ;
+				int      next ;
+				HWND     win ;          // Control of a leaf, NULL for a spacer.
+				int      minWidth ;
+				int      minHeight ;
+				int      maxWidth ;
+				int      maxHeight ;
+				int      stretch ;
+				int      margin ;
+				int      spacing ;      // Space between the children of a container.
+				bool     horizontal ;   // Direction of a stack.
+				int      grid ;         // Index in _grids of a grid container.
+				int      row ;          // Cell of a child of a grid.
+				int      column ;
+				int      rowSpan ;
+				int      columnSpan ;
+				DockSide dock ;         // Side of a child of a dock.
+				bool     visible ;
+				Shown    shown ;        // What the moves last did to the node.
+				bool     measureDirty ; // The measured size must be computed again.
+				bool     arrangeDirty ; // The subtree must be arranged again.
+				bool     arranged ;     // The node has a rectangle.
+				int      measuredWidth ;
+				int      measuredHeight ;
+				RECT     rect ;
+			} ;
+
+			//-----------------------------------------------------------------
+			// The rows and columns of a grid container.
+			//-----------------------------------------------------------------
+
+			struct GridInfo
+			{
+				std::vector <int> rowStretch ;
+				std::vector <int> columnStretch ;
+				std::vector <int> rowMin ;       // Minimum height of each row.
+				std::vector <int> columnMin ;    // Minimum width of each column.
+				std::vector <int> rowStart ;     // Top of each row, then the bottom of the last.
+				std::vector <int> columnStart ;  // Left of each column, then the right of the last.
+			} ;
+
+			int AddNode (const int parent, const Kind kind) ;
+			Node & GetNode (const int node) ;
+			const Node & GetNode (const int node) const ;
+			void Invalidate (const int node) ;
+
+			void Measure (const int node) ;
+			void MeasureGrid (const int node) ;
+
+			void ArrangeNode (const int node, const RECT & rect) ;
+			void ArrangeStack (const int node, const RECT & inner) ;
+			void ArrangeGrid (const int node, const RECT & inner) ;
+			void ArrangeDock (const int node, const RECT & inner) ;
+			void HideNode (const int node) ;
+
+			void Distribute (const size_t base, const int count, const int total) ;
+			static void DistributeLines (const std::vector <int> & mins, const std::vector <int> & stretch,
+										 const int start, const int total, const int spacing, std::vector <int> & starts) ;
+			static bool IsContainer (const Kind kind) ;
+			static int AddMargin (const int size, const int margin) ;
+
+			std::vector <Node>     _nodes ;
+			std::vector <GridInfo> _grids ;
+			std::vector <Move>     _moves ;
+			std::vector <int>      _scratch ;  // Frames of Distribute, one per stack being arranged.
+			int                    _visited ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
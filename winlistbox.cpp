@@ -85,6 +85,88 @@
 				return val ;
 			}
 
+			//-------------------------------------------------------------------------
+			// Adds many strings at the end of the list box (Unless LB_SORT is 
+			// specified.)  Redrawing is suspended and the storage of the list box is
+			// allocated once for all the strings, so the list box is repainted only
+			// once no matter how many strings are added.
+			//
+			// Return value: The number of strings in the list box.
+			//
+			// Parameters:
+			//
+			// const std::vector <std::tstring> & strs -> The strings to be added.
+			// const bool presort -> If true, the strings are sorted before being 
+			//						 added.  A list box with LB_SORT then never 
+			//						 has to move its items to insert a string.
+			//-------------------------------------------------------------------------
+
+			int Win::ListBoxHandle::AddStrings (const std::vector <std::tstring> & strs, const bool presort)
+			{
+				if (strs.empty ())
+					return GetCount () ;
+
+				std::vector <std::tstring> sorted ;
+				const std::vector <std::tstring> * src = &strs ;
+
+				if (presort)
+				{
+					sorted = strs ;
+					SortStrings (sorted) ;
+					src = &sorted ;
+				}
+
+				Win::dow::NoRedraw noRedraw (*this) ;
+				SetInitStorage (static_cast <int> (src->size ()), GetStringStorage (*src)) ;
+
+				for (std::vector <std::tstring>::const_iterator it = src->begin () ; it != src->end () ; ++it)
+				{
+					int val = SendMessage (LB_ADDSTRING, 0, reinterpret_cast <LPARAM> (it->c_str ())) ;
+
+					if (val == LB_ERR || val == LB_ERRSPACE)
+						throw Win::Exception (TEXT("Error, could not add a string to the list box")) ;
+				}
+
+				return GetCount () ;
+			}
+
+			//-------------------------------------------------------------------------
+			// Inserts many strings at the specified index of a list box.  Redrawing 
+			// is suspended and the storage of the list box is allocated once for all
+			// the strings.
+			//
+			// Return value: The index of the last string inserted.
+			//
+			// Parameters:
+			//
+			// const int index -> The position where the first string will be 
+			//					  inserted.  -1 to add the strings at the end.
+			// const std::vector <std::tstring> & strs -> The strings to be inserted.
+			//-------------------------------------------------------------------------
+
+			int Win::ListBoxHandle::InsertStrings (const int index, const std::vector <std::tstring> & strs)
+			{
+				int val = index ;
+
+				if (strs.empty ())
+					return val ;
+
+				Win::dow::NoRedraw noRedraw (*this) ;
+				SetInitStorage (static_cast <int> (strs.size ()), GetStringStorage (strs)) ;
+
+				for (std::vector <std::tstring>::const_iterator it = strs.begin () ; it != strs.end () ; ++it)
+				{
+					val = SendMessage (LB_INSERTSTRING, index < 0 ? -1 : val, reinterpret_cast <LPARAM> (it->c_str ())) ;
+
+					if (val == LB_ERR || val == LB_ERRSPACE)
+						throw Win::Exception (TEXT("Error, could not insert a string to the list box")) ;
+
+					++val ;
+				}
+
+				return val - 1 ;
+			}
+
 			//-------------------------------------------------------------------------
 			// Deletes the string at the specified index of a list box.
 			//
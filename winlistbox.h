@@ -7,6 +7,7 @@
 	#define WINLISTBOX_H
 	#include "useunicode.h"
 	#include "wincontrol.h"
+	#include <vector>
 
 	namespace Win
 	{ 
@@ -118,6 +119,8 @@
 			int AddFile (const std::tstring file) ;
 			int AddString (const std::tstring str) ;
 			int InsertString (const int index, const std::tstring str) ;
+			int AddStrings (const std::vector <std::tstring> & strs, const bool presort = false) ;
+			int InsertStrings (const int index, const std::vector <std::tstring> & strs) ;
 
 			void ReplaceString (const int index, const std::tstring str)
 			{
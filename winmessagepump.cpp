@@ -1,6 +1,7 @@
 #include "winmessagepump.h"
 
 #include "winexception.h"
+#include "wincommandstate.h"
 
 //------------------------------------------------------------
 // Remove a dialog handle from the list.  Use this method when 
@@ -28,6 +29,8 @@ int Win::MessagePump::Pump ()
 	int status ;
 
 
+	Idle () ;
+
 	//Wait for a message.
     while ((status = ::GetMessage (&message, NULL, 0, 0 )) != 0)
     {
@@ -52,6 +55,8 @@ int Win::MessagePump::Pump ()
 				::DispatchMessage (&message) ;
 			}
 		}
+
+		Idle () ;
     }
 
     return message.wParam ;
@@ -70,6 +75,8 @@ int Win::MessagePump::MDIPump ()
 	int status ;
 
 
+	Idle () ;
+
 	//Wait for a message.
     while ((status = ::GetMessage (&message, NULL, 0, 0 )) != 0)
     {
@@ -94,6 +101,8 @@ int Win::MessagePump::MDIPump ()
 				::DispatchMessage (&message) ;
 			}
 		}
+
+		Idle () ;
     }
 
     return message.wParam ;
@@ -136,5 +145,36 @@ bool Win::MessagePump::PumpPeek ()
 		}
     }
 
+	Idle () ;
 	return true ;
 }
+
+//------------------------------------------------------------
+// Updates the dirty commands of the command state engine, one
+// batch at a time, and calls the idle handlers until no work is
+// left or a message arrives.
+//------------------------------------------------------------
+
+void Win::MessagePump::Idle ()
+{
+	bool more = (_commandState != NULL && _commandState->IsDirty ()) || !_idleHandlers.empty () ;
+
+	MSG message ;
+
+	while (more && !::PeekMessage (&message, NULL, 0, 0, PM_NOREMOVE))
+	{
+		more = false ;
+
+		if (_commandState != NULL && _commandState->IsDirty ())
+			more = _commandState->Update () ;
+
+		// A handler may remove itself.
+		for (IdleIter it = _idleHandlers.begin () ; it != _idleHandlers.end () ; )
+		{
+			Win::IdleHandler * handler = *it++ ;
+
+			if (handler->OnIdle ())
+				more = true ;
+		}
+	}
+}
\ No newline at end of file
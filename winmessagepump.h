@@ -12,6 +12,29 @@
 
 	namespace Win
 	{
+		class CommandState ;
+
+		//------------------------------------------------------------
+		// Interface of the objects doing background work while the
+		// message queue is empty.  See Win::MessagePump::AddIdleHandler.
+		//------------------------------------------------------------
+
+		class IdleHandler
+		{
+		public:
+
+			virtual ~IdleHandler ()
+			{}
+
+			//------------------------------------------------------------
+			// Does a short piece of work.
+			//
+			// Return value:  True if work remains, else false.
+			//------------------------------------------------------------
+
+			virtual bool OnIdle () = 0 ;
+		} ;
+
 		//------------------------------------------------------------
 		// Win::MessagePump implements a message loop.  The message
 		// loop dispatch messages to the window procedure.
@@ -20,6 +43,7 @@
 		class MessagePump
 		{
 			typedef std::list<HWND>::iterator DlgIter;
+			typedef std::list<Win::IdleHandler *>::iterator IdleIter;
 		public:
 
 			//------------------------------------------------------------
@@ -27,9 +51,10 @@
 			//------------------------------------------------------------
 
 			MessagePump ()
-				: _hAccel    (NULL),
-				  _winTop    (NULL),
-				  _mdiClient (NULL)
+				: _hAccel       (NULL),
+				  _winTop       (NULL),
+				  _mdiClient    (NULL),
+				  _commandState (NULL)
 			{}
 
 			//------------------------------------------------------------
@@ -82,16 +107,62 @@
 				_dlgList.push_back (hDlg) ; 
 			}
 
+			//------------------------------------------------------------
+			// Gives the message loop a command state engine to update
+			// when the message queue is empty.
+			//
+			// Parameters:  
+			//
+			// Win::CommandState * state -> The engine, or NULL to stop
+			//								updating it.
+			//------------------------------------------------------------
+
+			void SetCommandState (Win::CommandState * state)
+			{
+				_commandState = state ;
+			}
+
+			//------------------------------------------------------------
+			// Adds an object called when the message queue is empty.  The
+			// object must be removed before it is destroyed.
+			//
+			// Parameters:  
+			//
+			// Win::IdleHandler & handler -> The object.
+			//------------------------------------------------------------
+
+			void AddIdleHandler (Win::IdleHandler & handler)
+			{
+				_idleHandlers.push_back (&handler) ;
+			}
+
+			//------------------------------------------------------------
+			// Removes an object added with AddIdleHandler.
+			//
+			// Parameters:  
+			//
+			// Win::IdleHandler & handler -> The object.
+			//------------------------------------------------------------
+
+			void RemoveIdleHandler (Win::IdleHandler & handler)
+			{
+				_idleHandlers.remove (&handler) ;
+			}
+
 			void RemoveDialogFilter (const Win::dow::Handle hDlg) ; // Remove dialog handle.
 			int Pump () ; //GetMessage.
 			int MDIPump () ; //GetMessage. for MDI app.
 			bool PumpPeek () ; // Peek message.
 
 		private:
+			void Idle () ; // Updates the command state and calls the idle handlers.
+
 			std::list<HWND> _dlgList ; // List of dialog handle.
 			HACCEL	        _hAccel ;  // Handle of the keyboard accelerators
 			HWND	        _winTop ;  // Handle of the top window.
 			HWND			_mdiClient ; // Handle of the MDI client used for MDI application.
+			Win::CommandState * _commandState ; // Updated when the queue is empty, or NULL.
+			std::list<Win::IdleHandler *> _idleHandlers ; // Called when the queue is empty.
 		} ;
 	}
 
@@ -0,0 +1,474 @@
+#include "winquantizer.h"
+#include "winexception.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// Constructor.  No colors are chosen yet.
+//-----------------------------------------------------------------
+
+Win::Palette::Quantizer::Quantizer ()
+	: _leafCount (0),
+	  _maxColors (256)
+{
+	for (int i = 0 ; i < DEPTH ; ++i)
+		_reducible [i] = NO_NODE ;
+}
+
+//-----------------------------------------------------------------
+// Chooses the colors that best represent an image.
+//
+// Parameters:
+//
+// const DWORD * pixels -> The pixels of the image.
+// const int width      -> Width of the image.
+// const int height     -> Height of the image.
+// const int stride     -> Number of pixels from one row to the next.
+// const int maxColors  -> Maximum number of colors to choose, 2 to 256.
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::Build (const DWORD * pixels, const int width, const int height, const int stride, const int maxColors)
+{
+	if (maxColors < 2 || maxColors > 256)
+		throw Win::Exception (TEXT("Error, a palette must have 2 to 256 colors")) ;
+
+	_nodes.clear () ;
+	_leafCount = 0 ;
+	_maxColors = maxColors ;
+
+	for (int i = 0 ; i < DEPTH ; ++i)
+		_reducible [i] = NO_NODE ;
+
+	NewNode (0) ;
+
+	for (int y = 0 ; y < height ; ++y)
+	{
+		const DWORD * row = pixels + y * stride ;
+
+		for (int x = 0 ; x < width ; ++x)
+		{
+			AddColor (row [x] & 0xFFFFFF) ;
+
+			while (_leafCount > _maxColors)
+				Reduce () ;
+		}
+	}
+
+	_colors.clear () ;
+	CollectColors (0) ;
+
+	_nearest.assign (32768, -1) ;
+}
+
+//-----------------------------------------------------------------
+// Converts an image to the chosen colors.
+//
+// Parameters:
+//
+// const DWORD * pixels -> The pixels of the image.
+// const int width      -> Width of the image.
+// const int height     -> Height of the image.
+// const int stride     -> Number of pixels from one row to the next.
+// BYTE * indices       -> Will contain width * height color indices, in
+//						   top-down rows.
+// const bool dither    -> If true, spreads the error of each pixel to
+//						   its neighbours (Floyd-Steinberg).
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::Remap (const DWORD * pixels, const int width, const int height, const int stride, BYTE * indices, const bool dither)
+{
+	if (_colors.empty ())
+		throw Win::Exception (TEXT("Error, no colors were chosen")) ;
+
+	if (!dither)
+	{
+		for (int y = 0 ; y < height ; ++y)
+		{
+			const DWORD * row = pixels + y * stride ;
+
+			for (int x = 0 ; x < width ; ++x)
+				*indices++ = FindNearest ((row [x] >> 16) & 0xFF, (row [x] >> 8) & 0xFF, row [x] & 0xFF) ;
+		}
+
+		return ;
+	}
+
+	// Errors of the current and next rows, 16 times their value, with
+	// one pixel of margin on each side.
+	std::vector <int> errors ((width + 2) * 3 * 2, 0) ;
+	int *             current = &errors [0] ;
+	int *             next    = &errors [(width + 2) * 3] ;
+
+	for (int y = 0 ; y < height ; ++y)
+	{
+		const DWORD * row = pixels + y * stride ;
+
+		std::fill (next, next + (width + 2) * 3, 0) ;
+
+		for (int x = 0 ; x < width ; ++x)
+		{
+			int value [3] ;
+			value [0] = static_cast <int> ((row [x] >> 16) & 0xFF) + current [(x + 1) * 3]     / 16 ;
+			value [1] = static_cast <int> ((row [x] >> 8)  & 0xFF) + current [(x + 1) * 3 + 1] / 16 ;
+			value [2] = static_cast <int> ( row [x]        & 0xFF) + current [(x + 1) * 3 + 2] / 16 ;
+
+			for (int k = 0 ; k < 3 ; ++k)
+				value [k] = value [k] < 0 ? 0 : value [k] > 255 ? 255 : value [k] ;
+
+			BYTE  index = FindNearest (value [0], value [1], value [2]) ;
+			DWORD color = _colors [index] ;
+
+			*indices++ = index ;
+
+			int error [3] ;
+			error [0] = value [0] - static_cast <int> ((color >> 16) & 0xFF) ;
+			error [1] = value [1] - static_cast <int> ((color >> 8)  & 0xFF) ;
+			error [2] = value [2] - static_cast <int> ( color        & 0xFF) ;
+
+			for (int k = 0 ; k < 3 ; ++k)
+			{
+				current [(x + 2) * 3 + k] += error [k] * 7 ;
+				next    [ x      * 3 + k] += error [k] * 3 ;
+				next    [(x + 1) * 3 + k] += error [k] * 5 ;
+				next    [(x + 2) * 3 + k] += error [k] ;
+			}
+		}
+
+		std::swap (current, next) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Copies the chosen colors in a palette.
+//
+// Parameters:
+//
+// Win::Palette::Data & data -> The palette, resized to the number of
+//								colors.
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::FillPalette (Win::Palette::Data & data) const
+{
+	if (_colors.empty ())
+		throw Win::Exception (TEXT("Error, no colors were chosen")) ;
+
+	data.Resize (static_cast <unsigned short> (_colors.size ())) ;
+
+	for (size_t i = 0 ; i < _colors.size () ; ++i)
+	{
+		data.SetEntry (static_cast <int> (i), static_cast <BYTE> (_colors [i] >> 16),
+					   static_cast <BYTE> (_colors [i] >> 8), static_cast <BYTE> (_colors [i])) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Creates a palette based DIB section from a 32 bits image.  Colors
+// are chosen first if Build was not called or chose too many colors.
+//
+// Return value:  A strong handle on the DIB section.
+//
+// Parameters:
+//
+// const DWORD * pixels -> The pixels of the image.
+// const int width      -> Width of the image.
+// const int height     -> Height of the image.
+// const int stride     -> Number of pixels from one row to the next.
+// const int bitCount   -> 8, 4 or 1 bits per pixel.
+// const bool dither    -> If true, the image is dithered.
+//-----------------------------------------------------------------
+
+Win::Bitmap::DIBSection::StrongHandle Win::Palette::Quantizer::CreateDIBSection (const DWORD * pixels, const int width, const int height, const int stride,
+																				  const int bitCount, const bool dither)
+{
+	if (bitCount != 1 && bitCount != 4 && bitCount != 8)
+		throw Win::Exception (TEXT("Error, a palette based DIB section must have 1, 4 or 8 bits per pixel")) ;
+
+	if (_colors.empty () || GetColorCount () > (1 << bitCount))
+		Build (pixels, width, height, stride, 1 << bitCount) ;
+
+	std::vector <BYTE> indices (width * height) ;
+	Remap (pixels, width, height, stride, &indices [0], dither) ;
+
+	std::vector <BYTE> buffer (sizeof (BITMAPINFOHEADER) + 256 * sizeof (RGBQUAD), 0) ;
+	BITMAPINFO *       info = reinterpret_cast <BITMAPINFO *> (&buffer [0]) ;
+
+	info->bmiHeader.biSize        = sizeof (BITMAPINFOHEADER) ;
+	info->bmiHeader.biWidth       = width ;
+	info->bmiHeader.biHeight      = height ;
+	info->bmiHeader.biPlanes      = 1 ;
+	info->bmiHeader.biBitCount    = static_cast <WORD> (bitCount) ;
+	info->bmiHeader.biCompression = BI_RGB ;
+	info->bmiHeader.biClrUsed     = GetColorCount () ;
+
+	for (int i = 0 ; i < GetColorCount () ; ++i)
+	{
+		info->bmiColors [i].rgbRed   = static_cast <BYTE> (_colors [i] >> 16) ;
+		info->bmiColors [i].rgbGreen = static_cast <BYTE> (_colors [i] >> 8) ;
+		info->bmiColors [i].rgbBlue  = static_cast <BYTE> (_colors [i]) ;
+	}
+
+	void *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, info, DIB_RGB_COLORS, &bits, NULL, 0) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not create a DIB section")) ;
+
+	// Pack the indices in bottom-up rows.
+	int dibStride = ((width * bitCount + 31) / 32) * 4 ;
+
+	for (int y = 0 ; y < height ; ++y)
+	{
+		const BYTE * src  = &indices [y * width] ;
+		BYTE *       dest = static_cast <BYTE *> (bits) + (height - 1 - y) * dibStride ;
+
+		::ZeroMemory (dest, dibStride) ;
+
+		for (int x = 0 ; x < width ; ++x)
+		{
+			if (bitCount == 8)
+				dest [x] = src [x] ;
+			else if (bitCount == 4)
+				dest [x / 2] |= src [x] << ((x & 1) ? 0 : 4) ;
+			else
+				dest [x / 8] |= src [x] << (7 - x % 8) ;
+		}
+	}
+
+	return Win::Bitmap::DIBSection::StrongHandle (h, static_cast <BYTE *> (bits)) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a node to the octree.
+//
+// Return value:  Index of the node.
+//
+// Parameters:
+//
+// const int level -> Level of the node, DEPTH for a leaf.
+//-----------------------------------------------------------------
+
+int Win::Palette::Quantizer::NewNode (const int level)
+{
+	Node node ;
+	node.red   = 0 ;
+	node.green = 0 ;
+	node.blue  = 0 ;
+	node.count = 0 ;
+	node.next  = NO_NODE ;
+	node.leaf  = level == DEPTH ;
+
+	for (int i = 0 ; i < 8 ; ++i)
+		node.children [i] = NO_NODE ;
+
+	int index = static_cast <int> (_nodes.size ()) ;
+
+	if (node.leaf)
+		++_leafCount ;
+	else
+	{
+		node.next = _reducible [level] ;
+		_reducible [level] = index ;
+	}
+
+	_nodes.push_back (node) ;
+	return index ;
+}
+
+//-----------------------------------------------------------------
+// Adds a pixel to the leaf of its color, creating the nodes on the
+// way if needed.
+//
+// Parameters:
+//
+// const DWORD color -> The color, 0x00RRGGBB.
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::AddColor (const DWORD color)
+{
+	int node = 0 ;
+
+	for (int level = 0 ; !_nodes [node].leaf ; ++level)
+	{
+		int shift = 7 - level ;
+		int child = (((color >> (16 + shift)) & 1) << 2) | (((color >> (8 + shift)) & 1) << 1) | ((color >> shift) & 1) ;
+
+		// NewNode may move the nodes, don't keep a reference.
+		if (_nodes [node].children [child] == NO_NODE)
+		{
+			int created = NewNode (level + 1) ;
+			_nodes [node].children [child] = created ;
+		}
+
+		node = _nodes [node].children [child] ;
+	}
+
+	Node & leaf = _nodes [node] ;
+
+	leaf.red   += (color >> 16) & 0xFF ;
+	leaf.green += (color >> 8)  & 0xFF ;
+	leaf.blue  +=  color        & 0xFF ;
+	++leaf.count ;
+}
+
+//-----------------------------------------------------------------
+// Merges the children of the deepest node that has some, reducing the
+// number of leaves.  If merging all of them would leave fewer colors
+// than allowed, only the smallest ones are merged in a sibling.
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::Reduce ()
+{
+	int level = DEPTH - 1 ;
+
+	while (level > 0 && _reducible [level] == NO_NODE)
+		--level ;
+
+	int    index = _reducible [level] ;
+	Node & node  = _nodes [index] ;
+	int    merged = 0 ;
+	int    excess = _leafCount - _maxColors ;
+	int    biggest = NO_NODE ;
+
+	for (int i = 0 ; i < 8 ; ++i)
+	{
+		if (node.children [i] != NO_NODE)
+		{
+			++merged ;
+
+			if (biggest == NO_NODE || _nodes [node.children [i]].count > _nodes [node.children [biggest]].count)
+				biggest = i ;
+		}
+	}
+
+	if (merged - 1 > excess)
+	{
+		// The children are leaves since the node is the deepest one.
+		for (; excess > 0 ; --excess)
+		{
+			int smallest = NO_NODE ;
+
+			for (int i = 0 ; i < 8 ; ++i)
+			{
+				if (i != biggest && node.children [i] != NO_NODE &&
+					(smallest == NO_NODE || _nodes [node.children [i]].count < _nodes [node.children [smallest]].count))
+				{
+					smallest = i ;
+				}
+			}
+
+			Node &       target = _nodes [node.children [biggest]] ;
+			const Node & source = _nodes [node.children [smallest]] ;
+
+			target.red   += source.red ;
+			target.green += source.green ;
+			target.blue  += source.blue ;
+			target.count += source.count ;
+
+			node.children [smallest] = NO_NODE ;
+			--_leafCount ;
+		}
+
+		return ;
+	}
+
+	_reducible [level] = node.next ;
+	merged = 0 ;
+
+	for (int i = 0 ; i < 8 ; ++i)
+	{
+		if (node.children [i] != NO_NODE)
+		{
+			const Node & child = _nodes [node.children [i]] ;
+
+			node.red   += child.red ;
+			node.green += child.green ;
+			node.blue  += child.blue ;
+			node.count += child.count ;
+
+			node.children [i] = NO_NODE ;
+			++merged ;
+		}
+	}
+
+	node.leaf   = true ;
+	_leafCount -= merged - 1 ;
+}
+
+//-----------------------------------------------------------------
+// Adds the average color of each leaf under a node to the chosen 
+// colors.
+//
+// Parameters:
+//
+// const int node -> Index of the node.
+//-----------------------------------------------------------------
+
+void Win::Palette::Quantizer::CollectColors (const int node)
+{
+	const Node & n = _nodes [node] ;
+
+	if (n.leaf)
+	{
+		if (n.count != 0)
+		{
+			DWORD red   = static_cast <DWORD> (n.red   / n.count) ;
+			DWORD green = static_cast <DWORD> (n.green / n.count) ;
+			DWORD blue  = static_cast <DWORD> (n.blue  / n.count) ;
+
+			_colors.push_back ((red << 16) | (green << 8) | blue) ;
+		}
+
+		return ;
+	}
+
+	for (int i = 0 ; i < 8 ; ++i)
+	{
+		if (n.children [i] != NO_NODE)
+			CollectColors (n.children [i]) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Finds the chosen color closest to a color.  The answer is computed
+// once for each 15 bits color and then kept in a table.
+//
+// Return value:  Index of the chosen color.
+//
+// Parameters:
+//
+// const int red   -> Red component.
+// const int green -> Green component.
+// const int blue  -> Blue component.
+//-----------------------------------------------------------------
+
+BYTE Win::Palette::Quantizer::FindNearest (const int red, const int green, const int blue)
+{
+	int key = ((red >> 3) << 10) | ((green >> 3) << 5) | (blue >> 3) ;
+
+	if (_nearest [key] < 0)
+	{
+		// Use the center of the 15 bits cell.
+		int  r        = (red   & 0xF8) | 4 ;
+		int  g        = (green & 0xF8) | 4 ;
+		int  b        = (blue  & 0xF8) | 4 ;
+		int  best     = 0 ;
+		long bestDist = 0x7FFFFFFF ;
+
+		for (size_t i = 0 ; i < _colors.size () ; ++i)
+		{
+			int  dr   = r - static_cast <int> ((_colors [i] >> 16) & 0xFF) ;
+			int  dg   = g - static_cast <int> ((_colors [i] >> 8)  & 0xFF) ;
+			int  db   = b - static_cast <int> ( _colors [i]        & 0xFF) ;
+			long dist = dr * dr + dg * dg + db * db ;
+
+			if (dist < bestDist)
+			{
+				bestDist = dist ;
+				best     = static_cast <int> (i) ;
+			}
+		}
+
+		_nearest [key] = static_cast <short> (best) ;
+	}
+
+	return static_cast <BYTE> (_nearest [key]) ;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Palette::Quantizer.
+//-----------------------------------------------------------------
+
+#if !defined (WINQUANTIZER_H)
+
+	#define WINQUANTIZER_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include "windrawingtool.h"
+	#include <vector>
+
+	namespace Win
+	{
+		namespace Palette
+		{
+			//-----------------------------------------------------------------
+			// Win::Palette::Quantizer chooses a small set of colors that
+			// represents an image well, using an octree, and converts images
+			// to that set of colors.  It is used to save 32 bits images as
+			// 8, 4 or 1 bit DIB sections.
+			//
+			// The pixels of the images are 32 bits values laid out like in a
+			// 32 bits DIB:  0x00RRGGBB.
+			//-----------------------------------------------------------------
+
+			class Quantizer
+			{
+			public:
+
+				Quantizer () ;
+
+				void Build (const DWORD * pixels, const int width, const int height, const int stride, const int maxColors = 256) ;
+				void Remap (const DWORD * pixels, const int width, const int height, const int stride, BYTE * indices, const bool dither = false) ;
+				void FillPalette (Win::Palette::Data & data) const ;
+				Win::Bitmap::DIBSection::StrongHandle CreateDIBSection (const DWORD * pixels, const int width, const int height, const int stride,
+																		const int bitCount = 8, const bool dither = false) ;
+
+				//-----------------------------------------------------------------
+				// Obtains the number of colors chosen by Build.
+				//-----------------------------------------------------------------
+
+				int GetColorCount () const
+				{
+					return static_cast <int> (_colors.size ()) ;
+				}
+
+				//-----------------------------------------------------------------
+				// Obtains one of the colors chosen by Build.
+				//
+				// Return value:  The color as 0x00RRGGBB.
+				//
+				// Parameters:
+				//
+				// const int index -> Index of the color.
+				//-----------------------------------------------------------------
+
+				DWORD GetColor (const int index) const
+				{
+					return _colors [index] ;
+				}
+
+			private:
+
+				//-----------------------------------------------------------------
+				// A node of the octree.  Each level splits the colors on one
+				// more bit of red, green and blue.
+				//-----------------------------------------------------------------
+
+				struct Node
+				{
+					ULONGLONG red ;
+					ULONGLONG green ;
+					ULONGLONG blue ;
+					DWORD     count ;        // Number of pixels in a leaf.
+					int       children [8] ;
+					int       next ;         // Next reducible node of the same level.
+					bool      leaf ;
+				} ;
+
+				enum { DEPTH = 8, NO_NODE = -1 } ;
+
+				int NewNode (const int level) ;
+				void AddColor (const DWORD color) ;
+				void Reduce () ;
+				void CollectColors (const int node) ;
+				BYTE FindNearest (const int red, const int green, const int blue) ;
+
+				std::vector <Node>  _nodes ;
+				int                 _reducible [DEPTH] ; // Lists of nodes that have children, by level.
+				int                 _leafCount ;
+				int                 _maxColors ;
+				std::vector <DWORD> _colors ;            // The chosen colors.
+				std::vector <short> _nearest ;           // Nearest color by 15 bits color, -1 if not computed.
+			} ;
+		}
+	}
+
+#endif
\ No newline at end of file
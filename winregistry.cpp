@@ -1,4 +1,5 @@
 #include "winregistry.h"
+#include "strongpointer.h"
 
 //-------------------------------------------------------------------------
 // Enumerates all subkeys of the current key
@@ -87,16 +88,281 @@ bool Win::RegistryKey::Handle::EnumValue (DWORD index, std::tstring & valuename,
 
 void Win::RegistryKey::Handle::GetInfo (DWORD * nbSubkey, DWORD * maxSubkeyLength, DWORD * maxClassLength, DWORD * nbValues, DWORD * maxValueNameLength, DWORD * maxValueLength, DWORD * securityDescLength, std::tstring * classname, DWORD classnameLength, FILETIME * time)
 {
+	TCHAR * classBuf = NULL ;
+
 	if (classname != NULL)
 	{
 		classname->reserve (classnameLength + 1);
 		classname->resize (classnameLength);
+		classBuf = &((*classname)[0]) ;
 	}
 
-	if (::RegQueryInfoKey (_h, &((*classname)[0]), &classnameLength, 0, nbSubkey, maxSubkeyLength, maxClassLength, nbValues, maxValueNameLength, maxValueLength, securityDescLength, time) != ERROR_SUCCESS)
+	if (::RegQueryInfoKey (_h, classBuf, classBuf != NULL ? &classnameLength : NULL, 0, nbSubkey, maxSubkeyLength, maxClassLength, nbValues, maxValueNameLength, maxValueLength, securityDescLength, time) != ERROR_SUCCESS)
 		throw Win::Exception (TEXT("Error, coud not get information about a key")) ;
 }
 
+//-------------------------------------------------------------------------
+// Reads a value of the key.  Small values are read in the buffer received
+// as a parameter, bigger values in a buffer allocated on the heap.
+//
+// Parameters:
+//
+// const std::tstring & valuename -> The name of the value.
+// DWORD & type                   -> Will contain the type of the value.
+// BYTE * smallBuf                -> Buffer of SmallValueSize bytes.
+// std::vector <BYTE> & bigBuf    -> Used if the value does not fit in smallBuf.
+// const BYTE * & data            -> Will point on the data.
+// DWORD & dataLength             -> Will contain the size of the data.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Handle::QueryValue (const std::tstring & valuename, DWORD & type, BYTE * smallBuf, std::vector <BYTE> & bigBuf, const BYTE * & data, DWORD & dataLength) const
+{
+	dataLength = SmallValueSize ;
+
+	LONG result = ::RegQueryValueEx (_h, valuename.c_str (), NULL, &type, smallBuf, &dataLength) ;
+	data = smallBuf ;
+
+	// The value changed size between the two calls, try again.
+	while (result == ERROR_MORE_DATA)
+	{
+		bigBuf.resize (dataLength) ;
+		result = ::RegQueryValueEx (_h, valuename.c_str (), NULL, &type, &bigBuf [0], &dataLength) ;
+		data = &bigBuf [0] ;
+	}
+
+	if (result != ERROR_SUCCESS)
+		throw Win::Exception (TEXT("Error, could not get a value")) ;
+}
+
+//-------------------------------------------------------------------------
+// The following methods all serve the same purpose.  They obtain a value of
+// the key converted to a C++ type.
+//
+// Parameters:
+//
+// const std::tstring & valuename -> The name of the value.
+// value                          -> Will contain the value.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, int & value) const
+{
+	DWORD dword ;
+
+	GetValue (valuename, dword) ;
+	value = static_cast <int> (dword) ;
+}
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, DWORD & value) const
+{
+	BYTE  data [sizeof (DWORD)] ;
+	DWORD type ;
+	DWORD dataLength = sizeof (data) ;
+
+	if (::RegQueryValueEx (_h, valuename.c_str (), NULL, &type, data, &dataLength) != ERROR_SUCCESS)
+		throw Win::Exception (TEXT("Error, could not get a value")) ;
+
+	Decode (type, data, dataLength, value) ;
+}
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, ULONGLONG & value) const
+{
+	BYTE  data [sizeof (ULONGLONG)] ;
+	DWORD type ;
+	DWORD dataLength = sizeof (data) ;
+
+	if (::RegQueryValueEx (_h, valuename.c_str (), NULL, &type, data, &dataLength) != ERROR_SUCCESS)
+		throw Win::Exception (TEXT("Error, could not get a value")) ;
+
+	Decode (type, data, dataLength, value) ;
+}
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, std::tstring & value) const
+{
+	BYTE               smallBuf [SmallValueSize] ;
+	std::vector <BYTE> bigBuf ;
+	const BYTE *       data ;
+	DWORD              type ;
+	DWORD              dataLength ;
+
+	QueryValue (valuename, type, smallBuf, bigBuf, data, dataLength) ;
+	Decode (type, data, dataLength, value) ;
+}
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, std::vector <std::tstring> & value) const
+{
+	BYTE               smallBuf [SmallValueSize] ;
+	std::vector <BYTE> bigBuf ;
+	const BYTE *       data ;
+	DWORD              type ;
+	DWORD              dataLength ;
+
+	QueryValue (valuename, type, smallBuf, bigBuf, data, dataLength) ;
+	Decode (type, data, dataLength, value) ;
+}
+
+void Win::RegistryKey::Handle::GetValue (const std::tstring & valuename, std::vector <BYTE> & value) const
+{
+	BYTE               smallBuf [SmallValueSize] ;
+	std::vector <BYTE> bigBuf ;
+	const BYTE *       data ;
+	DWORD              type ;
+	DWORD              dataLength ;
+
+	QueryValue (valuename, type, smallBuf, bigBuf, data, dataLength) ;
+	Decode (type, data, dataLength, value) ;
+}
+
+//-------------------------------------------------------------------------
+// Sets a REG_MULTI_SZ value of the key.
+//
+// Parameters:
+//
+// const std::tstring valuename             -> The name of the value.
+// const std::vector <std::tstring> & value -> The strings of the value.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Handle::SetValue (const std::tstring valuename, const std::vector <std::tstring> & value)
+{
+	std::vector <TCHAR> buf ;
+
+	for (std::vector <std::tstring>::const_iterator it = value.begin () ; it != value.end () ; ++it)
+	{
+		buf.insert (buf.end (), it->begin (), it->end ()) ;
+		buf.push_back (TEXT('\0')) ;
+	}
+
+	// The list ends with an empty string.
+	buf.push_back (TEXT('\0')) ;
+
+	SetValue (valuename, REG_MULTI_SZ, reinterpret_cast <const BYTE *> (&buf [0]), static_cast <DWORD> (buf.size () * sizeof (TCHAR))) ;
+}
+
+//-------------------------------------------------------------------------
+// The following functions all serve the same purpose.  They convert the 
+// data of a registry value to a C++ type.  An exception is thrown if the 
+// type of the value does not match.
+//
+// Parameters:
+//
+// const DWORD type       -> The type of the value.
+// const BYTE * data      -> The data of the value.
+// const DWORD dataLength -> The size of the data in bytes.
+// value                  -> Will contain the value.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, int & value)
+{
+	DWORD dword ;
+
+	Decode (type, data, dataLength, dword) ;
+	value = static_cast <int> (dword) ;
+}
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, DWORD & value)
+{
+	if (type != REG_DWORD || dataLength != sizeof (DWORD))
+		throw Win::Exception (TEXT("Error, the registry value is not a REG_DWORD")) ;
+
+	::CopyMemory (&value, data, sizeof (DWORD)) ;
+}
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, ULONGLONG & value)
+{
+	if (type != REG_QWORD || dataLength != sizeof (ULONGLONG))
+		throw Win::Exception (TEXT("Error, the registry value is not a REG_QWORD")) ;
+
+	::CopyMemory (&value, data, sizeof (ULONGLONG)) ;
+}
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::tstring & value)
+{
+	if (type != REG_SZ && type != REG_EXPAND_SZ)
+		throw Win::Exception (TEXT("Error, the registry value is not a string")) ;
+
+	const TCHAR * str = reinterpret_cast <const TCHAR *> (data) ;
+	size_t        len = dataLength / sizeof (TCHAR) ;
+
+	// The terminating null characters are not always stored.
+	while (len > 0 && str [len - 1] == TEXT('\0'))
+		--len ;
+
+	value.assign (str, len) ;
+}
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::vector <std::tstring> & value)
+{
+	if (type != REG_MULTI_SZ)
+		throw Win::Exception (TEXT("Error, the registry value is not a REG_MULTI_SZ")) ;
+
+	const TCHAR * str = reinterpret_cast <const TCHAR *> (data) ;
+	size_t        len = dataLength / sizeof (TCHAR) ;
+	size_t        start = 0 ;
+
+	value.clear () ;
+
+	for (size_t i = 0 ; i < len ; ++i)
+	{
+		if (str [i] == TEXT('\0'))
+		{
+			// An empty string ends the list.
+			if (i == start)
+				break ;
+
+			value.push_back (std::tstring (str + start, i - start)) ;
+			start = i + 1 ;
+		}
+	}
+
+	// The last string was not terminated.
+	if (start < len && str [len - 1] != TEXT('\0'))
+		value.push_back (std::tstring (str + start, len - start)) ;
+}
+
+void Win::RegistryKey::Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::vector <BYTE> & value)
+{
+	value.assign (data, data + dataLength) ;
+}
+
+//-------------------------------------------------------------------------
+// Reads all the values that were added with a single call.
+//
+// Parameters:
+//
+// Win::RegistryKey::Handle hKey -> The key containing the values.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::MultipleValues::Query (Win::RegistryKey::Handle hKey)
+{
+	if (_names.empty ())
+		return ;
+
+	_entries.resize (_names.size ()) ;
+
+	for (size_t i = 0 ; i < _names.size () ; ++i)
+	{
+		_entries [i].ve_valuename = const_cast <TCHAR *> (_names [i].c_str ()) ;
+		_entries [i].ve_valuelen  = 0 ;
+		_entries [i].ve_valueptr  = 0 ;
+		_entries [i].ve_type      = REG_NONE ;
+	}
+
+	if (_buffer.empty ())
+		_buffer.resize (1) ;
+
+	DWORD size   = static_cast <DWORD> (_buffer.size ()) ;
+	LONG  result = ::RegQueryMultipleValues (hKey, &_entries [0], static_cast <DWORD> (_entries.size ()), reinterpret_cast <TCHAR *> (&_buffer [0]), &size) ;
+
+	// The buffer was too small, size contains the required size.
+	while (result == ERROR_MORE_DATA)
+	{
+		_buffer.resize (size) ;
+		result = ::RegQueryMultipleValues (hKey, &_entries [0], static_cast <DWORD> (_entries.size ()), reinterpret_cast <TCHAR *> (&_buffer [0]), &size) ;
+	}
+
+	if (result != ERROR_SUCCESS)
+		throw Win::Exception (TEXT("Error, could not get multiple values")) ;
+}
+
 Win::RegistryKey::StrongHandle Win::RegistryKey::Creator::Create (Win::RegistryKey::Handle hKey, const std::tstring subkey, std::tstring classname, DWORD * disposition, DWORD options, REGSAM samDesired, bool inheritance)
 {
 	SECURITY_ATTRIBUTES sa ;
@@ -121,4 +387,463 @@ Win::RegistryKey::StrongHandle Win::RegistryKey::Opener::Open (Win::RegistryKey:
 		throw Win::Exception (TEXT("Error, could not create a registry key")) ;
 
 	return Win::RegistryKey::StrongHandle (h) ;
+}
+
+//-------------------------------------------------------------------------
+// Constructor.  Creates an empty snapshot.
+//-------------------------------------------------------------------------
+
+Win::RegistryKey::Snapshot::Snapshot ()
+	: _tree    (NULL),
+	  _readers (0),
+	  _event   (::CreateEvent (NULL, TRUE, FALSE, NULL))
+{
+	if (_event == NULL)
+		throw Win::Exception (TEXT("Error, could not create the event of a registry snapshot")) ;
+
+	try
+	{
+		_tree = new Tree ;
+	}
+	catch (...)
+	{
+		::CloseHandle (_event) ;
+		throw ;
+	}
+}
+
+//-------------------------------------------------------------------------
+// Destructor.  Stops watching the subtree.  No Reader may be left.
+//-------------------------------------------------------------------------
+
+Win::RegistryKey::Snapshot::~Snapshot ()
+{
+	if (!_root.IsNull ())
+		Win::RegistryKey::Disposal::Dispose (_root) ;
+
+	::CloseHandle (_event) ;
+
+	DeleteRetired () ;
+	delete _tree ;
+}
+
+//-------------------------------------------------------------------------
+// Reads a registry subtree and starts watching it for changes.  If the
+// subtree cannot be read, the previous root and snapshot are kept.
+//
+// Parameters:
+//
+// Win::RegistryKey::Handle hKey -> An open key.
+// const std::tstring subkey     -> The root of the subtree, relative to hKey.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::Load (Win::RegistryKey::Handle hKey, const std::tstring subkey)
+{
+	HKEY h ;
+
+	if (::RegOpenKeyEx (hKey, subkey.c_str (), 0, KEY_READ | KEY_NOTIFY, &h) != ERROR_SUCCESS)
+		throw Win::Exception (TEXT("Error, could not open the root of a registry snapshot")) ;
+
+	Win::RegistryKey::Handle old = _root ;
+	_root.Init (h) ;
+
+	try
+	{
+		// Make sure Refresh reads the new subtree.
+		::SetEvent (_event) ;
+		Refresh () ;
+	}
+	catch (...)
+	{
+		// Refresh kept the copy of the old subtree, so keep its root too.
+		Win::RegistryKey::Disposal::Dispose (_root) ;
+		_root.Init (old) ;
+		throw ;
+	}
+
+	if (!old.IsNull ())
+		Win::RegistryKey::Disposal::Dispose (old) ;
+}
+
+//-------------------------------------------------------------------------
+// Determines if the subtree changed since it was last read.
+//
+// Return value:  True if the snapshot is out of date, else false.
+//-------------------------------------------------------------------------
+
+bool Win::RegistryKey::Snapshot::IsStale () const
+{
+	return !_root.IsNull () && ::WaitForSingleObject (_event, 0) == WAIT_OBJECT_0 ;
+}
+
+//-------------------------------------------------------------------------
+// Reads the subtree again if it changed since it was last read.  The
+// subtree is read into a new copy, which replaces the current one only
+// once it is complete.  If the subtree cannot be read, the previous
+// snapshot is kept.
+//
+// Return value:  True if the subtree was read again, else false.
+//-------------------------------------------------------------------------
+
+bool Win::RegistryKey::Snapshot::Refresh ()
+{
+	// The copies replaced by the previous refreshes, if no Reader is left.
+	DeleteRetired () ;
+
+	if (!IsStale ())
+		return false ;
+
+	StrongPointer <Tree> tree (new Tree) ;
+
+	try
+	{
+		// Watch before reading so that changes made during the read are not missed.
+		::ResetEvent (_event) ;
+		Watch () ;
+
+		tree->Read (_root) ;
+	}
+	catch (...)
+	{
+		::SetEvent (_event) ;
+		throw ;
+	}
+
+	Publish (tree.Release ()) ;
+	return true ;
+}
+
+//-------------------------------------------------------------------------
+// Replaces the current copy of the subtree with one interlocked exchange.
+// A Reader created after the exchange keeps the new copy, so the old one
+// can be deleted as soon as no Reader is left.
+//
+// Parameters:
+//
+// Tree * tree -> The new copy.  The snapshot takes ownership.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::Publish (Tree * tree)
+{
+	// Make sure retiring the old copy cannot fail once it is replaced.
+	try
+	{
+		_retired.reserve (_retired.size () + 1) ;
+	}
+	catch (...)
+	{
+		delete tree ;
+		throw ;
+	}
+
+	Tree * old = static_cast <Tree *> (::InterlockedExchangePointer (reinterpret_cast <PVOID volatile *> (&_tree), tree)) ;
+
+	_retired.push_back (old) ;
+	DeleteRetired () ;
+}
+
+//-------------------------------------------------------------------------
+// Deletes the copies that were replaced, unless a Reader may still use
+// them.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::DeleteRetired ()
+{
+	if (_retired.empty () || ::InterlockedCompareExchange (&_readers, 0, 0) != 0)
+		return ;
+
+	for (std::vector <Tree *>::iterator it = _retired.begin () ; it != _retired.end () ; ++it)
+		delete *it ;
+
+	_retired.clear () ;
+}
+
+//-------------------------------------------------------------------------
+// Constructor.  Keeps the current copy of a snapshot.  Can be called from
+// any thread.
+//
+// Parameters:
+//
+// const Snapshot & snapshot -> The snapshot to read.
+//-------------------------------------------------------------------------
+
+Win::RegistryKey::Snapshot::Reader::Reader (const Snapshot & snapshot)
+	: _snapshot (snapshot)
+{
+	// Counted before the copy is read, so that the copy cannot be deleted
+	// once it is kept.  The copy is read with an interlocked operation so
+	// that its contents are seen complete.
+	::InterlockedIncrement (&snapshot._readers) ;
+
+	PVOID volatile * current = reinterpret_cast <PVOID volatile *> (const_cast <Tree **> (&snapshot._tree)) ;
+	_tree = static_cast <const Tree *> (::InterlockedCompareExchangePointer (current, NULL, NULL)) ;
+}
+
+//-------------------------------------------------------------------------
+// Destructor.  Releases the copy.
+//-------------------------------------------------------------------------
+
+Win::RegistryKey::Snapshot::Reader::~Reader ()
+{
+	::InterlockedDecrement (&_snapshot._readers) ;
+}
+
+//-------------------------------------------------------------------------
+// Reads a whole subtree into an empty copy.
+//
+// Parameters:
+//
+// Win::RegistryKey::Handle root -> The root of the subtree.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::Tree::Read (Win::RegistryKey::Handle root)
+{
+	Key key = {0, 0, 0, 0, 0, 0} ;
+	_keys.push_back (key) ;
+
+	ReadKey (root, 0) ;
+}
+
+//-------------------------------------------------------------------------
+// Finds a key of the snapshot from its path.
+//
+// Return value:  The key or NotFound.
+//
+// Parameters:
+//
+// const std::tstring & path -> Path of the key relative to the root of the
+//								subtree, like TEXT("Fonts\\Editor").  An empty
+//								path is the root.
+//-------------------------------------------------------------------------
+
+int Win::RegistryKey::Snapshot::Tree::FindKey (const std::tstring & path) const
+{
+	if (_keys.empty ())
+		return NotFound ;
+
+	int key = 0 ;
+	std::tstring::size_type start = 0 ;
+
+	while (key != NotFound && start < path.length ())
+	{
+		std::tstring::size_type end = path.find (TEXT('\\'), start) ;
+
+		if (end == std::tstring::npos)
+			end = path.length () ;
+
+		if (end > start)
+			key = FindSubKey (key, path.substr (start, end - start)) ;
+
+		start = end + 1 ;
+	}
+
+	return key ;
+}
+
+//-------------------------------------------------------------------------
+// Finds a subkey of a key from its name.  Names are not case sensitive.
+//
+// Return value:  The subkey or NotFound.
+//
+// Parameters:
+//
+// const int key              -> The key.
+// const std::tstring & name  -> The name of the subkey.
+//-------------------------------------------------------------------------
+
+int Win::RegistryKey::Snapshot::Tree::FindSubKey (const int key, const std::tstring & name) const
+{
+	const Key & parent = _keys [key] ;
+
+	for (DWORD i = parent.firstSubKey ; i < parent.firstSubKey + parent.nbSubKey ; ++i)
+	{
+		if (NameIs (_keys [i].name, _keys [i].nameLength, name.c_str (), static_cast <int> (name.length ())))
+			return static_cast <int> (i) ;
+	}
+
+	return NotFound ;
+}
+
+//-------------------------------------------------------------------------
+// Finds a value of a key.  The data is not copied, it stays valid as
+// long as the copy.
+//
+// Return value:  True if the value exists, else false.
+//
+// Parameters:
+//
+// const int key             -> The key.
+// const std::tstring & name -> The name of the value.  Empty for the
+//								default value of the key.
+// DWORD & type              -> Will contain the type of the value.
+// const BYTE * & data       -> Will point on the data of the value.
+// DWORD & dataLength        -> Will contain the size of the data in bytes.
+//-------------------------------------------------------------------------
+
+bool Win::RegistryKey::Snapshot::Tree::FindValue (const int key, const std::tstring & name, DWORD & type, const BYTE * & data, DWORD & dataLength) const
+{
+	const Key & parent = _keys [key] ;
+
+	for (DWORD i = parent.firstValue ; i < parent.firstValue + parent.nbValue ; ++i)
+	{
+		const Value & value = _values [i] ;
+
+		if (NameIs (value.name, value.nameLength, name.c_str (), static_cast <int> (name.length ())))
+		{
+			type       = value.type ;
+			data       = value.dataLength == 0 ? NULL : &_data [value.data] ;
+			dataLength = value.dataLength ;
+			return true ;
+		}
+	}
+
+	return false ;
+}
+
+//-------------------------------------------------------------------------
+// Reads the values and the subkeys of a key.  The size of the buffers is
+// obtained once per key with GetInfo.  The data of the values is read
+// directly at the end of the data array.
+//
+// Parameters:
+//
+// Win::RegistryKey::Handle hKey -> The open key.
+// const int key                 -> The key of the snapshot that is filled.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::Tree::ReadKey (Win::RegistryKey::Handle hKey, const int key)
+{
+	DWORD nbSubKey ;
+	DWORD maxSubKeyLength ;
+	DWORD nbValue ;
+	DWORD maxValueNameLength ;
+	DWORD maxValueLength ;
+
+	hKey.GetInfo (&nbSubKey, &maxSubKeyLength, NULL, &nbValue, &maxValueNameLength, &maxValueLength, NULL, NULL, 0) ;
+
+	std::vector <TCHAR> name ((maxSubKeyLength > maxValueNameLength ? maxSubKeyLength : maxValueNameLength) + 1) ;
+
+	// Values.
+	_keys [key].firstValue = static_cast <DWORD> (_values.size ()) ;
+
+	for (DWORD i = 0 ; i < nbValue ; ++i)
+	{
+		DWORD nameLength = static_cast <DWORD> (name.size ()) ;
+		DWORD dataLength = maxValueLength ;
+		DWORD offset     = static_cast <DWORD> (_data.size ()) ;
+		DWORD type ;
+
+		_data.resize (offset + maxValueLength) ;
+
+		LONG result = ::RegEnumValue (hKey, i, &name [0], &nameLength, NULL, &type, maxValueLength == 0 ? NULL : &_data [offset], &dataLength) ;
+
+		_data.resize (offset + (result == ERROR_SUCCESS ? dataLength : 0)) ;
+
+		// The key changed while it was read, the event is signaled so the 
+		// snapshot will be refreshed.
+		if (result == ERROR_NO_MORE_ITEMS)
+			break ;
+
+		if (result == ERROR_MORE_DATA)
+			continue ;
+
+		if (result != ERROR_SUCCESS)
+			throw Win::Exception (TEXT("Error, could not enumerate a value")) ;
+
+		Value value ;
+		value.name       = AddName (&name [0], nameLength) ;
+		value.nameLength = nameLength ;
+		value.type       = type ;
+		value.data       = offset ;
+		value.dataLength = dataLength ;
+
+		_values.push_back (value) ;
+	}
+
+	_keys [key].nbValue = static_cast <DWORD> (_values.size ()) - _keys [key].firstValue ;
+
+	// Subkeys are stored next to each other before being read.
+	DWORD first = static_cast <DWORD> (_keys.size ()) ;
+
+	for (DWORD i = 0 ; i < nbSubKey ; ++i)
+	{
+		DWORD nameLength = static_cast <DWORD> (name.size ()) ;
+
+		LONG result = ::RegEnumKeyEx (hKey, i, &name [0], &nameLength, NULL, NULL, NULL, NULL) ;
+
+		if (result == ERROR_NO_MORE_ITEMS)
+			break ;
+
+		if (result == ERROR_MORE_DATA)
+			continue ;
+
+		if (result != ERROR_SUCCESS)
+			throw Win::Exception (TEXT("Error, could not enumerate a subkey")) ;
+
+		Key subKey = {AddName (&name [0], nameLength), nameLength, 0, 0, 0, 0} ;
+		_keys.push_back (subKey) ;
+	}
+
+	DWORD last = static_cast <DWORD> (_keys.size ()) ;
+
+	_keys [key].firstSubKey = first ;
+	_keys [key].nbSubKey    = last - first ;
+
+	for (DWORD i = first ; i < last ; ++i)
+	{
+		HKEY h ;
+
+		// A subkey that cannot be opened stays empty.
+		if (::RegOpenKeyEx (hKey, GetKeyName (i).c_str (), 0, KEY_READ, &h) != ERROR_SUCCESS)
+			continue ;
+
+		Win::RegistryKey::StrongHandle subKey (h) ;
+		ReadKey (subKey, i) ;
+	}
+}
+
+//-------------------------------------------------------------------------
+// Asks the registry to signal the event when the subtree changes.
+//-------------------------------------------------------------------------
+
+void Win::RegistryKey::Snapshot::Watch ()
+{
+	_root.NotifyChangeKeyValue (REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET, true, true, _event) ;
+}
+
+//-------------------------------------------------------------------------
+// Stores a name in the snapshot.
+//
+// Return value:  The offset of the name.
+//
+// Parameters:
+//
+// const TCHAR * name  -> The name.
+// const DWORD length  -> Length of the name in characters.
+//-------------------------------------------------------------------------
+
+DWORD Win::RegistryKey::Snapshot::Tree::AddName (const TCHAR * name, const DWORD length)
+{
+	DWORD offset = static_cast <DWORD> (_names.size ()) ;
+
+	_names.insert (_names.end (), name, name + length) ;
+	return offset ;
+}
+
+//-------------------------------------------------------------------------
+// Compares one of the names stored in the snapshot with a string.  The
+// comparison is not case sensitive, like in the registry.
+//
+// Return value:  True if they are the same, else false.
+//-------------------------------------------------------------------------
+
+bool Win::RegistryKey::Snapshot::Tree::NameIs (const DWORD name, const DWORD length, const TCHAR * str, const int strLength) const
+{
+	if (static_cast <int> (length) != strLength)
+		return false ;
+
+	if (length == 0)
+		return true ;
+
+	return ::CompareString (LOCALE_SYSTEM_DEFAULT, NORM_IGNORECASE, &_names [name], length, str, strLength) == CSTR_EQUAL ;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 	#include "winunicodehelper.h"
 	#include "winhandle.h"
 	#include "winexception.h"
+	#include <vector>
 
 	namespace Win
 	{
@@ -132,8 +133,86 @@
 					if (::RegSetValueEx (_h, valuename.c_str (), 0, type, data, dataLength) != ERROR_SUCCESS)
 						throw Win::Exception (TEXT("Error, could not set a value")) ;
 				}
+
+				//-------------------------------------------------------------------------
+				// Obtains a value of the key already converted to a C++ type.  T can be
+				// int, DWORD (REG_DWORD), ULONGLONG (REG_QWORD), std::tstring (REG_SZ or
+				// REG_EXPAND_SZ), std::vector <std::tstring> (REG_MULTI_SZ) or 
+				// std::vector <BYTE> (any type).
+				//
+				// Return value:  The value.
+				//
+				// Parameters:
+				//
+				// const std::tstring & valuename -> The name of the value.
+				//-------------------------------------------------------------------------
+
+				template <class T>
+				T Get (const std::tstring & valuename) const
+				{
+					T value ;
+					GetValue (valuename, value) ;
+					return value ;
+				}
+
+				void GetValue (const std::tstring & valuename, int & value) const ;
+				void GetValue (const std::tstring & valuename, DWORD & value) const ;
+				void GetValue (const std::tstring & valuename, ULONGLONG & value) const ;
+				void GetValue (const std::tstring & valuename, std::tstring & value) const ;
+				void GetValue (const std::tstring & valuename, std::vector <std::tstring> & value) const ;
+				void GetValue (const std::tstring & valuename, std::vector <BYTE> & value) const ;
+
+				//-------------------------------------------------------------------------
+				// The following methods all serve the same purpose.  They set a value
+				// of the key from a C++ type.
+				//-------------------------------------------------------------------------
+
+				void SetValue (const std::tstring valuename, const int value) 
+				{
+					SetValue (valuename, static_cast <DWORD> (value)) ;
+				}
+
+				void SetValue (const std::tstring valuename, const DWORD value) 
+				{
+					SetValue (valuename, REG_DWORD, reinterpret_cast <const BYTE *> (&value), sizeof (value)) ;
+				}
+
+				void SetValue (const std::tstring valuename, const ULONGLONG value) 
+				{
+					SetValue (valuename, REG_QWORD, reinterpret_cast <const BYTE *> (&value), sizeof (value)) ;
+				}
+
+				void SetValue (const std::tstring valuename, const std::tstring & value) 
+				{
+					SetValue (valuename, REG_SZ, reinterpret_cast <const BYTE *> (value.c_str ()), static_cast <DWORD> ((value.length () + 1) * sizeof (TCHAR))) ;
+				}
+
+				void SetValue (const std::tstring valuename, const std::vector <BYTE> & value) 
+				{
+					SetValue (valuename, REG_BINARY, value.empty () ? NULL : &value [0], static_cast <DWORD> (value.size ())) ;
+				}
+
+				void SetValue (const std::tstring valuename, const std::vector <std::tstring> & value) ;
+
+			private:
+
+				//-------------------------------------------------------------------------
+				// Most values are small.  They are read in a buffer on the stack with
+				// a single call, the heap is used only for bigger values.
+				//-------------------------------------------------------------------------
+
+				enum { SmallValueSize = 256 } ;
+
+				void QueryValue (const std::tstring & valuename, DWORD & type, BYTE * smallBuf, std::vector <BYTE> & bigBuf, const BYTE * & data, DWORD & dataLength) const ;
 			} ;
 
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, int & value) ;
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, DWORD & value) ;
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, ULONGLONG & value) ;
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::tstring & value) ;
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::vector <std::tstring> & value) ;
+			void Decode (const DWORD type, const BYTE * data, const DWORD dataLength, std::vector <BYTE> & value) ;
+
 			typedef Sys::StrongHandle <Win::RegistryKey::Handle, Win::RegistryKey::Disposal> StrongHandle ;  // Strong handle owning the registry key.
 
 			//-------------------------------------------------------------------------
@@ -157,6 +236,423 @@
 
 				static Win::RegistryKey::StrongHandle Open (Win::RegistryKey::Handle hKey, const std::tstring subkey, REGSAM samDesired = KEY_ALL_ACCESS) ;
 			} ;
+
+			//-------------------------------------------------------------------------
+			// Win::RegistryKey::MultipleValues reads many values of a key with a single
+			// call to RegQueryMultipleValues.  Add the names of the values, call Query,
+			// then obtain each value by its index.  The buffer receiving the values is
+			// kept between calls to Query.
+			//-------------------------------------------------------------------------
+
+			class MultipleValues
+			{
+			public:
+
+				//-------------------------------------------------------------------------
+				// Constructor.
+				//
+				// Parameters:
+				//
+				// const DWORD bufferSize -> Initial size in bytes of the buffer
+				//							 receiving the values.  It grows if needed.
+				//-------------------------------------------------------------------------
+
+				MultipleValues (const DWORD bufferSize = 1024)
+					: _buffer (bufferSize)
+				{}
+
+				//-------------------------------------------------------------------------
+				// Adds a value to read.
+				//
+				// Return value:  The index of the value.
+				//
+				// Parameters:
+				//
+				// const std::tstring & valuename -> The name of the value.
+				//-------------------------------------------------------------------------
+
+				int Add (const std::tstring & valuename)
+				{
+					_names.push_back (valuename) ;
+					return static_cast <int> (_names.size ()) - 1 ;
+				}
+
+				void Query (Win::RegistryKey::Handle hKey) ;
+
+				//-------------------------------------------------------------------------
+				// Obtains the type of a value read by Query.
+				//
+				// Return value:  The type of the value (REG_SZ, REG_DWORD, etc.)
+				//
+				// Parameters:
+				//
+				// const int index -> The index of the value.
+				//-------------------------------------------------------------------------
+
+				DWORD GetType (const int index) const
+				{
+					return _entries [index].ve_type ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains a value read by Query already converted to a C++ type.  See
+				// Win::RegistryKey::Handle::Get for the possible types.
+				//
+				// Return value:  The value.
+				//
+				// Parameters:
+				//
+				// const int index -> The index of the value.
+				//-------------------------------------------------------------------------
+
+				template <class T>
+				T Get (const int index) const
+				{
+					T value ;
+					Decode (_entries [index].ve_type, reinterpret_cast <const BYTE *> (_entries [index].ve_valueptr), _entries [index].ve_valuelen, value) ;
+					return value ;
+				}
+
+			private:
+
+				std::vector <std::tstring> _names ;   // Names of the values.
+				std::vector <VALENT>       _entries ; // Describes each value.
+				std::vector <BYTE>         _buffer ;  // Receives the data of the values.
+			} ;
+
+			//-------------------------------------------------------------------------
+			// Win::RegistryKey::Snapshot reads a whole registry subtree in one pass and
+			// keeps a copy of it in memory.  The names and the data are stored in a
+			// few contiguous arrays, so reading a value from the snapshot does not
+			// call the registry at all.  The snapshot asks to be notified when the
+			// subtree changes, and Refresh reads it again only if it did.
+			//
+			// Keys are identified by a number.  The root of the subtree is key 0.
+			//
+			// Load and Refresh must be called by one thread, the owner of the
+			// snapshot, which may also read with the methods of the snapshot.  A
+			// refresh reads the subtree into a new copy and publishes it with one
+			// interlocked pointer exchange.  A copy is never modified once it is
+			// published.  Other threads read through a Snapshot::Reader, which keeps
+			// the copy that was current when it was created, without any lock.
+			//-------------------------------------------------------------------------
+
+			class Snapshot
+			{
+				class Tree ;
+
+			public:
+
+				enum { NotFound = -1 } ;
+
+				//-------------------------------------------------------------------------
+				// Win::RegistryKey::Snapshot::Reader reads a snapshot from any thread.  The
+				// keys and the data it returns stay valid as long as the Reader exists,
+				// even if the snapshot is refreshed meanwhile.  The old copies are only
+				// deleted when no Reader is left, so a Reader should not be kept long.
+				//-------------------------------------------------------------------------
+
+				class Reader
+				{
+				public:
+
+					Reader (const Snapshot & snapshot) ;
+					~Reader () ;
+
+					int FindKey (const std::tstring & path) const
+					{
+						return _tree->FindKey (path) ;
+					}
+
+					int FindSubKey (const int key, const std::tstring & name) const
+					{
+						return _tree->FindSubKey (key, name) ;
+					}
+
+					bool FindValue (const int key, const std::tstring & name, DWORD & type, const BYTE * & data, DWORD & dataLength) const
+					{
+						return _tree->FindValue (key, name, type, data, dataLength) ;
+					}
+
+					std::tstring GetKeyName (const int key) const
+					{
+						return _tree->GetKeyName (key) ;
+					}
+
+					int GetSubKeyCount (const int key) const
+					{
+						return _tree->GetSubKeyCount (key) ;
+					}
+
+					int GetSubKey (const int key, const int index) const
+					{
+						return _tree->GetSubKey (key, index) ;
+					}
+
+					int GetValueCount (const int key) const
+					{
+						return _tree->GetValueCount (key) ;
+					}
+
+					std::tstring GetValueName (const int key, const int index) const
+					{
+						return _tree->GetValueName (key, index) ;
+					}
+
+				private:
+
+					Reader (const Reader &) ;
+					Reader & operator = (const Reader &) ;
+
+					const Snapshot & _snapshot ; // The snapshot being read.
+					const Tree *     _tree ;     // The copy kept by the Reader.
+				} ;
+
+				friend class Reader ;
+
+				Snapshot () ;
+				~Snapshot () ;
+
+				void Load (Win::RegistryKey::Handle hKey, const std::tstring subkey) ;
+				bool IsStale () const ;
+				bool Refresh () ;
+
+				//-------------------------------------------------------------------------
+				// Finds a key of the snapshot from its path.
+				//
+				// Return value:  The key or NotFound.
+				//
+				// Parameters:
+				//
+				// const std::tstring & path -> Path of the key relative to the root of the
+				//								subtree, like TEXT("Fonts\\Editor").  An empty
+				//								path is the root.
+				//-------------------------------------------------------------------------
+
+				int FindKey (const std::tstring & path) const
+				{
+					return _tree->FindKey (path) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Finds a subkey of a key from its name.  Names are not case sensitive.
+				//
+				// Return value:  The subkey or NotFound.
+				//
+				// Parameters:
+				//
+				// const int key              -> The key.
+				// const std::tstring & name  -> The name of the subkey.
+				//-------------------------------------------------------------------------
+
+				int FindSubKey (const int key, const std::tstring & name) const
+				{
+					return _tree->FindSubKey (key, name) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Finds a value of a key.  The data is not copied, it stays valid until
+				// the snapshot is refreshed or destroyed.
+				//
+				// Return value:  True if the value exists, else false.
+				//
+				// Parameters:
+				//
+				// const int key             -> The key.
+				// const std::tstring & name -> The name of the value.  Empty for the
+				//								default value of the key.
+				// DWORD & type              -> Will contain the type of the value.
+				// const BYTE * & data       -> Will point on the data of the value.
+				// DWORD & dataLength        -> Will contain the size of the data in bytes.
+				//-------------------------------------------------------------------------
+
+				bool FindValue (const int key, const std::tstring & name, DWORD & type, const BYTE * & data, DWORD & dataLength) const
+				{
+					return _tree->FindValue (key, name, type, data, dataLength) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains the name of a key.
+				//
+				// Return value:  The name of the key.
+				//
+				// Parameters:
+				//
+				// const int key -> The key.
+				//-------------------------------------------------------------------------
+
+				std::tstring GetKeyName (const int key) const
+				{
+					return _tree->GetKeyName (key) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains the number of subkeys of a key.
+				//
+				// Return value:  The number of subkeys.
+				//
+				// Parameters:
+				//
+				// const int key -> The key.
+				//-------------------------------------------------------------------------
+
+				int GetSubKeyCount (const int key) const
+				{
+					return _tree->GetSubKeyCount (key) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains one of the subkeys of a key.
+				//
+				// Return value:  The subkey.
+				//
+				// Parameters:
+				//
+				// const int key   -> The key.
+				// const int index -> Index of the subkey, from 0 to GetSubKeyCount - 1.
+				//-------------------------------------------------------------------------
+
+				int GetSubKey (const int key, const int index) const
+				{
+					return _tree->GetSubKey (key, index) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains the number of values of a key.
+				//
+				// Return value:  The number of values.
+				//
+				// Parameters:
+				//
+				// const int key -> The key.
+				//-------------------------------------------------------------------------
+
+				int GetValueCount (const int key) const
+				{
+					return _tree->GetValueCount (key) ;
+				}
+
+				//-------------------------------------------------------------------------
+				// Obtains the name of one of the values of a key.
+				//
+				// Return value:  The name of the value.
+				//
+				// Parameters:
+				//
+				// const int key   -> The key.
+				// const int index -> Index of the value, from 0 to GetValueCount - 1.
+				//-------------------------------------------------------------------------
+
+				std::tstring GetValueName (const int key, const int index) const
+				{
+					return _tree->GetValueName (key, index) ;
+				}
+
+			private:
+
+				Snapshot (const Snapshot &) ;
+				Snapshot & operator = (const Snapshot &) ;
+
+				//-------------------------------------------------------------------------
+				// One copy of the subtree.  It is filled by Read before being published,
+				// then only read.
+				//-------------------------------------------------------------------------
+
+				class Tree
+				{
+				public:
+
+					void Read (Win::RegistryKey::Handle root) ;
+
+					int FindKey (const std::tstring & path) const ;
+					int FindSubKey (const int key, const std::tstring & name) const ;
+					bool FindValue (const int key, const std::tstring & name, DWORD & type, const BYTE * & data, DWORD & dataLength) const ;
+
+					std::tstring GetKeyName (const int key) const
+					{
+						return GetName (_keys [key].name, _keys [key].nameLength) ;
+					}
+
+					int GetSubKeyCount (const int key) const
+					{
+						return _keys [key].nbSubKey ;
+					}
+
+					int GetSubKey (const int key, const int index) const
+					{
+						return _keys [key].firstSubKey + index ;
+					}
+
+					int GetValueCount (const int key) const
+					{
+						return _keys [key].nbValue ;
+					}
+
+					std::tstring GetValueName (const int key, const int index) const
+					{
+						const Value & value = _values [_keys [key].firstValue + index] ;
+						return GetName (value.name, value.nameLength) ;
+					}
+
+				private:
+
+					//---------------------------------------------------------------------
+					// A key of the snapshot.  The subkeys of a key and its values are
+					// stored next to each other.
+					//---------------------------------------------------------------------
+
+					struct Key
+					{
+						DWORD name ;        // Offset of the name in _names.
+						DWORD nameLength ;  // Length of the name in characters.
+						DWORD firstSubKey ; // Index of the first subkey in _keys.
+						DWORD nbSubKey ;    // Number of subkeys.
+						DWORD firstValue ;  // Index of the first value in _values.
+						DWORD nbValue ;     // Number of values.
+					} ;
+
+					//---------------------------------------------------------------------
+					// A value of the snapshot.
+					//---------------------------------------------------------------------
+
+					struct Value
+					{
+						DWORD name ;       // Offset of the name in _names.
+						DWORD nameLength ; // Length of the name in characters.
+						DWORD type ;       // Type of the value (REG_SZ, REG_DWORD, etc).
+						DWORD data ;       // Offset of the data in _data.
+						DWORD dataLength ; // Size of the data in bytes.
+					} ;
+
+					void ReadKey (Win::RegistryKey::Handle hKey, const int key) ;
+					DWORD AddName (const TCHAR * name, const DWORD length) ;
+					bool NameIs (const DWORD name, const DWORD length, const TCHAR * str, const int strLength) const ;
+
+					//---------------------------------------------------------------------
+					// Obtains one of the names stored in the snapshot.
+					//---------------------------------------------------------------------
+
+					std::tstring GetName (const DWORD name, const DWORD length) const
+					{
+						return length == 0 ? std::tstring () : std::tstring (&_names [name], length) ;
+					}
+
+					std::vector <Key>   _keys ;   // All the keys, the root first.
+					std::vector <Value> _values ; // All the values.
+					std::vector <TCHAR> _names ;  // The names of the keys and of the values.
+					std::vector <BYTE>  _data ;   // The data of the values.
+				} ;
+
+				void Watch () ;
+				void Publish (Tree * tree) ;
+				void DeleteRetired () ;
+
+				Tree * volatile          _tree ;    // The current copy, replaced as a whole.
+				std::vector <Tree *>     _retired ; // Old copies that a Reader may still use.
+				mutable volatile LONG    _readers ; // Number of Reader objects.
+				Win::RegistryKey::Handle _root ;    // Root of the subtree, owned by the snapshot.
+				HANDLE                   _event ;   // Signaled when the subtree changes.
+			} ;
 		}
 	}
 
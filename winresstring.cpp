@@ -1,5 +1,6 @@
 #include "winresstring.h"
 #include "winexception.h"
+#include <algorithm>
 
 //------------------------------------------------------------
 // Constructor.  Load a resource string.
@@ -18,4 +19,181 @@ Win::ResString::ResString (const HINSTANCE hInstance, const int id )
 
 	if (!::LoadString (hInstance, id, &_resStr[0], MAX_RESSTRING))
 		throw Win::Exception (TEXT("Could not load a string")) ; // Could not load.
+}
+
+//------------------------------------------------------------
+// Constructor.  Loads all the resource strings of a module.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> Instance of the module.
+//------------------------------------------------------------
+
+Win::StringTable::StringTable (const HINSTANCE hInstance)
+{
+	Load (hInstance) ;
+}
+
+//------------------------------------------------------------
+// Loads all the resource strings of a module.  The strings
+// already in the table are kept unless they have the same id.
+//
+// Parameters:
+//
+// const HINSTANCE hInstance -> Instance of the module.
+//------------------------------------------------------------
+
+void Win::StringTable::Load (const HINSTANCE hInstance)
+{
+	std::vector <int> blockIds ;
+
+	// Don't throw from the callback:  only collect the ids of the blocks.
+	if (!::EnumResourceNames (hInstance, RT_STRING, EnumProc, reinterpret_cast <LONG_PTR> (&blockIds)) &&
+		::GetLastError () != ERROR_RESOURCE_TYPE_NOT_FOUND)
+	{
+		throw Win::Exception (TEXT("Could not enumerate the string resources")) ;
+	}
+
+	for (size_t i = 0 ; i < blockIds.size () ; ++i)
+	{
+		HRSRC   hInfo = ::FindResource (hInstance, MAKEINTRESOURCE (blockIds [i]), RT_STRING) ;
+		HGLOBAL hRes  = ::LoadResource (hInstance, hInfo) ;
+
+		if (hRes == NULL)
+			throw Win::Exception (TEXT("Could not load a string block")) ;
+
+		// Resources loaded from a module don't need to be freed.
+		AddBlock (blockIds [i], ::LockResource (hRes), ::SizeofResource (hInstance, hInfo)) ;
+	}
+}
+
+//------------------------------------------------------------
+// Adds the strings of a RT_STRING block.  A block holds 16 
+// strings, each one preceded by its length in a WORD and not 
+// null terminated.  Block n holds the strings with id 
+// (n - 1) * 16 to (n - 1) * 16 + 15.  Throws a
+// Win::ResourceTruncatedException if the block is invalid.
+//
+// Parameters:
+//
+// const int blockId  -> Id of the block, as found in the resources.
+// const void * data  -> The data of the block.
+// const DWORD size   -> The size of the data in bytes.
+//------------------------------------------------------------
+
+void Win::StringTable::AddBlock (const int blockId, const void * data, const DWORD size)
+{
+	if (blockId < 1 || blockId > 0x10000 / STRINGS_PER_BLOCK)
+		throw Win::Exception (TEXT("Error, invalid string block id")) ;
+
+	// Parse the whole block before changing the table.
+	Win::ResourceReader reader (data, size) ;
+	Entry               entries [STRINGS_PER_BLOCK] ;
+	const WCHAR *       strs    [STRINGS_PER_BLOCK] ;
+	size_t              total = 0 ;
+
+	for (int i = 0 ; i < STRINGS_PER_BLOCK ; ++i)
+	{
+		WORD length = reader.Read <WORD> () ;
+
+		strs [i] = reader.View <WCHAR> (length) ;
+		entries [i].length = length ;
+		total += length + 1 ;
+	}
+
+	_chars.reserve (_chars.size () + total) ;
+
+	for (int i = 0 ; i < STRINGS_PER_BLOCK ; ++i)
+	{
+		// Empty strings are the ids that are not used.
+		if (entries [i].length == 0)
+		{
+			entries [i].offset = NO_STRING ;
+			continue ;
+		}
+
+		entries [i].offset = static_cast <int> (_chars.size ()) ;
+
+	#if defined (UNICODE)
+		_chars.insert (_chars.end (), strs [i], strs [i] + entries [i].length) ;
+	#else
+		int length = ::WideCharToMultiByte (CP_ACP, 0, strs [i], entries [i].length, NULL, 0, NULL, NULL) ;
+
+		_chars.resize (entries [i].offset + length) ;
+		::WideCharToMultiByte (CP_ACP, 0, strs [i], entries [i].length, &_chars [entries [i].offset], length, NULL, NULL) ;
+		entries [i].length = length ;
+	#endif
+
+		_chars.push_back (TEXT('\0')) ;
+	}
+
+	if (static_cast <int> (_blocks.size ()) <= blockId)
+		_blocks.resize (blockId + 1, NO_BLOCK) ;
+
+	if (_blocks [blockId] == NO_BLOCK)
+	{
+		_blocks [blockId] = static_cast <int> (_entries.size ()) ;
+		_entries.insert (_entries.end (), entries, entries + STRINGS_PER_BLOCK) ;
+	}
+	else
+		std::copy (entries, entries + STRINGS_PER_BLOCK, _entries.begin () + _blocks [blockId]) ;
+}
+
+//------------------------------------------------------------
+// Finds a string.
+//
+// Return value:  A pointer on the null terminated string, or
+//				  NULL if there is no string with this id.  The
+//				  pointer stays valid until the table is changed.
+//
+// Parameters:
+//
+// const int id -> Id of the resource string.
+// int & length -> Will contain the length of the string.
+//------------------------------------------------------------
+
+const TCHAR * Win::StringTable::Find (const int id, int & length) const
+{
+	length = 0 ;
+
+	if (id < 0)
+		return NULL ;
+
+	size_t blockId = id / STRINGS_PER_BLOCK + 1 ;
+
+	if (blockId >= _blocks.size () || _blocks [blockId] == NO_BLOCK)
+		return NULL ;
+
+	const Entry & entry = _entries [_blocks [blockId] + id % STRINGS_PER_BLOCK] ;
+
+	if (entry.offset == NO_STRING)
+		return NULL ;
+
+	length = entry.length ;
+	return &_chars [entry.offset] ;
+}
+
+//------------------------------------------------------------
+// Called by EnumResourceNames for each RT_STRING block.
+//
+// Return value:  TRUE to continue the enumeration.
+//
+// Parameters:
+//
+// HMODULE hModule -> The module containing the resources.
+// LPCTSTR type    -> RT_STRING.
+// LPTSTR name     -> The id of the block.
+// LONG_PTR param  -> A std::vector <int> receiving the block ids.
+//------------------------------------------------------------
+
+BOOL CALLBACK Win::StringTable::EnumProc (HMODULE hModule, LPCTSTR type, LPTSTR name, LONG_PTR param)
+{
+	// String blocks always have a numerical id.
+	if (IS_INTRESOURCE (name))
+	{
+		reinterpret_cast <std::vector <int> *> (param)->push_back (
+			static_cast <int> (reinterpret_cast <ULONG_PTR> (name))) ;
+	}
+
+	return TRUE ;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 //------------------------------------------------------------
-// This file contains one class:  Win::ResString.
+// This file contains classes to load resource strings.
 //------------------------------------------------------------
 
 #if !defined (WINRESSTRING_H)
@@ -8,6 +8,8 @@
 	#include "useunicode.h"
 	#include <windows.h>
 	#include "winunicodehelper.h"
+	#include "wincustomres.h"
+	#include <vector>
 
 	namespace Win
 	{
@@ -46,6 +48,104 @@
 
 			std::tstring _resStr ; // Contains the resource string.
 		} ;
+
+		//------------------------------------------------------------
+		// Win::StringTable loads all the resource strings of a module 
+		// at once and keeps them in a single buffer.  A string is then
+		// found in constant time, without copying it and without any
+		// limit on its length.  Use it instead of Win::ResString when
+		// many strings are needed.
+		//------------------------------------------------------------
+
+		class StringTable
+		{
+		public:
+
+			//------------------------------------------------------------
+			// Constructor.  Creates an empty table.
+			//------------------------------------------------------------
+
+			StringTable ()
+			{}
+
+			StringTable (const HINSTANCE hInstance) ;
+
+			void Load (const HINSTANCE hInstance) ;
+			void AddBlock (const int blockId, const void * data, const DWORD size) ;
+			const TCHAR * Find (const int id, int & length) const ;
+
+			//------------------------------------------------------------
+			// Finds a string.
+			//
+			// Return value:  A pointer on the null terminated string, or
+			//				  NULL if there is no string with this id.  The
+			//				  pointer stays valid until the table is changed.
+			//
+			// Parameters:
+			//
+			// const int id -> Id of the resource string.
+			//------------------------------------------------------------
+
+			const TCHAR * Find (const int id) const
+			{
+				int length ;
+				return Find (id, length) ;
+			}
+
+			//------------------------------------------------------------
+			// Obtains a copy of a string.  Throws an exception if there
+			// is no string with this id.
+			//
+			// Return value:  The string.
+			//
+			// Parameters:
+			//
+			// const int id -> Id of the resource string.
+			//------------------------------------------------------------
+
+			std::tstring Get (const int id) const
+			{
+				int           length ;
+				const TCHAR * str = Find (id, length) ;
+
+				if (str == NULL)
+					throw Win::Exception (TEXT("Could not find a string")) ;
+
+				return std::tstring (str, length) ;
+			}
+
+			//------------------------------------------------------------
+			// Removes all the strings.
+			//------------------------------------------------------------
+
+			void Clear ()
+			{
+				_blocks.clear () ;
+				_entries.clear () ;
+				_chars.clear () ;
+			}
+
+		private:
+
+			enum { STRINGS_PER_BLOCK = 16, NO_BLOCK = -1, NO_STRING = -1 } ;
+
+			//------------------------------------------------------------
+			// Position of a string in the buffer.  The offset is 
+			// NO_STRING if the string does not exist.
+			//------------------------------------------------------------
+
+			struct Entry
+			{
+				int offset ;
+				int length ;
+			} ;
+
+			static BOOL CALLBACK EnumProc (HMODULE hModule, LPCTSTR type, LPTSTR name, LONG_PTR param) ;
+
+			std::vector <int>   _blocks ;  // For each block id, index of its first entry or NO_BLOCK.
+			std::vector <Entry> _entries ; // STRINGS_PER_BLOCK entries for each loaded block.
+			std::vector <TCHAR> _chars ;   // All the strings, null terminated.
+		} ;
 	}
 
 #endif
\ No newline at end of file
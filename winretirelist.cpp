@@ -0,0 +1,123 @@
+#include "winretirelist.h"
+
+namespace
+{
+	// Retire list of the current thread.
+	__declspec (thread) Sys::RetireList * s_current = NULL ;
+}
+
+//-----------------------------------------------------------------
+// Constructor.  Makes the list the retire list of the calling
+// thread.  The previous one is restored by the destructor.
+//
+// Parameters:
+//
+// const int batchSize -> Number of handles destroyed by OnIdle.
+//-----------------------------------------------------------------
+
+Sys::RetireList::RetireList (const int batchSize)
+	: _previous (s_current),
+	  _head (0),
+	  _batchSize (batchSize)
+{
+	s_current = this ;
+}
+
+//-----------------------------------------------------------------
+// Destructor.  Destroys the handles left.
+//-----------------------------------------------------------------
+
+Sys::RetireList::~RetireList ()
+{
+	if (s_current == this)
+		s_current = _previous ;
+
+	DrainAll () ;
+}
+
+//-----------------------------------------------------------------
+// Obtains the retire list of the calling thread.
+//
+// Return value:  The list or NULL if the thread does not have one.
+//-----------------------------------------------------------------
+
+Sys::RetireList * Sys::RetireList::GetCurrent ()
+{
+	return s_current ;
+}
+
+//-----------------------------------------------------------------
+// Adds a handle to the list.  If the list can not grow, the handle
+// is destroyed at once:  this is called from destructors, which
+// must not throw.
+//
+// Parameters:
+//
+// Disposer dispose -> Function destroying the handle.
+// void * handle    -> The handle.
+//-----------------------------------------------------------------
+
+void Sys::RetireList::Retire (Disposer dispose, void * handle)
+{
+	Entry entry ;
+	entry.dispose = dispose ;
+	entry.handle  = handle ;
+
+	try
+	{
+		_entries.push_back (entry) ;
+	}
+	catch (...)
+	{
+		dispose (handle) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Destroys the oldest handles of the list.
+//
+// Return value:  The number of handles destroyed.
+//
+// Parameters:
+//
+// const int maxCount -> Maximum number of handles to destroy.
+//-----------------------------------------------------------------
+
+int Sys::RetireList::Drain (const int maxCount)
+{
+	int count = 0 ;
+
+	while (count < maxCount && _head < _entries.size ())
+	{
+		// The entry is consumed before the call in case the disposer
+		// retires other handles.
+		Entry entry = _entries [_head++] ;
+		entry.dispose (entry.handle) ;
+		++count ;
+	}
+
+	// Keeps the memory for the next handles.
+	if (_head == _entries.size ())
+	{
+		_entries.clear () ;
+		_head = 0 ;
+	}
+
+	return count ;
+}
+
+//-----------------------------------------------------------------
+// Destroys all the handles of the list.
+//
+// Return value:  The number of handles destroyed.
+//-----------------------------------------------------------------
+
+int Sys::RetireList::DrainAll ()
+{
+	int count = 0 ;
+
+	while (GetPending () != 0)
+		count += Drain (GetPending ()) ;
+
+	return count ;
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------
+//  This file contains two classes:  Sys::RetireList and
+//  Sys::DeferredDisposal.
+//-----------------------------------------------------------------
+
+#if !defined (WINRETIRELIST_H)
+
+	#define WINRETIRELIST_H
+	#include "useunicode.h"
+	#include "winmessagepump.h"
+	#include <windows.h>
+	#include <vector>
+
+	namespace Sys
+	{
+		//-----------------------------------------------------------------
+		// A Sys::RetireList object holds the handles whose destruction was
+		// deferred by Sys::DeferredDisposal.  Create one on the stack of a
+		// UI thread, around its message loop:  while it exists, it is the
+		// retire list of the thread.  The handles are destroyed in the
+		// order they were retired, a batch at a time, when the list is
+		// added to the idle handlers of the message pump, or when Drain is
+		// called at a frame boundary.  The handles left are destroyed by
+		// the destructor.
+		//-----------------------------------------------------------------
+
+		class RetireList : public Win::IdleHandler
+		{
+		public:
+
+			typedef void (* Disposer) (void * handle) ;
+
+			RetireList (const int batchSize = 64) ;
+			~RetireList () ;
+
+			static RetireList * GetCurrent () ;
+
+			void Retire (Disposer dispose, void * handle) ;
+			int Drain (const int maxCount) ;
+			int DrainAll () ;
+
+			//-----------------------------------------------------------------
+			// Destroys a batch of handles.  Called by the message pump when
+			// the message queue is empty.
+			//
+			// Return value:  True if handles remain, else false.
+			//-----------------------------------------------------------------
+
+			virtual bool OnIdle ()
+			{
+				Drain (_batchSize) ;
+				return GetPending () != 0 ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the number of handles waiting to be destroyed.
+			//
+			// Return value:  The number of handles.
+			//-----------------------------------------------------------------
+
+			int GetPending () const
+			{
+				return static_cast <int> (_entries.size () - _head) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Changes the number of handles destroyed by OnIdle.
+			//
+			// Parameters:
+			//
+			// const int batchSize -> The number of handles.
+			//-----------------------------------------------------------------
+
+			void SetBatchSize (const int batchSize)
+			{
+				_batchSize = batchSize ;
+			}
+
+		private:
+
+			struct Entry
+			{
+				Disposer dispose ;
+				void *   handle ;
+			} ;
+
+			RetireList *        _previous ;  // List that was current before this one.
+			std::vector <Entry> _entries ;   // Handles retired, oldest first.
+			size_t              _head ;      // First entry not yet destroyed.
+			int                 _batchSize ; // Handles destroyed by OnIdle.
+
+			RetireList (const RetireList &) ;
+			RetireList & operator = (const RetireList &) ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// Counters kept for each type of handle disposed through
+		// Sys::DeferredDisposal.  The handles retired but not yet
+		// destroyed are retired - drained.
+		//-----------------------------------------------------------------
+
+		struct DisposalCounters
+		{
+			volatile LONG retired ;   // Handles put in a retire list.
+			volatile LONG drained ;   // Retired handles destroyed.
+			volatile LONG immediate ; // Handles destroyed at once, without a retire list.
+		} ;
+
+		//-----------------------------------------------------------------
+		// Sys::DeferredDisposal is a disposal policy for Sys::StrongHandle
+		// that puts the handle in the retire list of the thread instead of
+		// destroying it.  The handle is destroyed later by Policy.  If the
+		// thread has no retire list, the handle is destroyed at once.
+		// For example:
+		//
+		// typedef Sys::StrongHandle <Win::Icon::Handle,
+		//		Sys::DeferredDisposal <Win::Icon::Disposal> > DeferredIcon ;
+		//-----------------------------------------------------------------
+
+		template <class Policy>
+		struct DeferredDisposal
+		{
+			//-----------------------------------------------------------------
+			// Retires a handle, or destroys it if the thread has no retire
+			// list.
+			//
+			// Parameters:
+			//
+			// NormalHandle h -> The handle.
+			//-----------------------------------------------------------------
+
+			template <class NormalHandle>
+			static void Dispose (NormalHandle h)
+			{
+				RetireList * list = RetireList::GetCurrent () ;
+
+				if (list == NULL)
+				{
+					Policy::Dispose (h) ;
+					::InterlockedIncrement (&_counters.immediate) ;
+					return ;
+				}
+
+				::InterlockedIncrement (&_counters.retired) ;
+				list->Retire (&DisposeRetired <NormalHandle>, reinterpret_cast <void *> (h)) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the counters of the handles disposed with Policy.
+			//
+			// Return value:  The counters.
+			//-----------------------------------------------------------------
+
+			static const DisposalCounters & GetCounters ()
+			{
+				return _counters ;
+			}
+
+		private:
+
+			template <class NormalHandle>
+			static void DisposeRetired (void * h)
+			{
+				Policy::Dispose (reinterpret_cast <NormalHandle> (h)) ;
+				::InterlockedIncrement (&_counters.drained) ;
+			}
+
+			static DisposalCounters _counters ;
+		} ;
+
+		template <class Policy>
+		DisposalCounters DeferredDisposal <Policy>::_counters = {0, 0, 0} ;
+	}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "winstringindex.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// Fills the index with all the strings of a control at once.  Much
+// faster than calling Add for each string.
+//
+// Parameters:
+//
+// const std::vector <std::tstring> & strs -> The strings of the
+//											 control, in order.
+//-----------------------------------------------------------------
+
+void Win::StringIndex::Fill (const std::vector <std::tstring> & strs)
+{
+	_keys.resize (strs.size ()) ;
+	_order.resize (strs.size ()) ;
+
+	for (size_t i = 0 ; i < strs.size () ; ++i)
+	{
+		_keys  [i] = Fold (strs [i]) ;
+		_order [i] = static_cast <int> (i) ;
+	}
+
+	std::sort (_order.begin (), _order.end (), ItemLess (_keys)) ;
+}
+
+//-----------------------------------------------------------------
+// Adds a string mirroring an item inserted in the control.  The
+// items following the inserted one are moved down by one.
+//
+// Parameters:
+//
+// const int item           -> Index of the item in the control, as
+//							   returned by AddString or InsertString.
+// const std::tstring & str -> The string of the item.
+//-----------------------------------------------------------------
+
+void Win::StringIndex::Insert (const int item, const std::tstring & str)
+{
+	std::tstring key = Fold (str) ;
+
+	// Nothing to renumber when the item is added at the end.
+	if (item < GetCount ())
+	{
+		for (std::vector <int>::iterator it = _order.begin () ; it != _order.end () ; ++it)
+		{
+			if (*it >= item)
+				++*it ;
+		}
+	}
+
+	_keys.insert (_keys.begin () + item, key) ;
+	_order.insert (std::lower_bound (_order.begin (), _order.end (), item, ItemLess (_keys)), item) ;
+}
+
+//-----------------------------------------------------------------
+// Removes the string mirroring an item deleted from the control. The
+// items following the deleted one are moved up by one.
+//
+// Parameters:
+//
+// const int item -> Index of the deleted item.
+//-----------------------------------------------------------------
+
+void Win::StringIndex::Delete (const int item)
+{
+	if (item < 0 || item >= GetCount ())
+		return ;
+
+	_order.erase (std::lower_bound (_order.begin (), _order.end (), item, ItemLess (_keys))) ;
+	_keys.erase (_keys.begin () + item) ;
+
+	for (std::vector <int>::iterator it = _order.begin () ; it != _order.end () ; ++it)
+	{
+		if (*it > item)
+			--*it ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Finds an item that begins by the characters contained in a
+// specified string.  Works like LB_FINDSTRING:  the search begins
+// after startIndex and continues from the top of the control.
+//
+// The matching items are sorted by string, then by index.  Each
+// group of equal strings is searched for the first item after
+// startIndex with a binary search.  A short prefix may match many
+// different strings, so the items following startIndex are scanned
+// in turn at the same time, and the search stops as soon as one of
+// the two walks gives the answer.
+//
+// Return value: The index of the item or NotFound.
+//
+// Parameters:
+//
+// const int startIndex        -> The search starts after this item.
+//								  -1 to search from the top.
+// const std::tstring & prefix -> The characters to search for.
+//-----------------------------------------------------------------
+
+int Win::StringIndex::FindString (const int startIndex, const std::tstring & prefix) const
+{
+	std::tstring key = Fold (prefix) ;
+	OrderIter    first ;
+	OrderIter    last ;
+
+	FindRange (key, false, first, last) ;
+
+	if (first == last)
+		return NotFound ;
+
+	int count   = GetCount () ;
+	int start   = startIndex >= 0 && startIndex < count - 1 ? startIndex + 1 : 0 ;
+	int after   = NotFound ;
+	int lowest  = NotFound ;
+	int scanned = 0 ;
+
+	for (OrderIter group = first ; group != last ; )
+	{
+		// One group of equal strings.
+		OrderIter next  = NextGroup (group, last) ;
+		OrderIter found = FindAfter (group, next, startIndex) ;
+
+		if (found != next && (after == NotFound || *found < after))
+			after = *found ;
+
+		if (lowest == NotFound || *group < lowest)
+			lowest = *group ;
+
+		group = next ;
+
+		// One item following startIndex.
+		if (scanned < count)
+		{
+			int item = (start + scanned) % count ;
+
+			if (_keys [item].compare (0, key.length (), key) == 0)
+				return item ;
+
+			++scanned ;
+		}
+	}
+
+	return after != NotFound ? after : lowest ;
+}
+
+//-----------------------------------------------------------------
+// Finds an item that matches exactly a specified string.  Works like
+// LB_FINDSTRINGEXACT.
+//
+// Return value: The index of the item or NotFound.
+//
+// Parameters:
+//
+// const int startIndex     -> The search starts after this item.
+//							   -1 to search from the top.
+// const std::tstring & str -> The string to search for.
+//-----------------------------------------------------------------
+
+int Win::StringIndex::FindStringExact (const int startIndex, const std::tstring & str) const
+{
+	OrderIter first ;
+	OrderIter last ;
+
+	FindRange (Fold (str), true, first, last) ;
+
+	if (first == last)
+		return NotFound ;
+
+	// The matching items are sorted by index.
+	OrderIter found = FindAfter (first, last, startIndex) ;
+	return found != last ? *found : *first ;
+}
+
+//-----------------------------------------------------------------
+// Finds all the items that begin by the characters contained in a
+// specified string.  Useful to filter a list as the user types.
+//
+// Parameters:
+//
+// const std::tstring & prefix -> The characters to search for.
+// std::vector <int> & items   -> Will contain the index of the items
+//								  in ascending order.
+//-----------------------------------------------------------------
+
+void Win::StringIndex::FindAll (const std::tstring & prefix, std::vector <int> & items) const
+{
+	OrderIter first ;
+	OrderIter last ;
+
+	FindRange (Fold (prefix), false, first, last) ;
+
+	items.assign (first, last) ;
+	std::sort (items.begin (), items.end ()) ;
+}
+
+//-----------------------------------------------------------------
+// Converts a string to lower case so that comparisons are case
+// insensitive.
+//
+// Return value:  The converted string.
+//
+// Parameters:
+//
+// const std::tstring & str -> The string to convert.
+//-----------------------------------------------------------------
+
+std::tstring Win::StringIndex::Fold (const std::tstring & str) const
+{
+	if (str.empty ())
+		return str ;
+
+	DWORD flags = LCMAP_LOWERCASE ;
+
+	if (_linguistic)
+		flags |= LCMAP_LINGUISTIC_CASING ;
+
+	std::tstring folded (str.length (), TEXT('\0')) ;
+
+	if (::LCMapString (LOCALE_USER_DEFAULT, flags, str.c_str (), static_cast <int> (str.length ()),
+		&folded [0], static_cast <int> (folded.length ())) == 0)
+	{
+		throw Win::Exception (TEXT("Error, could not convert a string to lower case")) ;
+	}
+
+	return folded ;
+}
+
+//-----------------------------------------------------------------
+// Finds the items matching a case folded string with two binary
+// searches.
+//
+// Parameters:
+//
+// const std::tstring & key -> The case folded string.
+// const bool exact         -> If true the items must match the
+//							   whole string, else they must begin by it.
+// OrderIter & first        -> Will point on the first matching item.
+// OrderIter & last         -> Will point after the last matching item.
+//-----------------------------------------------------------------
+
+void Win::StringIndex::FindRange (const std::tstring & key, const bool exact, OrderIter & first, OrderIter & last) const
+{
+	size_t len = key.length () ;
+
+	// Lower bound:  the first item not smaller than key.
+	size_t low  = 0 ;
+	size_t high = _order.size () ;
+
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2 ;
+
+		if (_keys [_order [mid]].compare (key) < 0)
+			low = mid + 1 ;
+		else
+			high = mid ;
+	}
+
+	first = _order.begin () + low ;
+
+	// Upper bound:  the first item that does not match key.
+	high = _order.size () ;
+
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2 ;
+		int    cmp = exact ? _keys [_order [mid]].compare (key) : _keys [_order [mid]].compare (0, len, key) ;
+
+		if (cmp <= 0)
+			low = mid + 1 ;
+		else
+			high = mid ;
+	}
+
+	last = _order.begin () + low ;
+}
+
+//-----------------------------------------------------------------
+// Finds with a binary search the end of a group of items having
+// the same string.
+//
+// Return value: The first item with a different string, or last.
+//
+// Parameters:
+//
+// OrderIter group -> The first item of the group.
+// OrderIter last  -> The end of the range to search.
+//-----------------------------------------------------------------
+
+Win::StringIndex::OrderIter Win::StringIndex::NextGroup (OrderIter group, OrderIter last) const
+{
+	const std::tstring & key = _keys [*group] ;
+
+	OrderIter low  = group + 1 ;
+	OrderIter high = last ;
+
+	while (low < high)
+	{
+		OrderIter mid = low + (high - low) / 2 ;
+
+		if (_keys [*mid] == key)
+			low = mid + 1 ;
+		else
+			high = mid ;
+	}
+
+	return low ;
+}
+
+//-----------------------------------------------------------------
+// Finds with a binary search the first item after startIndex among
+// items having the same string, hence sorted by index.
+//
+// Return value: The item found, or last.
+//
+// Parameters:
+//
+// OrderIter first      -> The first item of the group.
+// OrderIter last       -> After the last item of the group.
+// const int startIndex -> The search starts after this item.
+//-----------------------------------------------------------------
+
+Win::StringIndex::OrderIter Win::StringIndex::FindAfter (OrderIter first, OrderIter last, const int startIndex)
+{
+	return std::upper_bound (first, last, startIndex) ;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::StringIndex.
+//-----------------------------------------------------------------
+
+#if !defined (WINSTRINGINDEX_H)
+
+	#define WINSTRINGINDEX_H
+	#include "useunicode.h"
+	#include "winunicodehelper.h"
+	#include "winexception.h"
+	#include <windows.h>
+	#include <vector>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// A Win::StringIndex object mirrors the strings of a list box or a
+		// combo box in a sorted array.  It allows to search for a string or
+		// a prefix in logarithmic time instead of making the control scan
+		// all of its items at each keystroke.  The index must be kept in
+		// sync with the control by calling Insert and Delete each time an
+		// item is added to or removed from the control.  Comparisons
+		// are case insensitive, like the ones made by the controls.
+		//
+		// Insert and Delete renumber the following items and take a
+		// linear time, like the matching operations of the controls.
+		//-----------------------------------------------------------------
+
+		class StringIndex
+		{
+		public:
+
+			enum { NotFound = -1 } ;
+
+			//-----------------------------------------------------------------
+			// Constructor.  Creates an empty index.
+			//
+			// Parameters:
+			//
+			// const bool linguistic -> If true, the case of the strings is
+			//							folded with the linguistic rules of the
+			//							user's locale instead of the file system
+			//							rules.
+			//-----------------------------------------------------------------
+
+			StringIndex (const bool linguistic = false)
+				: _linguistic (linguistic)
+			{}
+
+			void Fill (const std::vector <std::tstring> & strs) ;
+			void Insert (const int item, const std::tstring & str) ;
+			void Delete (const int item) ;
+
+			//-----------------------------------------------------------------
+			// Adds a string mirroring an item added at the end of the control.
+			//
+			// Parameters:
+			//
+			// const std::tstring & str -> The string of the item.
+			//-----------------------------------------------------------------
+
+			void Add (const std::tstring & str)
+			{
+				Insert (GetCount (), str) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Removes all the strings from the index.
+			//-----------------------------------------------------------------
+
+			void Clear ()
+			{
+				_keys.clear () ;
+				_order.clear () ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the number of strings in the index.
+			//
+			// Return value:  The number of strings.
+			//-----------------------------------------------------------------
+
+			int GetCount () const
+			{
+				return static_cast <int> (_keys.size ()) ;
+			}
+
+			int FindString (const int startIndex, const std::tstring & prefix) const ;
+			int FindStringExact (const int startIndex, const std::tstring & str) const ;
+			void FindAll (const std::tstring & prefix, std::vector <int> & items) const ;
+
+		private:
+
+			//-----------------------------------------------------------------
+			// Orders the items by case folded string, then by index.
+			//-----------------------------------------------------------------
+
+			class ItemLess
+			{
+			public:
+
+				ItemLess (const std::vector <std::tstring> & keys)
+					: _keys (keys)
+				{}
+
+				bool operator () (const int lhs, const int rhs) const
+				{
+					int cmp = _keys [lhs].compare (_keys [rhs]) ;
+					return cmp < 0 || (cmp == 0 && lhs < rhs) ;
+				}
+
+			private:
+
+				const std::vector <std::tstring> & _keys ;
+			} ;
+
+			typedef std::vector <int>::const_iterator OrderIter ;
+
+			std::tstring Fold (const std::tstring & str) const ;
+			void FindRange (const std::tstring & key, const bool exact, OrderIter & first, OrderIter & last) const ;
+			OrderIter NextGroup (OrderIter group, OrderIter last) const ;
+			static OrderIter FindAfter (OrderIter first, OrderIter last, const int startIndex) ;
+
+			std::vector <std::tstring> _keys ;       // Case folded strings, by item.
+			std::vector <int>          _order ;      // Items sorted by string, then by item.
+			bool                       _linguistic ; // Linguistic case folding.
+		} ;
+	}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Style::Descriptor.
+//-----------------------------------------------------------------
+
+#if !defined (WINSTYLE_H)
+
+	#define WINSTYLE_H
+	#include "useunicode.h"
+	#include <windows.h>
+
+	namespace Win
+	{
+		namespace Style
+		{
+			//-----------------------------------------------------------------
+			// Stops the compilation when Condition is false:  only the true
+			// specialization is defined, so sizeof fails on the other one.
+			//-----------------------------------------------------------------
+
+			template <bool Condition>
+			struct CompileTimeCheck ;
+
+			template <>
+			struct CompileTimeCheck <true>
+			{
+				enum { Value = 1 } ;
+			} ;
+
+			//-----------------------------------------------------------------
+			// A Win::Style::Descriptor type holds the class style, window style
+			// and extended style of a type of window as compile-time
+			// constants.  Styles are added with AddClass, AddWindow and
+			// AddExtended, which name a new descriptor type, so all the
+			// bitmasks are built by the compiler instead of by a series of
+			// Set*Style calls.  A descriptor is then applied at once with the
+			// SetStyles methods of Win::Class and of the creators.
+			//
+			// The combinations of styles Windows does not accept fail to
+			// compile when the descriptor is used.  For example:
+			//
+			// typedef Win::Style::Descriptor <CS_DBLCLKS, WS_OVERLAPPEDWINDOW> Base ;
+			// typedef Base::AddExtended <WS_EX_APPWINDOW>::Type         MainWindow ;
+			//
+			// winClass.SetStyles <MainWindow> () ;
+			// creator.SetStyles <MainWindow> () ;
+			//-----------------------------------------------------------------
+
+			template <DWORD ClassBits = 0, DWORD WindowBits = 0, DWORD ExtendedBits = 0>
+			struct Descriptor
+			{
+				static const DWORD ClassStyle    = ClassBits ;    // CS_ flags.
+				static const DWORD WindowStyle   = WindowBits ;   // WS_ flags.
+				static const DWORD ExtendedStyle = ExtendedBits ; // WS_EX_ flags.
+
+				//-----------------------------------------------------------------
+				// Names the descriptor with more class styles.
+				//-----------------------------------------------------------------
+
+				template <DWORD Bits>
+				struct AddClass
+				{
+					typedef Descriptor <ClassBits | Bits, WindowBits, ExtendedBits> Type ;
+				} ;
+
+				//-----------------------------------------------------------------
+				// Names the descriptor with more window styles.
+				//-----------------------------------------------------------------
+
+				template <DWORD Bits>
+				struct AddWindow
+				{
+					typedef Descriptor <ClassBits, WindowBits | Bits, ExtendedBits> Type ;
+				} ;
+
+				//-----------------------------------------------------------------
+				// Names the descriptor with more extended styles.
+				//-----------------------------------------------------------------
+
+				template <DWORD Bits>
+				struct AddExtended
+				{
+					typedef Descriptor <ClassBits, WindowBits, ExtendedBits | Bits> Type ;
+				} ;
+
+			private:
+
+				// The illegal combinations.  The names appear in the error
+				// messages of the compiler.
+				enum
+				{
+					ChildAndPopup          = sizeof (CompileTimeCheck <!((WindowBits & WS_CHILD) != 0 && (WindowBits & WS_POPUP) != 0)>),
+					MinimizedAndMaximized  = sizeof (CompileTimeCheck <!((WindowBits & WS_MINIMIZE) != 0 && (WindowBits & WS_MAXIMIZE) != 0)>),
+					OwnAndClassDC          = sizeof (CompileTimeCheck <!((ClassBits & CS_OWNDC) != 0 && (ClassBits & CS_CLASSDC) != 0)>),
+					ParentAndPrivateDC     = sizeof (CompileTimeCheck <!((ClassBits & CS_PARENTDC) != 0 && (ClassBits & (CS_OWNDC | CS_CLASSDC)) != 0)>),
+					MDIChildAndPopup       = sizeof (CompileTimeCheck <!((ExtendedBits & WS_EX_MDICHILD) != 0 && (WindowBits & WS_POPUP) != 0)>)
+				#if defined (WS_EX_LAYERED)
+					, LayeredAndPrivateDC  = sizeof (CompileTimeCheck <!((ExtendedBits & WS_EX_LAYERED) != 0 && (ClassBits & (CS_OWNDC | CS_CLASSDC)) != 0)>)
+				#endif
+				} ;
+			} ;
+
+			template <DWORD ClassBits, DWORD WindowBits, DWORD ExtendedBits>
+			const DWORD Descriptor <ClassBits, WindowBits, ExtendedBits>::ClassStyle ;
+
+			template <DWORD ClassBits, DWORD WindowBits, DWORD ExtendedBits>
+			const DWORD Descriptor <ClassBits, WindowBits, ExtendedBits>::WindowStyle ;
+
+			template <DWORD ClassBits, DWORD WindowBits, DWORD ExtendedBits>
+			const DWORD Descriptor <ClassBits, WindowBits, ExtendedBits>::ExtendedStyle ;
+
+			// Descriptors of the common types of window.
+			typedef Descriptor <CS_HREDRAW | CS_VREDRAW, WS_OVERLAPPEDWINDOW>                   OverlappedWindow ;
+			typedef Descriptor <0, WS_POPUP | WS_BORDER, WS_EX_TOOLWINDOW>                         ToolPopup ;
+			typedef Descriptor <0, WS_CHILD | WS_VISIBLE>                                          Child ;
+			typedef Descriptor <0, WS_CHILD | WS_VISIBLE | WS_CLIPSIBLINGS | WS_TABSTOP>           Control ;
+			typedef Descriptor <0, WS_OVERLAPPEDWINDOW | WS_CLIPCHILDREN>                          Frame ;
+			typedef Descriptor <0, WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | WS_OVERLAPPEDWINDOW>  MDIChild ;
+		}
+	}
+
+#endif
\ No newline at end of file
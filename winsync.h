@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------
+//  This file contains classes used to synchronize threads.
+//-----------------------------------------------------------------
+
+#if !defined (WINSYNC_H)
+
+	#define WINSYNC_H
+	#include "useunicode.h"
+	#include <windows.h>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// Win::CriticalSection allows only one thread at a time to use
+		// some data.  Use a Win::Lock to enter it.
+		//-----------------------------------------------------------------
+
+		class CriticalSection
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Constructor.  Initializes the critical section.
+			//-----------------------------------------------------------------
+
+			CriticalSection ()
+			{
+				::InitializeCriticalSection (&_section) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Destructor.  Releases the critical section.
+			//-----------------------------------------------------------------
+
+			~CriticalSection ()
+			{
+				::DeleteCriticalSection (&_section) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Waits until no other thread is in the critical section and 
+			// enters it.
+			//-----------------------------------------------------------------
+
+			void Enter ()
+			{
+				::EnterCriticalSection (&_section) ;
+			}
+
+			//-----------------------------------------------------------------
+			// Leaves the critical section.
+			//-----------------------------------------------------------------
+
+			void Leave ()
+			{
+				::LeaveCriticalSection (&_section) ;
+			}
+
+		private:
+
+			CriticalSection (const Win::CriticalSection & section) ;
+			CriticalSection & operator = (const Win::CriticalSection & section) ;
+
+			CRITICAL_SECTION _section ;
+		} ;
+
+		//-----------------------------------------------------------------
+		// Win::Lock enters a critical section when it is created and
+		// leaves it when it is destroyed, even if an exception is thrown.
+		//-----------------------------------------------------------------
+
+		class Lock
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Constructor.  Enters the critical section.
+			//
+			// Parameters:
+			//
+			// Win::CriticalSection & section -> The critical section.
+			//-----------------------------------------------------------------
+
+			Lock (Win::CriticalSection & section)
+				: _section (section)
+			{
+				_section.Enter () ;
+			}
+
+			//-----------------------------------------------------------------
+			// Destructor.  Leaves the critical section.
+			//-----------------------------------------------------------------
+
+			~Lock ()
+			{
+				_section.Leave () ;
+			}
+
+		private:
+
+			Lock (const Win::Lock & lock) ;
+			Lock & operator = (const Win::Lock & lock) ;
+
+			Win::CriticalSection & _section ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
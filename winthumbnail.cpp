@@ -0,0 +1,256 @@
+#include "winthumbnail.h"
+#include "winexception.h"
+#include <fstream>
+#include <algorithm>
+
+//-----------------------------------------------------------------
+// Prepares a new thumbnail.
+//
+// Parameters:
+//
+// const int srcWidth  -> Width of the image.
+// const int srcHeight -> Height of the image.
+// const int dstWidth  -> Width of the thumbnail.
+// const int dstHeight -> Height of the thumbnail.
+// const bool bottomUp -> True if the rows of the image will be added
+//						  from the bottom, like in a bitmap file.
+//-----------------------------------------------------------------
+
+void Win::Bitmap::ThumbnailBuilder::Begin (const int srcWidth, const int srcHeight, const int dstWidth, const int dstHeight, const bool bottomUp)
+{
+	// Positions are computed on a grid of srcWidth * dstWidth units.
+	if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0 ||
+		srcWidth > 0x7FFFFFFF / dstWidth || srcHeight > 0x7FFFFFFF / dstHeight || dstWidth > 0x7FFFFFFF / 4 / dstHeight)
+	{
+		throw Win::Exception (TEXT("Error, invalid size for a thumbnail")) ;
+	}
+
+	_srcWidth  = srcWidth ;
+	_srcHeight = srcHeight ;
+	_dstWidth  = dstWidth ;
+	_dstHeight = dstHeight ;
+	_srcY      = 0 ;
+	_bottomUp  = bottomUp ;
+
+	_rowSum.assign (dstWidth * 4, 0) ;
+	_acc.assign (dstWidth * 4, 0) ;
+	_dib.assign (sizeof (BITMAPINFOHEADER) + dstWidth * dstHeight * 4, 0) ;
+
+	BITMAPINFOHEADER * header = reinterpret_cast <BITMAPINFOHEADER *> (&_dib [0]) ;
+
+	header->biSize        = sizeof (BITMAPINFOHEADER) ;
+	header->biWidth       = dstWidth ;
+	header->biHeight      = dstHeight ;
+	header->biPlanes      = 1 ;
+	header->biBitCount    = 32 ;
+	header->biCompression = BI_RGB ;
+	header->biSizeImage   = dstWidth * dstHeight * 4 ;
+}
+
+//-----------------------------------------------------------------
+// Adds the next row of the image.
+//
+// Parameters:
+//
+// const DWORD * row -> The 32 bits pixels of the row.
+//-----------------------------------------------------------------
+
+void Win::Bitmap::ThumbnailBuilder::AddRow (const DWORD * row)
+{
+	if (_srcY >= _srcHeight)
+		throw Win::Exception (TEXT("Error, too many rows added to a thumbnail")) ;
+
+	std::fill (_rowSum.begin (), _rowSum.end (), 0) ;
+
+	// Horizontal reduction:  pixel x covers [x * dstWidth, (x + 1) * dstWidth)
+	// and thumbnail pixel j covers [j * srcWidth, (j + 1) * srcWidth).
+	for (int x = 0 ; x < _srcWidth ; ++x)
+	{
+		DWORD pixel = row [x] ;
+		int   begin = x * _dstWidth ;
+		int   end   = begin + _dstWidth ;
+
+		for (int j = begin / _srcWidth ; j < _dstWidth && j * _srcWidth < end ; ++j)
+		{
+			int    low    = j * _srcWidth > begin ? j * _srcWidth : begin ;
+			int    high   = (j + 1) * _srcWidth < end ? (j + 1) * _srcWidth : end ;
+			DWORD  weight = high - low ;
+			DWORD * sum   = &_rowSum [j * 4] ;
+
+			sum [0] += ( pixel        & 0xFF) * weight ;
+			sum [1] += ((pixel >> 8)  & 0xFF) * weight ;
+			sum [2] += ((pixel >> 16) & 0xFF) * weight ;
+			sum [3] += ( pixel >> 24)         * weight ;
+		}
+	}
+
+	// Vertical reduction, same principle.  A thumbnail row is written as
+	// soon as the last image row it covers was added.
+	int begin = _srcY * _dstHeight ;
+	int end   = begin + _dstHeight ;
+
+	for (int i = begin / _srcHeight ; i < _dstHeight && i * _srcHeight < end ; ++i)
+	{
+		int       low    = i * _srcHeight > begin ? i * _srcHeight : begin ;
+		int       high   = (i + 1) * _srcHeight < end ? (i + 1) * _srcHeight : end ;
+		ULONGLONG weight = high - low ;
+
+		for (size_t k = 0 ; k < _acc.size () ; ++k)
+			_acc [k] += _rowSum [k] * weight ;
+
+		if ((i + 1) * _srcHeight <= end)
+			EmitRow (i) ;
+	}
+
+	++_srcY ;
+}
+
+//-----------------------------------------------------------------
+// Reads a bitmap file and reduces it so that it fits a size, keeping
+// its proportions.  Only one row of the file is in memory at a time.
+// Supports uncompressed 24 and 32 bits files.
+//
+// Parameters:
+//
+// const std::tstring & fileName -> The bitmap file.
+// const int maxWidth            -> Maximum width of the thumbnail.
+// const int maxHeight           -> Maximum height of the thumbnail.
+//-----------------------------------------------------------------
+
+void Win::Bitmap::ThumbnailBuilder::LoadFile (const std::tstring & fileName, const int maxWidth, const int maxHeight)
+{
+	#if defined (UNICODE)
+		std::string name (::WideCharToMultiByte (CP_ACP, 0, fileName.c_str (), -1, NULL, 0, NULL, NULL), '\0') ;
+		::WideCharToMultiByte (CP_ACP, 0, fileName.c_str (), -1, &name [0], static_cast <int> (name.length ()), NULL, NULL) ;
+	#else
+		const std::string & name = fileName ;
+	#endif
+
+	std::ifstream reader (name.c_str (), std::ios_base::in | std::ios_base::binary) ;
+
+	if (!reader)
+		throw Win::Exception (TEXT("Could not open the bitmap file")) ;
+
+	BITMAPFILEHEADER fileHeader ;
+	BITMAPINFOHEADER header ;
+
+	reader.read (reinterpret_cast <char *> (&fileHeader), sizeof (fileHeader)) ;
+	reader.read (reinterpret_cast <char *> (&header), sizeof (header)) ;
+
+	if (reader.fail () || fileHeader.bfType != 0x4D42 || header.biSize < sizeof (header) ||
+		header.biCompression != BI_RGB || (header.biBitCount != 24 && header.biBitCount != 32) ||
+		header.biWidth <= 0 || header.biHeight == 0)
+	{
+		throw Win::Exception (TEXT("Error, unsupported bitmap file")) ;
+	}
+
+	int width    = header.biWidth ;
+	int height   = header.biHeight > 0 ? header.biHeight : -header.biHeight ;
+	int stride   = ((width * header.biBitCount + 31) / 32) * 4 ;
+	int dstWidth ;
+	int dstHeight ;
+
+	FitSize (width, height, maxWidth, maxHeight, dstWidth, dstHeight) ;
+	Begin (width, height, dstWidth, dstHeight, header.biHeight > 0) ;
+
+	reader.seekg (fileHeader.bfOffBits) ;
+
+	std::vector <DWORD> row (width + 1) ; // Room for the padding of 24 bits rows.
+	BYTE *              bytes = reinterpret_cast <BYTE *> (&row [0]) ;
+
+	for (int y = 0 ; y < height ; ++y)
+	{
+		reader.read (reinterpret_cast <char *> (bytes), stride) ;
+
+		if (reader.fail ())
+			throw Win::Exception (TEXT("Could not read the bitmap file")) ;
+
+		// Expand 24 bits pixels in place, from the end.
+		if (header.biBitCount == 24)
+		{
+			for (int x = width - 1 ; x >= 0 ; --x)
+				row [x] = bytes [x * 3] | (bytes [x * 3 + 1] << 8) | (bytes [x * 3 + 2] << 16) | 0xFF000000 ;
+		}
+
+		AddRow (&row [0]) ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Creates a DIB section containing the thumbnail.
+//
+// Return value:  A strong handle on the DIB section.
+//-----------------------------------------------------------------
+
+Win::Bitmap::DIBSection::StrongHandle Win::Bitmap::ThumbnailBuilder::CreateDIBSection () const
+{
+	if (!IsComplete ())
+		throw Win::Exception (TEXT("Error, the thumbnail is not complete")) ;
+
+	void *  bits = NULL ;
+	HBITMAP h    = ::CreateDIBSection (NULL, GetPackedDIB (), DIB_RGB_COLORS, &bits, NULL, 0) ;
+
+	if (h == NULL)
+		throw Win::Exception (TEXT("Error, could not create a DIB section")) ;
+
+	::CopyMemory (bits, &_dib [sizeof (BITMAPINFOHEADER)], _dib.size () - sizeof (BITMAPINFOHEADER)) ;
+	return Win::Bitmap::DIBSection::StrongHandle (h, static_cast <BYTE *> (bits)) ;
+}
+
+//-----------------------------------------------------------------
+// Computes the size of a thumbnail that fits in a box and keeps the
+// proportions of the image.  Images are never enlarged.
+//
+// Parameters:
+//
+// const int srcWidth  -> Width of the image.
+// const int srcHeight -> Height of the image.
+// const int maxWidth  -> Width of the box.
+// const int maxHeight -> Height of the box.
+// int & width         -> Will contain the width of the thumbnail.
+// int & height        -> Will contain the height of the thumbnail.
+//-----------------------------------------------------------------
+
+void Win::Bitmap::ThumbnailBuilder::FitSize (const int srcWidth, const int srcHeight, const int maxWidth, const int maxHeight, int & width, int & height)
+{
+	width  = srcWidth ;
+	height = srcHeight ;
+
+	if (width > maxWidth)
+	{
+		width  = maxWidth ;
+		height = static_cast <int> (static_cast <ULONGLONG> (srcHeight) * maxWidth / srcWidth) ;
+	}
+
+	if (height > maxHeight)
+	{
+		height = maxHeight ;
+		width  = static_cast <int> (static_cast <ULONGLONG> (srcWidth) * maxHeight / srcHeight) ;
+	}
+
+	if (width  < 1) width  = 1 ;
+	if (height < 1) height = 1 ;
+}
+
+//-----------------------------------------------------------------
+// Writes a row of the thumbnail in the packed DIB and clears the 
+// accumulators.
+//
+// Parameters:
+//
+// const int row -> The row, counted in the order the rows are added.
+//-----------------------------------------------------------------
+
+void Win::Bitmap::ThumbnailBuilder::EmitRow (const int row)
+{
+	// The DIB is bottom-up.
+	int       dibRow = _bottomUp ? row : _dstHeight - 1 - row ;
+	BYTE *    dest   = &_dib [sizeof (BITMAPINFOHEADER) + dibRow * _dstWidth * 4] ;
+	ULONGLONG area   = static_cast <ULONGLONG> (_srcWidth) * _srcHeight ;
+
+	for (size_t k = 0 ; k < _acc.size () ; ++k)
+	{
+		dest [k] = static_cast <BYTE> ((_acc [k] + area / 2) / area) ;
+		_acc [k] = 0 ;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------
+//  This file contains only one class:  Win::Bitmap::ThumbnailBuilder.
+//-----------------------------------------------------------------
+
+#if !defined (WINTHUMBNAIL_H)
+
+	#define WINTHUMBNAIL_H
+	#include "useunicode.h"
+	#include <windows.h>
+	#include "winunicodehelper.h"
+	#include "windrawingtool.h"
+	#include <vector>
+
+	namespace Win
+	{
+		namespace Bitmap
+		{
+			//-----------------------------------------------------------------
+			// Win::Bitmap::ThumbnailBuilder reduces an image to a smaller size 
+			// while it is read, one row at a time, so the full image never
+			// needs to be in memory.  Each pixel of the thumbnail is the 
+			// average of the area of the image it covers.  The result is a
+			// 32 bits packed DIB, ready for the clipboard or a DIB section.
+			//
+			// Usage:  call Begin, then AddRow for each row of the image, or
+			// use LoadFile to read a bitmap file.
+			//-----------------------------------------------------------------
+
+			class ThumbnailBuilder
+			{
+			public:
+
+				//-----------------------------------------------------------------
+				// Constructor.  Creates an empty thumbnail.
+				//-----------------------------------------------------------------
+
+				ThumbnailBuilder ()
+					: _srcWidth  (0),
+					  _srcHeight (0),
+					  _dstWidth  (0),
+					  _dstHeight (0),
+					  _srcY      (0),
+					  _bottomUp  (false)
+				{}
+
+				void Begin (const int srcWidth, const int srcHeight, const int dstWidth, const int dstHeight, const bool bottomUp = false) ;
+				void AddRow (const DWORD * row) ;
+				void LoadFile (const std::tstring & fileName, const int maxWidth, const int maxHeight) ;
+
+				Win::Bitmap::DIBSection::StrongHandle CreateDIBSection () const ;
+
+				static void FitSize (const int srcWidth, const int srcHeight, const int maxWidth, const int maxHeight, int & width, int & height) ;
+
+				//-----------------------------------------------------------------
+				// Returns true when all the rows of the image were added.
+				//-----------------------------------------------------------------
+
+				bool IsComplete () const
+				{
+					return _srcHeight > 0 && _srcY == _srcHeight ;
+				}
+
+				//-----------------------------------------------------------------
+				// Obtains the thumbnail as a packed DIB:  a BITMAPINFOHEADER
+				// followed by the bottom-up rows.
+				//
+				// Return value:  A pointer on the packed DIB, valid until Begin
+				//				  is called again.
+				//-----------------------------------------------------------------
+
+				const BITMAPINFO * GetPackedDIB () const
+				{
+					return _dib.empty () ? NULL : reinterpret_cast <const BITMAPINFO *> (&_dib [0]) ;
+				}
+
+				//-----------------------------------------------------------------
+				// Obtains the size of the packed DIB in bytes.
+				//-----------------------------------------------------------------
+
+				DWORD GetPackedSize () const
+				{
+					return static_cast <DWORD> (_dib.size ()) ;
+				}
+
+			private:
+
+				void EmitRow (const int row) ;
+
+				int                     _srcWidth ;
+				int                     _srcHeight ;
+				int                     _dstWidth ;
+				int                     _dstHeight ;
+				int                     _srcY ;     // Next row of the image.
+				bool                    _bottomUp ; // Rows are added from the bottom.
+				std::vector <DWORD>     _rowSum ;   // Current row reduced horizontally, 4 channels per pixel.
+				std::vector <ULONGLONG> _acc ;      // Thumbnail row being accumulated.
+				std::vector <BYTE>      _dib ;      // The packed DIB.
+			} ;
+		}
+	}
+
+#endif
\ No newline at end of file
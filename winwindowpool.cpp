@@ -0,0 +1,303 @@
+#include "winwindowpool.h"
+
+//-----------------------------------------------------------------
+// Constructor.  Creates an empty pool.
+//
+// Parameters:
+//
+// const Win::dow::Creator & creator -> Creates the windows.  It should
+//										not have the WS_VISIBLE style.
+// Factory factory                   -> Creates the controller of each
+//										window.
+// const int capacity                -> Maximum number of free windows.
+// const int warmCount               -> Free windows created in advance
+//										by WarmUp.
+//-----------------------------------------------------------------
+
+Win::WindowPool::WindowPool (const Win::dow::Creator & creator, Factory factory, const int capacity, const int warmCount)
+	: _creator   (creator),
+	  _factory   (factory),
+	  _capacity  (capacity < 0 ? 0 : capacity),
+	  _warmCount (warmCount < 0 ? 0 : warmCount),
+	  _free      (0),
+	  _created   (0),
+	  _reused    (0),
+	  _destroyed (0)
+{}
+
+//-----------------------------------------------------------------
+// Destructor.  Destroys the free windows.  The checked out windows
+// belong to their callers.
+//-----------------------------------------------------------------
+
+Win::WindowPool::~WindowPool ()
+{
+	Clear () ;
+}
+
+//-----------------------------------------------------------------
+// Takes a window out of the pool.  The window is hidden:  the caller
+// positions and shows it, then gives it back with Recycle.
+//
+// Return value:  The window.
+//-----------------------------------------------------------------
+
+Win::dow::Handle Win::WindowPool::CheckOut ()
+{
+	int index = NotFound ;
+
+	// The most recently recycled window first.
+	while (_free > 0 && index == NotFound)
+	{
+		for (int i = static_cast <int> (_slots.size ()) - 1 ; i >= 0 ; --i)
+		{
+			if (!_slots [i].checkedOut)
+			{
+				index = i ;
+				break ;
+			}
+		}
+
+		// Destroyed behind our back, for example with its owner.
+		if (!::IsWindow (_slots [index].win))
+		{
+			Erase (index) ;
+			index = NotFound ;
+		}
+	}
+
+	if (index == NotFound)
+		index = Create () ;
+	else
+		++_reused ;
+
+	Slot & slot = _slots [index] ;
+	slot.checkedOut = true ;
+	--_free ;
+
+	slot.ctrl->OnCheckOut () ;
+
+	return slot.win ;
+}
+
+//-----------------------------------------------------------------
+// Gives a checked out window back to the pool.  The window is hidden
+// and its controller reset, or it is destroyed if the pool is full.
+//
+// Parameters:
+//
+// const Win::dow::Handle win -> The window.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::Recycle (const Win::dow::Handle win)
+{
+	int index = Find (win) ;
+
+	if (index == NotFound || !_slots [index].checkedOut)
+		throw Win::Exception (TEXT("Error, the window is not checked out of the pool")) ;
+
+	if (!::IsWindow (win))
+	{
+		Erase (index) ;
+		return ;
+	}
+
+	::ShowWindow (win, SW_HIDE) ;
+
+	if (_free >= _capacity)
+	{
+		Destroy (index) ;
+		return ;
+	}
+
+	Slot & slot = _slots [index] ;
+	slot.checkedOut = false ;
+	++_free ;
+
+	slot.ctrl->OnRecycle () ;
+}
+
+//-----------------------------------------------------------------
+// Removes a checked out window from the pool without destroying it.
+// Call it when the caller destroys the window itself.
+//
+// Parameters:
+//
+// const Win::dow::Handle win -> The window.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::Forget (const Win::dow::Handle win)
+{
+	int index = Find (win) ;
+
+	if (index != NotFound && _slots [index].checkedOut)
+		Erase (index) ;
+}
+
+//-----------------------------------------------------------------
+// Creates one free window if the pool holds less than the warm
+// count.  One window per call keeps the idle time short.
+//
+// Return value:  True if more windows must be created.
+//-----------------------------------------------------------------
+
+bool Win::WindowPool::WarmUp ()
+{
+	int target = _warmCount < _capacity ? _warmCount : _capacity ;
+
+	if (_free >= target)
+		return false ;
+
+	Create () ;
+
+	return _free < target ;
+}
+
+//-----------------------------------------------------------------
+// Destroys all the free windows.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::Clear ()
+{
+	for (int i = static_cast <int> (_slots.size ()) - 1 ; i >= 0 ; --i)
+	{
+		if (!_slots [i].checkedOut)
+		{
+			if (::IsWindow (_slots [i].win))
+				Destroy (i) ;
+			else
+				Erase (i) ;
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// Sets the maximum number of free windows.  The extra free windows
+// are destroyed.
+//
+// Parameters:
+//
+// const int capacity -> The maximum number of free windows.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::SetCapacity (const int capacity)
+{
+	_capacity = capacity < 0 ? 0 : capacity ;
+
+	for (int i = 0 ; i < static_cast <int> (_slots.size ()) && _free > _capacity ; )
+	{
+		if (!_slots [i].checkedOut)
+			Destroy (i) ;
+		else
+			++i ;
+	}
+}
+
+//-----------------------------------------------------------------
+// Obtains the counters of the pool.
+//
+// Return value:  The counters.
+//-----------------------------------------------------------------
+
+Win::WindowPool::Stats Win::WindowPool::GetStats () const
+{
+	Stats stats ;
+	stats.created    = _created ;
+	stats.reused     = _reused ;
+	stats.destroyed  = _destroyed ;
+	stats.free       = _free ;
+	stats.checkedOut = static_cast <int> (_slots.size ()) - _free ;
+
+	return stats ;
+}
+
+//-----------------------------------------------------------------
+// Finds a window of the pool.
+//
+// Return value:  The index of the window in _slots, or NotFound.
+//
+// Parameters:
+//
+// const HWND win -> The window.
+//-----------------------------------------------------------------
+
+int Win::WindowPool::Find (const HWND win) const
+{
+	for (size_t i = 0 ; i < _slots.size () ; ++i)
+	{
+		if (_slots [i].win == win)
+			return static_cast <int> (i) ;
+	}
+
+	return NotFound ;
+}
+
+//-----------------------------------------------------------------
+// Creates a free window.
+//
+// Return value:  The index of the window in _slots.
+//-----------------------------------------------------------------
+
+int Win::WindowPool::Create ()
+{
+	StrongPointer <Win::dow::Controller> ctrl (_factory ()) ;
+	Win::PooledController * pooled = static_cast <Win::PooledController *> (ctrl.Get ()) ;
+
+	// The window takes ownership of the controller, unless its class
+	// does not use Win::Proc.
+	Win::dow::Handle win = _creator.Create (ctrl, TEXT("")) ;
+	bool ownsCtrl        = ctrl.Release () != NULL ;
+
+	if (::IsWindowVisible (win))
+		::ShowWindow (win, SW_HIDE) ;
+
+	Slot slot ;
+	slot.win        = win ;
+	slot.ctrl       = pooled ;
+	slot.ownsCtrl   = ownsCtrl ;
+	slot.checkedOut = false ;
+
+	_slots.push_back (slot) ;
+	++_free ;
+	++_created ;
+
+	return static_cast <int> (_slots.size ()) - 1 ;
+}
+
+//-----------------------------------------------------------------
+// Destroys a window of the pool.  Its controller is deleted by the
+// window procedure, or by Erase.
+//
+// Parameters:
+//
+// const int index -> Index of the window in _slots.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::Destroy (const int index)
+{
+	HWND win = _slots [index].win ;
+
+	Erase (index) ;
+	::DestroyWindow (win) ;
+	++_destroyed ;
+}
+
+//-----------------------------------------------------------------
+// Removes a window from _slots and deletes the controller the pool
+// owns.
+//
+// Parameters:
+//
+// const int index -> Index of the window in _slots.
+//-----------------------------------------------------------------
+
+void Win::WindowPool::Erase (const int index)
+{
+	if (!_slots [index].checkedOut)
+		--_free ;
+
+	if (_slots [index].ownsCtrl)
+		delete _slots [index].ctrl ;
+
+	_slots.erase (_slots.begin () + index) ;
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+//-----------------------------------------------------------------
+//  This file contains two classes:  Win::PooledController and
+//  Win::WindowPool.
+//-----------------------------------------------------------------
+
+#if !defined (WINWINDOWPOOL_H)
+
+	#define WINWINDOWPOOL_H
+	#include "useunicode.h"
+	#include "wincreator.h"
+	#include "wincontroller.h"
+	#include "winmessagepump.h"
+	#include "winexception.h"
+	#include "strongpointer.h"
+	#include <vector>
+
+	namespace Win
+	{
+		//-----------------------------------------------------------------
+		// Controller of a window managed by a Win::WindowPool.  The window
+		// is not destroyed when it is hidden, so the controller must put
+		// itself back in its initial state when it is recycled.
+		//-----------------------------------------------------------------
+
+		class PooledController : public Win::dow::Controller
+		{
+		public:
+
+			//-----------------------------------------------------------------
+			// Called when the window leaves the pool, before it is shown.
+			//-----------------------------------------------------------------
+
+			virtual void OnCheckOut () throw ()
+			{}
+
+			//-----------------------------------------------------------------
+			// Called when the window goes back to the pool, after it is
+			// hidden.  Resets the state of the controller.
+			//-----------------------------------------------------------------
+
+			virtual void OnRecycle () throw ()
+			{}
+		} ;
+
+		//-----------------------------------------------------------------
+		// A Win::WindowPool object keeps hidden windows of one class ready
+		// to be shown, for tooltips, drop-downs and popups that would else
+		// be created and destroyed each time.  CheckOut returns a hidden
+		// window, created only when the pool is empty.  Recycle hides the
+		// window and keeps it for the next CheckOut, unless the pool
+		// already holds its capacity.  Registered with
+		// Win::MessagePump::AddIdleHandler, the pool creates its first
+		// windows while the application is idle.
+		//
+		// Each window is in one of two states:  free (hidden, in the pool)
+		// or checked out (owned by the caller until Recycle or Forget).
+		// The controllers still belong to their window:  the window
+		// procedure deletes them when a window is destroyed.  Windows of
+		// system classes, tooltips for example, never take their
+		// controller, so the pool keeps it and deletes it with the window.
+		//-----------------------------------------------------------------
+
+		class WindowPool : public Win::IdleHandler
+		{
+		public:
+
+			typedef Win::PooledController * (*Factory) () ;
+
+			//-----------------------------------------------------------------
+			// Counters of the pool.
+			//-----------------------------------------------------------------
+
+			struct Stats
+			{
+				int created ;    // Windows created.
+				int reused ;     // Check outs served by a free window.
+				int destroyed ;  // Windows destroyed by the pool.
+				int free ;       // Windows in the pool.
+				int checkedOut ; // Windows owned by callers.
+			} ;
+
+			WindowPool (const Win::dow::Creator & creator, Factory factory, const int capacity = 4, const int warmCount = 1) ;
+			~WindowPool () ;
+
+			Win::dow::Handle CheckOut () ;
+			void Recycle (const Win::dow::Handle win) ;
+			void Forget (const Win::dow::Handle win) ;
+			bool WarmUp () ;
+			void Clear () ;
+
+			void SetCapacity (const int capacity) ;
+
+			//-----------------------------------------------------------------
+			// Sets the number of free windows created in advance by WarmUp.
+			// It is limited by the capacity.
+			//
+			// Parameters:
+			//
+			// const int warmCount -> The number of windows.
+			//-----------------------------------------------------------------
+
+			void SetWarmCount (const int warmCount)
+			{
+				_warmCount = warmCount < 0 ? 0 : warmCount ;
+			}
+
+			//-----------------------------------------------------------------
+			// Obtains the controller of a window of the pool.
+			//
+			// Return value:  The controller, or NULL if the window does not
+			//				  belong to the pool.
+			//
+			// Parameters:
+			//
+			// const Win::dow::Handle win -> The window.
+			//-----------------------------------------------------------------
+
+			Win::PooledController * GetController (const Win::dow::Handle win) const
+			{
+				int index = Find (win) ;
+				return index != NotFound ? _slots [index].ctrl : NULL ;
+			}
+
+			Stats GetStats () const ;
+
+			//-----------------------------------------------------------------
+			// Creates a controller of a given type.  Use &Make <T> as the
+			// factory of the pool.
+			//
+			// Return value:  The new controller.
+			//-----------------------------------------------------------------
+
+			template <class T>
+			static Win::PooledController * Make ()
+			{
+				return new T ;
+			}
+
+			//-----------------------------------------------------------------
+			// Warms the pool up while the message queue is empty.
+			//
+			// Return value:  True if more windows must be created.
+			//-----------------------------------------------------------------
+
+			virtual bool OnIdle ()
+			{
+				return WarmUp () ;
+			}
+
+		private:
+
+			WindowPool (const WindowPool &) ;
+			WindowPool & operator = (const WindowPool &) ;
+
+			enum { NotFound = -1 } ;
+
+			//-----------------------------------------------------------------
+			// A window of the pool.
+			//-----------------------------------------------------------------
+
+			struct Slot
+			{
+				HWND                    win ;
+				Win::PooledController * ctrl ;
+				bool                    ownsCtrl ;   // The window procedure did not take ctrl.
+				bool                    checkedOut ;
+			} ;
+
+			int Find (const HWND win) const ;
+			int Create () ;
+			void Destroy (const int index) ;
+			void Erase (const int index) ;
+
+			Win::dow::Creator   _creator ;
+			Factory             _factory ;
+			int                 _capacity ;  // Maximum number of free windows.
+			int                 _warmCount ; // Free windows created in advance.
+			std::vector <Slot>  _slots ;     // Free and checked out windows.
+			int                 _free ;      // Number of free windows.
+			int                 _created ;
+			int                 _reused ;
+			int                 _destroyed ;
+		} ;
+	}
+
+#endif
\ No newline at end of file
@@ -16,7 +16,7 @@ LRESULT CALLBACK Win::Proc ( HWND hwnd, UINT msg, WPARAM wParam,
 {
 
 	// Obtains a pointer on the controller.of the window.
-	Win::dow::Controller * pCtr = GetLong <Win::dow::Controller *> (hwnd) ;
+	Win::dow::Controller * pCtr = ControllerArena::Find <Win::dow::Controller> (hwnd) ;
 
 	switch (msg)
 	{
@@ -40,6 +40,7 @@ LRESULT CALLBACK Win::Proc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 			// Places the controller back in the window.
 			SetLong <Win::dow::Controller *> (hwnd, pCtr) ;
+			ControllerArena::Register (hwnd, pCtr) ;
 
 			break ;
 
@@ -622,6 +623,8 @@ LRESULT CALLBACK Win::Proc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 	case WM_NCDESTROY:
 		{
+			ControllerArena::Unregister (hwnd) ;
+
 			if (pCtr->OnNonClientDestroy ())
 			{
 				delete pCtr ;
@@ -1016,7 +1019,7 @@ LRESULT CALLBACK Win::FrameProc ( HWND hwnd, UINT msg, WPARAM wParam,
 					   LPARAM lParam )
 {
 	// Obtains a pointer on the controller.of the window.
-	Win::Frame::Controller * pCtr = GetLong <Frame::Controller *> (hwnd) ;
+	Win::Frame::Controller * pCtr = ControllerArena::Find <Frame::Controller> (hwnd) ;
 	HWND                   client = pCtr ? pCtr->_myClient : 0 ;
 
 
@@ -1044,6 +1047,7 @@ LRESULT CALLBACK Win::FrameProc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 			// Places the controller back in the window.
 			SetLong <Frame::Controller *> (hwnd, pCtr) ;
+			ControllerArena::Register (hwnd, pCtr) ;
 
 			break ;
 
@@ -1626,6 +1630,8 @@ LRESULT CALLBACK Win::FrameProc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 	case WM_NCDESTROY:
 		{
+			ControllerArena::Unregister (hwnd) ;
+
 			if (pCtr->OnNonClientDestroy ())
 			{
 				delete pCtr ;
@@ -1844,7 +1850,7 @@ LRESULT CALLBACK Win::MDIChildProc ( HWND hwnd, UINT msg, WPARAM wParam,
 					   LPARAM lParam )
 {
 	// Obtains a pointer on the controller.of the window.
-	Win::MDIChild::Controller * pCtr = Win::GetLong <Win::MDIChild::Controller *> (hwnd) ;
+	Win::MDIChild::Controller * pCtr = ControllerArena::Find <Win::MDIChild::Controller> (hwnd) ;
 
 	switch (msg)
 	{
@@ -1871,6 +1877,7 @@ LRESULT CALLBACK Win::MDIChildProc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 			// Places the controller back in the window.
 			SetLong <Win::MDIChild::Controller *> (hwnd, pCtr) ;
+			ControllerArena::Register (hwnd, pCtr) ;
 
 			break ;
 
@@ -2453,6 +2460,8 @@ LRESULT CALLBACK Win::MDIChildProc ( HWND hwnd, UINT msg, WPARAM wParam,
 
 	case WM_NCDESTROY:
 		{
+			ControllerArena::Unregister (hwnd) ;
+
 			if (pCtr->OnNonClientDestroy ())
 			{
 				delete pCtr ;